@@ -1,5 +1,9 @@
 #include "algorithms/algorithms.hpp"
 #include "algorithms/maximum_subarray.hpp"
+#include "algorithms/matrix.hpp"
+#include "algorithms/matrix_chain.hpp"
+#include "algorithms/matrix_quantized.hpp"
+#include "algorithms/sparse_matrix.hpp"
 #include "timer.hpp"
 #include "util.hpp"
 #include <vector>
@@ -7,6 +11,7 @@
 #include <iostream>
 #include <algorithm>
 #include <chrono>
+#include <cmath>
 
 template <typename C>
 void printC(const C& c) {
@@ -47,6 +52,119 @@ void benchmarkMaxSubarray(size_t n) {
 	std::cout << "  LN: " << std::fixed << timeln << std::endl;
 }
 
+DSA::Matrix<double> randomMatrix(size_t rows, size_t columns) {
+	DSA::Matrix<double> m {rows, columns};
+	for (size_t y = 0; y < rows; ++y) {
+		for (size_t x = 0; x < columns; ++x) {
+			m.get(y, x) = util::randomFraction();
+		}
+	}
+	return m;
+}
+
+/*
+Classical (blocked) product against Strassen-Winograd with different leaf sizes:
+the crossover is the smallest n where recursing one more level pays off */
+void benchmarkStrassen(size_t n) {
+	DSA::Matrix<double> a {randomMatrix(n, n)};
+	DSA::Matrix<double> b {randomMatrix(n, n)};
+	DSA::Matrix<double> c;
+	std::cout << __FUNCTION__ << ": " << n << std::endl;
+	auto classical = Benchmark(true, [&]() {
+		c = DSA::Matrix<double> {n, n};
+		DSA::Detail::multiplyBlocked(n, n, n, a.data(), a.getStride(), b.data(), b.getStride(),
+									c.data(), c.getStride(), 1.0, true);
+	});
+	std::cout << "  classical: " << std::fixed << classical << std::endl;
+	for (size_t leaf = 32; leaf < n; leaf *= 2) {
+		auto time = Benchmark(true, [&]() { c = DSA::strassenProduct(a, b, leaf); });
+		std::cout << "  leaf " << leaf << ": " << std::fixed << time << std::endl;
+	}
+}
+
+/*
+Naive row-by-row transpose against the cache-oblivious kernel and the in-place variants */
+void benchmarkTranspose(size_t rows, size_t columns) {
+	DSA::Matrix<double> a {randomMatrix(rows, columns)};
+	DSA::Matrix<double> t {columns, rows};
+	auto naive = Benchmark(true, [&]() {
+		for (size_t y = 0; y < rows; ++y) {
+			for (size_t x = 0; x < columns; ++x) {
+				t.get(x, y) = a.get(y, x);
+			}
+		}
+	});
+	std::cout << __FUNCTION__ << ": " << rows << "x" << columns << std::endl;
+	std::cout << "  naive: " << std::fixed << naive << std::endl;
+	std::cout << "  blocked: " << std::fixed << Benchmark(true, [&]() { t = DSA::transpose(a); }) << std::endl;
+	std::cout << "  in-place: " << std::fixed << Benchmark(false, [&]() { a.transposeInPlace(); }) << std::endl;
+}
+
+/*
+Left to right expression evaluation against the optimal order of the chain planner */
+void benchmarkChain(const std::vector<size_t>& dimensions) {
+	std::vector<DSA::Matrix<double>> factors;
+	std::vector<DSA::ConstMatrixView<double>> views;
+	for (size_t i = 0; i + 1 < dimensions.size(); ++i) {
+		factors.push_back(randomMatrix(dimensions[i], dimensions[i + 1]));
+	}
+	for (const auto& f : factors) {
+		views.push_back(f.view());
+	}
+	DSA::MatrixChain<double> chain;
+	DSA::Matrix<double> c;
+	auto sequential = Benchmark(false, [&]() {
+		c = factors[0];
+		for (size_t i = 1; i < factors.size(); ++i) {
+			c = c * factors[i];
+		}
+	});
+	std::cout << __FUNCTION__ << ": " << chain.plan(dimensions).toString() << std::endl;
+	std::cout << "  sequential: " << std::fixed << sequential << std::endl;
+	std::cout << "  planned: " << std::fixed << Benchmark(true, [&]() { chain.multiply(views, c); }) << std::endl;
+}
+
+/*
+float product against the int8 product with int32 accumulation */
+void benchmarkQuantized(size_t n) {
+	DSA::Matrix<float> a {randomMatrix(n, n)};
+	DSA::Matrix<float> b {randomMatrix(n, n)};
+	auto qa = DSA::quantizeRows<int8_t>(a);
+	auto qb = DSA::quantizeColumns<int8_t>(b);
+	DSA::Matrix<float> c;
+	DSA::Matrix<int32_t> q;
+	std::cout << __FUNCTION__ << ": " << n << std::endl;
+	std::cout << "  float: " << std::fixed << Benchmark(true, [&]() { c = a * b; }) << std::endl;
+	std::cout << "  int8: " << std::fixed << Benchmark(true, [&]() { q = qa.values * qb.values; }) << std::endl;
+	std::cout << "  quantize + int8 + dequantize: " << std::fixed << Benchmark(true, [&]() { c = DSA::quantizedProduct(a, b); }) << std::endl;
+}
+
+/*
+Synthetic power-law matrix: row i has about max_degree / (i + 1)^0.8 non-zeros,
+so a few rows hold a large share of all non-zeros (like graph adjacency matrices) */
+DSA::CsrMatrix<double> randomPowerLaw(size_t n, size_t max_degree) {
+	DSA::CooMatrix<double> coo {n, n};
+	for (size_t y = 0; y < n; ++y) {
+		size_t degree = std::max<size_t>(1, max_degree / std::pow(y + 1, 0.8));
+		for (size_t i = 0; i < degree; ++i) {
+			coo.insert(y, util::randomRangeMersenne(0, n - 1), util::randomFraction());
+		}
+	}
+	return DSA::CsrMatrix<double> {coo};
+}
+
+void benchmarkSparse(size_t n, size_t max_degree) {
+	DSA::CsrMatrix<double> a {randomPowerLaw(n, max_degree)};
+	std::vector<double> x(n, 1.0);
+	std::vector<double> y;
+	std::cout << __FUNCTION__ << ": " << n << " nnz " << a.nonZeros() << std::endl;
+	for (unsigned threads = 1; threads <= 8; threads *= 2) {
+		auto time = Benchmark(true, [&]() { DSA::sparseMatrixVector(a, x, y, threads); });
+		std::cout << "  SpMV " << threads << " threads: " << std::fixed << time << std::endl;
+	}
+	std::cout << "  SpGEMM A * A: " << std::fixed << Benchmark(false, [&]() { DSA::sparseMatrixProduct(a, a); }) << std::endl;
+}
+
 int main() {
 	srand(time(0));
 
@@ -54,5 +172,23 @@ int main() {
 	benchmarkMaxSubarray(42);
 	benchmarkMaxSubarray(1000);
 	benchmarkMaxSubarray(10000);
+
+	benchmarkStrassen(128);
+	benchmarkStrassen(256);
+	benchmarkStrassen(512);
+	benchmarkStrassen(1024);
+	benchmarkStrassen(1000);
+
+	benchmarkTranspose(4096, 4096);
+	benchmarkTranspose(4000, 3000);
+
+	benchmarkChain({1000, 20, 1000, 20, 1000, 5});
+	benchmarkChain({10, 500, 500, 500, 500, 2});
+
+	benchmarkQuantized(256);
+	benchmarkQuantized(1024);
+
+	benchmarkSparse(100000, 5000);
+	benchmarkSparse(1000000, 20000);
 	return 0;
 }
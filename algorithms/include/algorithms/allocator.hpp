@@ -0,0 +1,266 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <new>
+#include <limits>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+namespace DSA {
+
+	namespace Detail {
+
+	/*
+	Over-allocates with ::operator new and stores the original pointer
+	right in front of the aligned block. alignment is a power of two. */
+	inline void* alignedAllocate(std::size_t bytes, std::size_t alignment) {
+		const std::size_t overhead = alignment + sizeof(void*);
+		if (bytes > std::numeric_limits<std::size_t>::max() - overhead) {
+			throw std::bad_alloc();
+		}
+		void* raw = ::operator new(bytes + overhead);
+		const std::uintptr_t start = reinterpret_cast<std::uintptr_t>(raw) + sizeof(void*);
+		const std::uintptr_t aligned = (start + alignment - 1) & ~static_cast<std::uintptr_t>(alignment - 1);
+		reinterpret_cast<void**>(aligned)[-1] = raw;
+		return reinterpret_cast<void*>(aligned);
+	}
+
+	inline void alignedDeallocate(void* p) noexcept {
+		if (p) {
+			::operator delete(static_cast<void**>(p)[-1]);
+		}
+	}
+
+	template <typename T>
+	T* allocateArray(std::size_t n, std::size_t alignment) {
+		if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(alignedAllocate(n * sizeof(T), alignment));
+	}
+
+	}
+
+/*
+Allocator returning memory aligned to Alignment bytes (default: one cache line),
+so that SIMD loads of the first element of a block never split a cache line */
+template <typename T, std::size_t Alignment = 64>
+class AlignedAllocator {
+public:
+	using value_type = T;
+
+	static constexpr std::size_t alignment = Alignment;
+
+	static_assert(Alignment >= alignof(T) && (Alignment & (Alignment - 1)) == 0,
+		"alignment must be a power of two of at least alignof(T)");
+
+	template <typename U>
+	struct rebind {
+		using other = AlignedAllocator<U, Alignment>;
+	};
+
+public:
+	AlignedAllocator() noexcept {}
+
+	template <typename U>
+	AlignedAllocator(const AlignedAllocator<U, Alignment>&) noexcept {}
+
+	T* allocate(std::size_t n) {
+		return Detail::allocateArray<T>(n, Alignment);
+	}
+
+	void deallocate(T* p, std::size_t) noexcept {
+		Detail::alignedDeallocate(p);
+	}
+};
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator==(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) {
+	return true;
+}
+
+template <typename T, typename U, std::size_t Alignment>
+bool operator!=(const AlignedAllocator<T, Alignment>&, const AlignedAllocator<U, Alignment>&) {
+	return false;
+}
+
+/*
+Bump-pointer memory arena.
+
+Allocating is a pointer increment inside the current block, a new block is only
+requested when the current one is full. Deallocation only reclaims the most recent
+allocation (stack order), everything else is reclaimed at once by reset(),
+which keeps the blocks so the next round of allocations does not reach malloc. */
+class Arena {
+public:
+	using size_type = std::size_t;
+
+public:
+	explicit Arena(size_type block_size = 1 << 20)
+	: block_size(block_size), current(0), offset(0), in_use(0) {}
+
+	Arena(const Arena& other) = delete;
+	Arena& operator=(const Arena& rhs) = delete;
+
+	~Arena() {
+		release();
+	}
+
+	void* allocate(size_type bytes, size_type alignment) {
+		assert(alignment <= blockAlignment());
+		while (current < blocks.size()) {
+			Block& block = blocks[current];
+			const size_type start = alignUp(offset, alignment);
+			if (start <= block.size && bytes <= block.size - start) {
+				offset = start + bytes;
+				in_use += 1;
+				return block.data + start;
+			}
+			++current;
+			offset = 0;
+		}
+		const size_type size = std::max(block_size, bytes);
+		blocks.push_back(Block {static_cast<char*>(Detail::alignedAllocate(size, blockAlignment())), size});
+		current = blocks.size() - 1;
+		offset = bytes;
+		in_use += 1;
+		return blocks.back().data;
+	}
+
+	void deallocate(void* p, size_type bytes) noexcept {
+		assert(in_use > 0);
+		in_use -= 1;
+		if (current < blocks.size() && static_cast<char*>(p) + bytes == blocks[current].data + offset) {
+			offset -= bytes;
+		}
+		if (in_use == 0) {
+			reset();
+		}
+	}
+
+	/*
+	Every allocation is released, the blocks are kept */
+	void reset() noexcept {
+		current = 0;
+		offset = 0;
+		in_use = 0;
+	}
+
+	/*
+	Returns the blocks to the system, no allocation may be alive */
+	void release() noexcept {
+		for (Block& block : blocks) {
+			Detail::alignedDeallocate(block.data);
+		}
+		blocks.clear();
+		reset();
+	}
+
+	/*
+	Bytes owned by the arena */
+	size_type capacity() const {
+		size_type total = 0;
+		for (const Block& block : blocks) {
+			total += block.size;
+		}
+		return total;
+	}
+
+	size_type blockCount() const {
+		return blocks.size();
+	}
+
+	static constexpr size_type blockAlignment() {
+		return 64;
+	}
+
+private:
+	struct Block {
+		char* data;
+		size_type size;
+	};
+
+	static size_type alignUp(size_type n, size_type alignment) {
+		return (n + alignment - 1) & ~(alignment - 1);
+	}
+
+private:
+	size_type block_size;
+	std::vector<Block> blocks;
+	size_type current;
+	size_type offset;
+	size_type in_use;
+};
+
+/*
+Allocator drawing from an Arena, the arena must outlive every container using it.
+Containers sharing an arena compare equal. */
+template <typename T, std::size_t Alignment = 64>
+class ArenaAllocator {
+public:
+	using value_type = T;
+	using propagate_on_container_move_assignment = std::true_type;
+	using propagate_on_container_swap = std::true_type;
+
+	static constexpr std::size_t alignment = Alignment;
+
+	static_assert(Alignment >= alignof(T) && Alignment <= Arena::blockAlignment(),
+		"alignment must be at least alignof(T) and at most the arena's block alignment");
+
+	template <typename U>
+	struct rebind {
+		using other = ArenaAllocator<U, Alignment>;
+	};
+
+	template <typename U, std::size_t A>
+	friend class ArenaAllocator;
+
+public:
+	ArenaAllocator(Arena& arena) noexcept
+	: arena(&arena) {}
+
+	template <typename U>
+	ArenaAllocator(const ArenaAllocator<U, Alignment>& other) noexcept
+	: arena(other.arena) {}
+
+	T* allocate(std::size_t n) {
+		if (n > std::numeric_limits<std::size_t>::max() / sizeof(T)) {
+			throw std::bad_alloc();
+		}
+		return static_cast<T*>(arena->allocate(n * sizeof(T), Alignment));
+	}
+
+	void deallocate(T* p, std::size_t n) noexcept {
+		arena->deallocate(p, n * sizeof(T));
+	}
+
+	bool operator==(const ArenaAllocator& rhs) const {
+		return arena == rhs.arena;
+	}
+
+	bool operator!=(const ArenaAllocator& rhs) const {
+		return arena != rhs.arena;
+	}
+
+private:
+	Arena* arena;
+};
+
+	namespace Detail {
+
+	/*
+	Alignment guaranteed by an allocator: A::alignment when it is declared, alignof(T) otherwise */
+	template <typename A, typename = void>
+	struct AllocatorAlignment
+	: std::integral_constant<std::size_t, alignof(typename A::value_type)> {};
+
+	template <typename A>
+	struct AllocatorAlignment<A, typename std::enable_if<(A::alignment > 0)>::type>
+	: std::integral_constant<std::size_t, A::alignment> {};
+
+	}
+
+}
@@ -0,0 +1,267 @@
+#pragma once
+
+#include "matrix.hpp"
+#include <cstddef>
+#include <cassert>
+#include <array>
+#include <initializer_list>
+#include <algorithm>
+
+namespace DSA {
+
+	namespace Detail {
+
+	/*
+	Prevents deduction of a parameter, it is converted to the type deduced elsewhere */
+	template <typename T>
+	struct Identity {
+		using type = T;
+	};
+
+	/*
+	Calls f(i) for i in [Begin, End).
+	Small ranges are unrolled at compile time, larger ranges are left to the optimizer. */
+	template <std::size_t Begin, std::size_t End, bool Unroll = (End - Begin <= 16)>
+	struct StaticFor {
+		template <typename F>
+		static void apply(F&& f) {
+			f(Begin);
+			StaticFor<Begin + 1, End>::apply(f);
+		}
+	};
+
+	template <std::size_t End>
+	struct StaticFor<End, End, true> {
+		template <typename F>
+		static void apply(F&&) {}
+	};
+
+	template <std::size_t Begin, std::size_t End>
+	struct StaticFor<Begin, End, false> {
+		template <typename F>
+		static void apply(F&& f) {
+			for (std::size_t i = Begin; i < End; ++i) {
+				f(i);
+			}
+		}
+	};
+
+	}
+
+/*
+Matrix with compile-time dimensions and stack storage (row-major), for small
+matrices (geometry: 2x2, 3x3, 4x4) that are multiplied very often.
+
+Operations between fixed matrices are evaluated immediately and return a FixedMatrix,
+mismatching dimensions do not compile. A FixedMatrix is also a matrix expression,
+so it can be used together with the dynamic Matrix and views. */
+template <typename T, std::size_t R, std::size_t C>
+class FixedMatrix : public MatrixExpression<FixedMatrix<T, R, C>> {
+public:
+	using size_type = std::size_t;
+	using value_type = T;
+
+	static constexpr bool is_elementwise = true;
+	static constexpr bool is_alias_safe = true;
+
+	static_assert(R > 0 && C > 0, "empty fixed matrix");
+
+public:
+	FixedMatrix() {
+		elements.fill(T());
+	}
+
+	/*
+	Row-major elements, missing elements are zero */
+	FixedMatrix(std::initializer_list<T> values) {
+		assert(values.size() <= R * C);
+		elements.fill(T());
+		std::copy(values.begin(), values.end(), elements.begin());
+	}
+
+	/*
+	From a dynamic expression, the dimensions are checked at runtime */
+	template <typename E>
+	explicit FixedMatrix(const MatrixExpression<E>& e) {
+		assert(e.derived().getHeight() == R && e.derived().getWidth() == C);
+		Detail::assign(*this, e.derived(), T(1));
+	}
+
+	FixedMatrix(const FixedMatrix& other) = default;
+	FixedMatrix& operator=(const FixedMatrix& rhs) = default;
+
+	template <typename E>
+	FixedMatrix& operator=(const MatrixExpression<E>& e) {
+		const E& expr = e.derived();
+		assert(expr.getHeight() == R && expr.getWidth() == C);
+		if (!E::is_alias_safe && expr.aliases(data(), data() + R * C)) {
+			*this = FixedMatrix(expr);
+		} else {
+			Detail::assign(*this, expr, T(1));
+		}
+		return *this;
+	}
+
+	static FixedMatrix identity() {
+		static_assert(R == C, "identity of a non-square matrix");
+		FixedMatrix m;
+		Detail::StaticFor<0, R>::apply([&](size_type i) {
+			m.get(i, i) = T(1);
+		});
+		return m;
+	}
+
+	T& get(size_type y, size_type x) {
+		return elements[y * C + x];
+	}
+
+	const T& get(size_type y, size_type x) const {
+		return elements[y * C + x];
+	}
+
+	static constexpr size_type getHeight() {
+		return R;
+	}
+
+	static constexpr size_type getWidth() {
+		return C;
+	}
+
+	static constexpr size_type getStride() {
+		return C;
+	}
+
+	static constexpr size_type getColumnStride() {
+		return 1;
+	}
+
+	T* data() {
+		return elements.data();
+	}
+
+	const T* data() const {
+		return elements.data();
+	}
+
+	bool aliases(const void* first, const void* last) const {
+		return Detail::overlaps(data(), data() + R * C, first, last);
+	}
+
+/*
+Element-wise operations, unrolled for small sizes */
+
+	FixedMatrix& operator+=(const FixedMatrix& rhs) {
+		Detail::StaticFor<0, R * C>::apply([&](size_type i) {
+			elements[i] += rhs.elements[i];
+		});
+		return *this;
+	}
+
+	FixedMatrix& operator-=(const FixedMatrix& rhs) {
+		Detail::StaticFor<0, R * C>::apply([&](size_type i) {
+			elements[i] -= rhs.elements[i];
+		});
+		return *this;
+	}
+
+	FixedMatrix& operator*=(const T& scalar) {
+		Detail::StaticFor<0, R * C>::apply([&](size_type i) {
+			elements[i] *= scalar;
+		});
+		return *this;
+	}
+
+	FixedMatrix operator*(const T& scalar) const {
+		FixedMatrix m(*this);
+		return m *= scalar;
+	}
+
+	FixedMatrix<T, C, R> transposed() const {
+		FixedMatrix<T, C, R> t;
+		Detail::StaticFor<0, R>::apply([&](size_type y) {
+			Detail::StaticFor<0, C>::apply([&](size_type x) {
+				t.get(x, y) = get(y, x);
+			});
+		});
+		return t;
+	}
+
+	bool operator==(const FixedMatrix& rhs) const {
+		return elements == rhs.elements;
+	}
+
+	bool operator!=(const FixedMatrix& rhs) const {
+		return !(*this == rhs);
+	}
+
+private:
+	std::array<T, R * C> elements;
+};
+
+	namespace Detail {
+
+	template <typename T, std::size_t R, std::size_t C>
+	struct ExpressionOperand<FixedMatrix<T, R, C>> {
+		using type = const FixedMatrix<T, R, C>&;
+	};
+
+	template <typename T, std::size_t R, std::size_t C>
+	struct IsDense<FixedMatrix<T, R, C>> : std::true_type {};
+
+	}
+
+template <typename T, std::size_t R, std::size_t C>
+FixedMatrix<T, R, C> operator+(FixedMatrix<T, R, C> a, const FixedMatrix<T, R, C>& b) {
+	return a += b;
+}
+
+template <typename T, std::size_t R, std::size_t C>
+FixedMatrix<T, R, C> operator-(FixedMatrix<T, R, C> a, const FixedMatrix<T, R, C>& b) {
+	return a -= b;
+}
+
+template <typename T, std::size_t R, std::size_t C>
+FixedMatrix<T, R, C> operator*(const typename Detail::Identity<T>::type& scalar,
+								const FixedMatrix<T, R, C>& m) {
+	return m * scalar;
+}
+
+/*
+O(R * K * C), fully unrolled up to 16 iterations per loop.
+The i-k-j order keeps the inner loop on rows of b so it can be vectorised. */
+template <typename T, std::size_t R, std::size_t K, std::size_t C>
+FixedMatrix<T, R, C> operator*(const FixedMatrix<T, R, K>& a, const FixedMatrix<T, K, C>& b) {
+	FixedMatrix<T, R, C> c;
+	Detail::StaticFor<0, R>::apply([&](std::size_t y) {
+		Detail::StaticFor<0, K>::apply([&](std::size_t k) {
+			const T factor = a.get(y, k);
+			Detail::StaticFor<0, C>::apply([&](std::size_t x) {
+				c.get(y, x) += factor * b.get(k, x);
+			});
+		});
+	});
+	return c;
+}
+
+/*
+Mismatching dimensions of two fixed matrices are a compile-time error,
+instead of falling back to the runtime checked expression operators */
+template <typename T, std::size_t R, std::size_t K, std::size_t K2, std::size_t C>
+FixedMatrix<T, R, C> operator*(const FixedMatrix<T, R, K>& a, const FixedMatrix<T, K2, C>& b) {
+	static_assert(K == K2, "matrix product: width of the left operand differs from height of the right operand");
+	return {};
+}
+
+template <typename T, std::size_t R, std::size_t C, std::size_t R2, std::size_t C2>
+FixedMatrix<T, R, C> operator+(const FixedMatrix<T, R, C>& a, const FixedMatrix<T, R2, C2>& b) {
+	static_assert(R == R2 && C == C2, "matrix sum: dimensions differ");
+	return {};
+}
+
+template <typename T, std::size_t R, std::size_t C, std::size_t R2, std::size_t C2>
+FixedMatrix<T, R, C> operator-(const FixedMatrix<T, R, C>& a, const FixedMatrix<T, R2, C2>& b) {
+	static_assert(R == R2 && C == C2, "matrix difference: dimensions differ");
+	return {};
+}
+
+}
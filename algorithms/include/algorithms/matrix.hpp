@@ -1,35 +1,115 @@
 #pragma once
 
+#include "allocator.hpp"
+#include "matrix_expression.hpp"
+#include "matrix_multiply.hpp"
+#include "matrix_transpose.hpp"
+#include "matrix_view.hpp"
 #include <cinttypes>
 #include <vector>
 #include <cassert>
 #include <iostream>
+#include <sstream>
+#include <string>
+#include <algorithm>
 
 namespace DSA {
 
-template <typename T>
-class Matrix {
+	namespace Detail {
+
+	/*
+	Row stride (leading dimension) of a matrix whose storage is aligned to `alignment` bytes.
+	Rows of at least one cache line are padded so that every row starts on an aligned address,
+	a stride that is a multiple of 4096 bytes gets one more line: otherwise the elements of
+	a column all map to the same cache set. */
+	template <typename T>
+	std::size_t paddedStride(std::size_t width, std::size_t alignment) {
+		if (alignment <= alignof(T) || alignment % sizeof(T) != 0 || width * sizeof(T) < alignment) {
+			return width;
+		}
+		const std::size_t line = alignment / sizeof(T);
+		std::size_t stride = (width + line - 1) / line * line;
+		if (stride * sizeof(T) % 4096 == 0) {
+			stride += line;
+		}
+		return stride;
+	}
+
+	}
+
+/*
+Dense row-major matrix.
+Element (y, x) is stored at data()[y * getStride() + x]: with the default (64-byte aligned)
+allocator rows are padded, use getStride() and not getWidth() to walk the storage. */
+template <typename T, typename Allocator>
+class Matrix : public MatrixExpression<Matrix<T, Allocator>> {
 public:
 	using size_type = std::size_t;
 	using value_type = T;
+	using allocator_type = Allocator;
+
+	static constexpr bool is_elementwise = true;
+	static constexpr bool is_alias_safe = true;
 public:
-	Matrix(size_type rows, size_type columns)
-	: height(rows), width(columns), map(rows * columns) {}
+	Matrix()
+	: height(0), width(0), stride(0) {}
+
+	explicit Matrix(const Allocator& alloc)
+	: height(0), width(0), stride(0), map(alloc) {}
+
+	Matrix(size_type rows, size_type columns, const Allocator& alloc = Allocator())
+	: height(rows), width(columns), stride(computeStride(columns)),
+	map(rows * stride, T(), alloc) {}
+
+	Matrix(const Matrix& other) = default;
+	Matrix(Matrix&& other) = default;
+
+	/*
+	Evaluates the expression directly into the new matrix */
+	template <typename E>
+	Matrix(const MatrixExpression<E>& e, const Allocator& alloc = Allocator())
+	: Matrix(e.derived().getHeight(), e.derived().getWidth(), alloc) {
+		Detail::assign(*this, e.derived(), T(1));
+	}
+
 	~Matrix() {}
 
+	Matrix& operator=(const Matrix& rhs) = default;
+	Matrix& operator=(Matrix&& rhs) = default;
+
+	/*
+	If the expression reads this matrix and cannot be evaluated in place
+	(products, transposition) it is evaluated into a temporary first */
+	template <typename E>
+	Matrix& operator=(const MatrixExpression<E>& e) {
+		const E& expr = e.derived();
+		if (!E::is_alias_safe && expr.aliases(storageBegin(), storageEnd())) {
+			Matrix tmp {e, map.get_allocator()};
+			swap(tmp);
+			return *this;
+		}
+		resize(expr.getHeight(), expr.getWidth());
+		Detail::assign(*this, expr, T(1));
+		return *this;
+	}
+
 	/*
-	O(n^3) */
-	Matrix operator*(const Matrix& b) const {
-		assert(width == b.height && height == b.width);
-		Matrix c {height, b.width};
-		for (size_type y = 0; y < height; ++y) {
-			for (size_type x = 0; x < b.width; ++x) {
-				for (size_type k = 0; k < width; ++k) {
-					c.get(y, x) += (get(y, k) * b.get(k, x));
-				}
-			}
+	`C += A * B` accumulates the product into C without a temporary */
+	template <typename E>
+	Matrix& operator+=(const MatrixExpression<E>& e) {
+		return accumulate(e.derived(), T(1));
+	}
+
+	template <typename E>
+	Matrix& operator-=(const MatrixExpression<E>& e) {
+		return accumulate(e.derived(), T(-1));
+	}
+
+	Matrix& operator*=(const T& scalar) {
+		for (auto& x : map) {
+			x *= scalar;
 		}
-		return c;
+		return *this;
 	}
 
 	T& get(size_type y, size_type x) {
@@ -48,28 +128,171 @@ public:
 		return height;
 	}
 
-	template <typename U>
-	friend std::ostream& operator<<(std::ostream& out, const Matrix<U>& m);
+	/*
+	Distance in elements between the starts of two consecutive rows */
+	size_type getStride() const {
+		return stride;
+	}
+
+	size_type getColumnStride() const {
+		return 1;
+	}
+
+	T* data() {
+		return map.data();
+	}
+
+	const T* data() const {
+		return map.data();
+	}
+
+/*
+Views: O(1), no element is copied */
+
+	MatrixView<T> view() {
+		return MatrixView<T>(data(), height, width, getStride(), getColumnStride());
+	}
+
+	ConstMatrixView<T> view() const {
+		return ConstMatrixView<T>(data(), height, width, getStride(), getColumnStride());
+	}
+
+	MatrixView<T> submatrix(size_type y, size_type x, size_type rows, size_type columns) {
+		return view().submatrix(y, x, rows, columns);
+	}
+
+	ConstMatrixView<T> submatrix(size_type y, size_type x, size_type rows, size_type columns) const {
+		return view().submatrix(y, x, rows, columns);
+	}
+
+	MatrixView<T> row(size_type y) {
+		return view().row(y);
+	}
+
+	ConstMatrixView<T> row(size_type y) const {
+		return view().row(y);
+	}
+
+	MatrixView<T> column(size_type x) {
+		return view().column(x);
+	}
+
+	ConstMatrixView<T> column(size_type x) const {
+		return view().column(x);
+	}
+
+	/*
+	Existing elements are not preserved */
+	void resize(size_type rows, size_type columns) {
+		if (rows == height && columns == width) {
+			return;
+		}
+		height = rows;
+		width = columns;
+		stride = computeStride(columns);
+		map.assign(rows * stride, T());
+	}
+
+	/*
+	Square matrices swap blocks across the diagonal, other shapes are permuted
+	by cycle-following. No extra matrix is allocated, padded rows are compacted
+	before and spread out again after the permutation. */
+	void transposeInPlace() {
+		if (height == width) {
+			Detail::transposeSquareInPlace(data(), stride, height);
+			return;
+		}
+		for (size_type y = 1; y < height; ++y) {
+			std::move(map.begin() + y * stride, map.begin() + y * stride + width, map.begin() + y * width);
+		}
+		Detail::transposeCycles(data(), height, width);
+		std::swap(height, width);
+		stride = computeStride(width);
+		if (map.size() < height * stride) {
+			map.resize(height * stride);
+		}
+		for (size_type y = height; y-- > 1;) {
+			std::move_backward(map.begin() + y * width, map.begin() + (y + 1) * width,
+								map.begin() + y * stride + width);
+		}
+	}
+
+	void fill(const T& value) {
+		std::fill(map.begin(), map.end(), value);
+	}
+
+	void swap(Matrix& other) noexcept {
+		std::swap(height, other.height);
+		std::swap(width, other.width);
+		std::swap(stride, other.stride);
+		map.swap(other.map);
+	}
+
+	Allocator get_allocator() const {
+		return map.get_allocator();
+	}
+
+	bool aliases(const void* first, const void* last) const {
+		return Detail::overlaps(storageBegin(), storageEnd(), first, last);
+	}
 
 private:
 	size_type computeIndex(size_type y, size_type x) const {
-		return y * width + x;
+		return y * stride + x;
+	}
+
+	static size_type computeStride(size_type columns) {
+		return Detail::paddedStride<T>(columns, Detail::AllocatorAlignment<Allocator>::value);
+	}
+
+	const T* storageBegin() const {
+		return map.data();
+	}
+
+	const T* storageEnd() const {
+		return map.data() + map.size();
+	}
+
+	template <typename E>
+	Matrix& accumulate(const E& expr, const T& s) {
+		assert(expr.getHeight() == height && expr.getWidth() == width);
+		if (!E::is_alias_safe && expr.aliases(storageBegin(), storageEnd())) {
+			Matrix tmp {expr, map.get_allocator()};
+			Detail::accumulate(*this, tmp, s);
+		} else {
+			Detail::accumulate(*this, expr, s);
+		}
+		return *this;
 	}
 
 private:
 	size_type height;
 	size_type width;
-	std::vector<T> map;
+	size_type stride;
+	std::vector<T, Allocator> map;
 };
 
-template <typename T>
-std::ostream& operator<<(std::ostream& out, const DSA::Matrix<T>& m) {
-	for (std::size_t y = 0; y < m.height; ++y) {
-		for (std::size_t x = 0; x < m.width; ++x) {
-			out << m.get(y, x) << ' ';
+/*
+Text output, one row per line.
+Rows are formatted into a buffer (with the stream's formatting flags) that is
+written in chunks: the stream is never flushed, large matrices are not held in memory. */
+template <typename E>
+std::ostream& operator<<(std::ostream& out, const MatrixExpression<E>& e) {
+	const E& m = e.derived();
+	const std::streamoff chunk = 1 << 16;
+	std::ostringstream buffer;
+	buffer.copyfmt(out);
+	for (std::size_t y = 0; y < m.getHeight(); ++y) {
+		for (std::size_t x = 0; x < m.getWidth(); ++x) {
+			buffer << m.get(y, x) << ' ';
+		}
+		buffer << '\n';
+		if (buffer.tellp() >= chunk) {
+			out << buffer.str();
+			buffer.str(std::string());
 		}
-		out << std::endl;
 	}
+	out << buffer.str();
 	return out;
 }
 
@@ -0,0 +1,203 @@
+#pragma once
+
+#include "matrix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include <map>
+#include <limits>
+#include <string>
+
+namespace DSA {
+
+/*
+Optimal evaluation order of a chain product A0 * A1 * ... * An-1,
+where Ai has dimensions[i] rows and dimensions[i + 1] columns.
+
+The parenthesization minimizing the number of scalar multiplications is found with
+dynamic programming over all sub-chains: O(n^3) time, O(n^2) space. */
+class MatrixChainPlan {
+public:
+	using size_type = std::size_t;
+	using cost_type = std::uint64_t;
+
+public:
+	MatrixChainPlan()
+	: count(0), total(0) {}
+
+	explicit MatrixChainPlan(const std::vector<size_type>& dimensions)
+	: count(dimensions.size() - 1), total(0), splits(count * count, 0) {
+		assert(dimensions.size() >= 2);
+		std::vector<cost_type> cost(count * count, 0);
+		for (size_type length = 2; length <= count; ++length) {
+			for (size_type i = 0; i + length <= count; ++i) {
+				const size_type j = i + length - 1;
+				cost_type best = std::numeric_limits<cost_type>::max();
+				for (size_type k = i; k < j; ++k) {
+					const cost_type c = cost[i * count + k] + cost[(k + 1) * count + j]
+						+ static_cast<cost_type>(dimensions[i]) * dimensions[k + 1] * dimensions[j + 1];
+					if (c < best) {
+						best = c;
+						splits[i * count + j] = k;
+					}
+				}
+				cost[i * count + j] = best;
+			}
+		}
+		total = cost[count - 1];
+	}
+
+	/*
+	Number of matrices in the chain */
+	size_type size() const {
+		return count;
+	}
+
+	/*
+	The sub-chain [first, last] is evaluated as [first, split] * [split + 1, last] */
+	size_type split(size_type first, size_type last) const {
+		assert(first < last && last < count);
+		return splits[first * count + last];
+	}
+
+	/*
+	Scalar multiplications of the optimal order */
+	cost_type cost() const {
+		return total;
+	}
+
+	/*
+	Left to right evaluation, as `A0 * A1 * ... * An-1` is evaluated by the expression operators */
+	static cost_type sequentialCost(const std::vector<size_type>& dimensions) {
+		cost_type c = 0;
+		for (size_type i = 2; i < dimensions.size(); ++i) {
+			c += static_cast<cost_type>(dimensions[0]) * dimensions[i - 1] * dimensions[i];
+		}
+		return c;
+	}
+
+	/*
+	e.g. "((A0(A1A2))A3)" */
+	std::string toString() const {
+		return count == 0 ? std::string() : toString(0, count - 1);
+	}
+
+private:
+	std::string toString(size_type first, size_type last) const {
+		if (first == last) {
+			return "A" + std::to_string(first);
+		}
+		const size_type k = split(first, last);
+		return "(" + toString(first, k) + toString(k + 1, last) + ")";
+	}
+
+private:
+	size_type count;
+	cost_type total;
+	std::vector<size_type> splits;
+};
+
+/*
+Evaluates chain products in their optimal order.
+
+Plans are cached per dimension sequence, so repeated products of the same shapes
+only pay for the dynamic programming once. Intermediate products are written to
+buffers owned by the MatrixChain: their storage is kept between calls. */
+template <typename T>
+class MatrixChain {
+public:
+	using size_type = std::size_t;
+	using value_type = T;
+
+public:
+	/*
+	Computed on the first use of the dimension sequence, O(1) afterwards (O(log p) for p cached plans) */
+	const MatrixChainPlan& plan(const std::vector<size_type>& dimensions) {
+		auto it = plans.find(dimensions);
+		if (it == plans.end()) {
+			it = plans.emplace(dimensions, MatrixChainPlan(dimensions)).first;
+		}
+		return it->second;
+	}
+
+	/*
+	result = factors[0] * factors[1] * ... * factors[n - 1]
+	result must not be one of the factors */
+	void multiply(const std::vector<ConstMatrixView<T>>& factors, Matrix<T>& result) {
+		assert(!factors.empty());
+		std::vector<size_type> dimensions;
+		dimensions.reserve(factors.size() + 1);
+		dimensions.push_back(factors.front().getHeight());
+		for (const auto& f : factors) {
+			assert(f.getHeight() == dimensions.back());
+			dimensions.push_back(f.getWidth());
+		}
+		const MatrixChainPlan& p = plan(dimensions);
+		if (buffers.size() < 2 * factors.size()) {
+			buffers.resize(2 * factors.size());
+		}
+		evaluate(p, factors, 0, factors.size() - 1, result, 0);
+	}
+
+	Matrix<T> multiply(const std::vector<ConstMatrixView<T>>& factors) {
+		Matrix<T> result;
+		multiply(factors, result);
+		return result;
+	}
+
+	size_type cachedPlans() const {
+		return plans.size();
+	}
+
+	/*
+	Releases the plans and the intermediate buffers */
+	void clear() {
+		plans.clear();
+		buffers.clear();
+	}
+
+private:
+	/*
+	The children of a node at depth d are written to buffers 2d and 2d + 1:
+	the left result stays valid while the right sub-chain is evaluated in deeper buffers. */
+	void evaluate(const MatrixChainPlan& p, const std::vector<ConstMatrixView<T>>& factors,
+				size_type first, size_type last, Matrix<T>& dest, size_type depth) {
+		if (first == last) {
+			dest = factors[first];
+			return;
+		}
+		const size_type k = p.split(first, last);
+		if (first == k && k + 1 == last) {
+			dest = factors[first] * factors[last];
+		} else if (first == k) {
+			Matrix<T>& right = buffers[2 * depth + 1];
+			evaluate(p, factors, k + 1, last, right, depth + 1);
+			dest = factors[first] * right;
+		} else if (k + 1 == last) {
+			Matrix<T>& left = buffers[2 * depth];
+			evaluate(p, factors, first, k, left, depth + 1);
+			dest = left * factors[last];
+		} else {
+			Matrix<T>& left = buffers[2 * depth];
+			Matrix<T>& right = buffers[2 * depth + 1];
+			evaluate(p, factors, first, k, left, depth + 1);
+			evaluate(p, factors, k + 1, last, right, depth + 1);
+			dest = left * right;
+		}
+	}
+
+private:
+	std::map<std::vector<size_type>, MatrixChainPlan> plans;
+	std::vector<Matrix<T>> buffers;
+};
+
+/*
+One-off chain product in the optimal order: chainProduct(a, b, c, d) */
+template <typename T, typename... Rest>
+Matrix<T> chainProduct(const Matrix<T>& first, const Rest&... rest) {
+	MatrixChain<T> chain;
+	return chain.multiply({first.view(), rest.view()...});
+}
+
+}
@@ -0,0 +1,584 @@
+#pragma once
+
+#include "allocator.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <functional>
+#include <type_traits>
+
+namespace DSA {
+
+template <typename T, typename Allocator = AlignedAllocator<T>>
+class Matrix;
+
+/*
+Base class of every matrix expression (CRTP).
+
+Expressions are not evaluated when they are built: `A * B + C * 2 - E` only creates a
+tree of lightweight nodes. The tree is evaluated when it is assigned to a Matrix, directly
+into the destination's storage.
+
+Every derived class provides:
+	value_type
+	is_elementwise: get(y, x) is O(1), the tree contains no product node
+	is_alias_safe: dest(y, x) may be written as soon as get(y, x) is read
+	getHeight(), getWidth(), get(y, x)
+	aliases(first, last): the expression reads memory inside [first, last) */
+template <typename Derived>
+class MatrixExpression {
+public:
+	const Derived& derived() const {
+		return static_cast<const Derived&>(*this);
+	}
+
+protected:
+	MatrixExpression() {}
+	~MatrixExpression() {}
+};
+
+	namespace Detail {
+
+	/*
+	Leaf matrices are held by reference, intermediate nodes are small and held by value
+	so that a node never outlives the temporaries it is built from */
+	template <typename E>
+	struct ExpressionOperand {
+		using type = const E;
+	};
+
+	template <typename T, typename A>
+	struct ExpressionOperand<Matrix<T, A>> {
+		using type = const Matrix<T, A>&;
+	};
+
+	/*
+	Element type of a product: small integers are widened, so that the sums
+	of their products do not overflow */
+	template <typename T>
+	struct ProductValue {
+		using type = T;
+	};
+
+	template <>
+	struct ProductValue<std::int8_t> {
+		using type = std::int32_t;
+	};
+
+	template <>
+	struct ProductValue<std::uint8_t> {
+		using type = std::int32_t;
+	};
+
+	template <>
+	struct ProductValue<std::int16_t> {
+		using type = std::int32_t;
+	};
+
+	inline bool overlaps(const void* first, const void* last,
+						const void* other_first, const void* other_last) {
+		std::less<const void*> less;
+		return less(first, other_last) && less(other_first, last);
+	}
+
+	}
+
+/*
+Element-wise binary operation: sum, difference, element-wise product, ... */
+template <typename L, typename R, typename Op>
+class BinaryExpression : public MatrixExpression<BinaryExpression<L, R, Op>> {
+public:
+	using size_type = std::size_t;
+	using value_type = typename L::value_type;
+	using left_type = L;
+	using right_type = R;
+	using operation_type = Op;
+
+	static constexpr bool is_elementwise = L::is_elementwise && R::is_elementwise;
+	static constexpr bool is_alias_safe = L::is_alias_safe && R::is_alias_safe;
+
+public:
+	BinaryExpression(const L& lhs, const R& rhs, const Op& op = Op())
+	: lhs(lhs), rhs(rhs), op(op) {
+		assert(lhs.getHeight() == rhs.getHeight() && lhs.getWidth() == rhs.getWidth());
+	}
+
+	size_type getHeight() const {
+		return lhs.getHeight();
+	}
+
+	size_type getWidth() const {
+		return lhs.getWidth();
+	}
+
+	value_type get(size_type y, size_type x) const {
+		return op(lhs.get(y, x), rhs.get(y, x));
+	}
+
+	bool aliases(const void* first, const void* last) const {
+		return lhs.aliases(first, last) || rhs.aliases(first, last);
+	}
+
+	const L& left() const {
+		return lhs;
+	}
+
+	const R& right() const {
+		return rhs;
+	}
+
+private:
+	typename Detail::ExpressionOperand<L>::type lhs;
+	typename Detail::ExpressionOperand<R>::type rhs;
+	Op op;
+};
+
+/*
+Multiplication of every element by a scalar */
+template <typename E>
+class ScaledExpression : public MatrixExpression<ScaledExpression<E>> {
+public:
+	using size_type = std::size_t;
+	using value_type = typename E::value_type;
+	using expression_type = E;
+
+	static constexpr bool is_elementwise = E::is_elementwise;
+	static constexpr bool is_alias_safe = E::is_alias_safe;
+
+public:
+	ScaledExpression(const E& e, const value_type& scalar)
+	: e(e), scalar(scalar) {}
+
+	size_type getHeight() const {
+		return e.getHeight();
+	}
+
+	size_type getWidth() const {
+		return e.getWidth();
+	}
+
+	value_type get(size_type y, size_type x) const {
+		return scalar * e.get(y, x);
+	}
+
+	bool aliases(const void* first, const void* last) const {
+		return e.aliases(first, last);
+	}
+
+	const E& expression() const {
+		return e;
+	}
+
+	const value_type& scale() const {
+		return scalar;
+	}
+
+private:
+	typename Detail::ExpressionOperand<E>::type e;
+	value_type scalar;
+};
+
+/*
+Transposition: element (y, x) is element (x, y) of the operand.
+Not alias safe: `A = transpose(A)` overwrites elements that are still to be read. */
+template <typename E>
+class TransposeExpression : public MatrixExpression<TransposeExpression<E>> {
+public:
+	using size_type = std::size_t;
+	using value_type = typename E::value_type;
+	using expression_type = E;
+
+	static constexpr bool is_elementwise = E::is_elementwise;
+	static constexpr bool is_alias_safe = false;
+
+public:
+	explicit TransposeExpression(const E& e)
+	: e(e) {}
+
+	size_type getHeight() const {
+		return e.getWidth();
+	}
+
+	size_type getWidth() const {
+		return e.getHeight();
+	}
+
+	value_type get(size_type y, size_type x) const {
+		return e.get(x, y);
+	}
+
+	bool aliases(const void* first, const void* last) const {
+		return e.aliases(first, last);
+	}
+
+	const E& expression() const {
+		return e;
+	}
+
+private:
+	typename Detail::ExpressionOperand<E>::type e;
+};
+
+/*
+Matrix product (GEMM node).
+get(y, x) is a dot product of O(k), assigning the node to a matrix
+uses a cache friendly kernel that accumulates directly into the destination.
+The product of int8 or int16 matrices has int32 elements. */
+template <typename L, typename R>
+class ProductExpression : public MatrixExpression<ProductExpression<L, R>> {
+public:
+	using size_type = std::size_t;
+	using value_type = typename Detail::ProductValue<typename L::value_type>::type;
+	using left_type = L;
+	using right_type = R;
+
+	static constexpr bool is_elementwise = false;
+	static constexpr bool is_alias_safe = false;
+
+public:
+	ProductExpression(const L& lhs, const R& rhs)
+	: lhs(lhs), rhs(rhs) {
+		assert(lhs.getWidth() == rhs.getHeight());
+	}
+
+	size_type getHeight() const {
+		return lhs.getHeight();
+	}
+
+	size_type getWidth() const {
+		return rhs.getWidth();
+	}
+
+	value_type get(size_type y, size_type x) const {
+		value_type sum = value_type();
+		for (size_type k = 0; k < lhs.getWidth(); ++k) {
+			sum += lhs.get(y, k) * rhs.get(k, x);
+		}
+		return sum;
+	}
+
+	bool aliases(const void* first, const void* last) const {
+		return lhs.aliases(first, last) || rhs.aliases(first, last);
+	}
+
+	const L& left() const {
+		return lhs;
+	}
+
+	const R& right() const {
+		return rhs;
+	}
+
+private:
+	typename Detail::ExpressionOperand<L>::type lhs;
+	typename Detail::ExpressionOperand<R>::type rhs;
+};
+
+/*
+Operators */
+
+template <typename L, typename R>
+BinaryExpression<L, R, std::plus<typename L::value_type>>
+operator+(const MatrixExpression<L>& a, const MatrixExpression<R>& b) {
+	return {a.derived(), b.derived()};
+}
+
+template <typename L, typename R>
+BinaryExpression<L, R, std::minus<typename L::value_type>>
+operator-(const MatrixExpression<L>& a, const MatrixExpression<R>& b) {
+	return {a.derived(), b.derived()};
+}
+
+template <typename L, typename R>
+ProductExpression<L, R>
+operator*(const MatrixExpression<L>& a, const MatrixExpression<R>& b) {
+	return {a.derived(), b.derived()};
+}
+
+template <typename E>
+ScaledExpression<E>
+operator*(const MatrixExpression<E>& a, const typename E::value_type& scalar) {
+	return {a.derived(), scalar};
+}
+
+template <typename E>
+ScaledExpression<E>
+operator*(const typename E::value_type& scalar, const MatrixExpression<E>& a) {
+	return {a.derived(), scalar};
+}
+
+template <typename E>
+TransposeExpression<E> transpose(const MatrixExpression<E>& a) {
+	return TransposeExpression<E>(a.derived());
+}
+
+template <typename L, typename R, typename Op>
+BinaryExpression<L, R, Op>
+elementWise(const MatrixExpression<L>& a, const MatrixExpression<R>& b, Op op) {
+	return {a.derived(), b.derived(), op};
+}
+
+template <typename L, typename R>
+BinaryExpression<L, R, std::multiplies<typename L::value_type>>
+elementProduct(const MatrixExpression<L>& a, const MatrixExpression<R>& b) {
+	return {a.derived(), b.derived()};
+}
+
+template <typename L, typename R>
+BinaryExpression<L, R, std::divides<typename L::value_type>>
+elementQuotient(const MatrixExpression<L>& a, const MatrixExpression<R>& b) {
+	return {a.derived(), b.derived()};
+}
+
+/*
+Evaluation
+
+assign(dest, e, s):		dest = s * e
+accumulate(dest, e, s):	dest += s * e
+
+Element-wise trees are evaluated in a single fused pass over the destination.
+Trees with product nodes are split on their sums and differences:
+the element-wise terms are fused into one pass, every product term is accumulated
+into the destination by the product kernel, so no intermediate matrix is allocated.
+Aliasing between dest and e is resolved by the caller (Matrix::operator=). */
+
+	namespace Detail {
+
+	template <typename Dest, typename E>
+	void assignElementwise(Dest& dest, const E& e, const typename Dest::value_type& s) {
+		using size_type = typename Dest::size_type;
+		for (size_type y = 0; y < dest.getHeight(); ++y) {
+			for (size_type x = 0; x < dest.getWidth(); ++x) {
+				dest.get(y, x) = s * e.get(y, x);
+			}
+		}
+	}
+
+	template <typename Dest, typename E>
+	void accumulateElementwise(Dest& dest, const E& e, const typename Dest::value_type& s) {
+		using size_type = typename Dest::size_type;
+		for (size_type y = 0; y < dest.getHeight(); ++y) {
+			for (size_type x = 0; x < dest.getWidth(); ++x) {
+				dest.get(y, x) += s * e.get(y, x);
+			}
+		}
+	}
+
+	/*
+	Product operands are indexed O(k) times per element:
+	an operand that contains a product itself is evaluated once beforehand */
+	template <typename E, bool = E::is_elementwise>
+	struct ProductOperand {
+		using type = const E&;
+	};
+
+	template <typename E>
+	struct ProductOperand<E, false> {
+		using type = Matrix<typename E::value_type>;
+	};
+
+	/*
+	Types that store their elements at data()[y * getStride() + x * getColumnStride()] */
+	template <typename E>
+	struct IsDense : std::false_type {};
+
+	template <typename T, typename A>
+	struct IsDense<Matrix<T, A>> : std::true_type {};
+
+	/*
+	dest = s * (a * b) when overwrite, dest += s * (a * b) otherwise
+	Row-major i-k-j order: the inner loop walks rows of b and dest. */
+	template <typename Dest, typename A, typename B>
+	void productKernel(Dest& dest, const A& a, const B& b,
+						const typename Dest::value_type& s, bool overwrite, std::false_type) {
+		using size_type = typename Dest::size_type;
+		using value_type = typename Dest::value_type;
+		assert(dest.getHeight() == a.getHeight() && dest.getWidth() == b.getWidth());
+		for (size_type y = 0; y < dest.getHeight(); ++y) {
+			if (overwrite) {
+				for (size_type x = 0; x < dest.getWidth(); ++x) {
+					dest.get(y, x) = value_type();
+				}
+			}
+			for (size_type k = 0; k < a.getWidth(); ++k) {
+				const value_type factor = s * a.get(y, k);
+				for (size_type x = 0; x < dest.getWidth(); ++x) {
+					dest.get(y, x) += factor * b.get(k, x);
+				}
+			}
+		}
+	}
+
+	/*
+	Dense operands are multiplied on their storage (matrix_multiply.hpp) */
+	template <typename Dest, typename A, typename B>
+	void productKernel(Dest& dest, const A& a, const B& b,
+						const typename Dest::value_type& s, bool overwrite, std::true_type);
+
+	/*
+	Dense int8 and int16 operands widened into an int32 destination (matrix_quantized.hpp) */
+	struct WideningProduct {};
+
+	template <typename T>
+	struct IsNarrowInteger : std::integral_constant<bool,
+		std::is_same<T, std::int8_t>::value
+		|| std::is_same<T, std::uint8_t>::value
+		|| std::is_same<T, std::int16_t>::value> {};
+
+	template <typename Dest, typename A, typename B>
+	void productKernel(Dest& dest, const A& a, const B& b,
+						const typename Dest::value_type& s, bool overwrite, WideningProduct);
+
+	template <typename Dest, typename A, typename B>
+	void productKernel(Dest& dest, const A& a, const B& b,
+						const typename Dest::value_type& s, bool overwrite) {
+		using value_type = typename Dest::value_type;
+		constexpr bool dense = IsDense<Dest>::value && IsDense<A>::value && IsDense<B>::value;
+		constexpr bool same = std::is_same<value_type, typename A::value_type>::value
+			&& std::is_same<value_type, typename B::value_type>::value;
+		constexpr bool widening = std::is_same<value_type, std::int32_t>::value
+			&& IsNarrowInteger<typename A::value_type>::value
+			&& IsNarrowInteger<typename B::value_type>::value;
+		using kernel = typename std::conditional<dense && same, std::true_type,
+			typename std::conditional<dense && widening, WideningProduct, std::false_type>::type>::type;
+		productKernel(dest, a, b, s, overwrite, kernel());
+	}
+
+	template <typename Dest, typename L, typename R>
+	void evaluateProduct(Dest& dest, const ProductExpression<L, R>& e,
+						const typename Dest::value_type& s, bool overwrite) {
+		typename ProductOperand<L>::type a = e.left();
+		typename ProductOperand<R>::type b = e.right();
+		productKernel(dest, a, b, s, overwrite);
+	}
+
+	template <typename Dest, typename E>
+	void assign(Dest& dest, const E& e, const typename Dest::value_type& s);
+
+	template <typename Dest, typename E>
+	void accumulate(Dest& dest, const E& e, const typename Dest::value_type& s);
+
+	template <typename Dest, typename L, typename R, typename T>
+	void assign(Dest& dest, const BinaryExpression<L, R, std::plus<T>>& e,
+				const typename Dest::value_type& s);
+
+	template <typename Dest, typename L, typename R, typename T>
+	void assign(Dest& dest, const BinaryExpression<L, R, std::minus<T>>& e,
+				const typename Dest::value_type& s);
+
+	template <typename Dest, typename E>
+	void assign(Dest& dest, const ScaledExpression<E>& e, const typename Dest::value_type& s);
+
+	/*
+	Defined in matrix_transpose.hpp */
+	template <typename Dest, typename E>
+	void assign(Dest& dest, const TransposeExpression<E>& e, const typename Dest::value_type& s);
+
+	template <typename Dest, typename L, typename R, typename T>
+	void accumulate(Dest& dest, const BinaryExpression<L, R, std::plus<T>>& e,
+					const typename Dest::value_type& s);
+
+	template <typename Dest, typename L, typename R, typename T>
+	void accumulate(Dest& dest, const BinaryExpression<L, R, std::minus<T>>& e,
+					const typename Dest::value_type& s);
+
+	template <typename Dest, typename E>
+	void accumulate(Dest& dest, const ScaledExpression<E>& e, const typename Dest::value_type& s);
+
+	/*
+	Generic node: one fused pass, product nodes nested inside element-wise
+	operations other than + and - are computed per element */
+	template <typename Dest, typename E>
+	void assign(Dest& dest, const E& e, const typename Dest::value_type& s) {
+		assignElementwise(dest, e, s);
+	}
+
+	template <typename Dest, typename E>
+	void accumulate(Dest& dest, const E& e, const typename Dest::value_type& s) {
+		accumulateElementwise(dest, e, s);
+	}
+
+	template <typename Dest, typename L, typename R>
+	void assign(Dest& dest, const ProductExpression<L, R>& e, const typename Dest::value_type& s) {
+		evaluateProduct(dest, e, s, true);
+	}
+
+	template <typename Dest, typename L, typename R>
+	void accumulate(Dest& dest, const ProductExpression<L, R>& e, const typename Dest::value_type& s) {
+		evaluateProduct(dest, e, s, false);
+	}
+
+	/*
+	The element-wise side is written first so that the product side can accumulate
+	onto it instead of clearing the destination */
+	template <typename Dest, typename L, typename R, typename T>
+	void assign(Dest& dest, const BinaryExpression<L, R, std::plus<T>>& e,
+				const typename Dest::value_type& s) {
+		if (e.is_elementwise) {
+			assignElementwise(dest, e, s);
+		} else if (!L::is_elementwise && R::is_elementwise) {
+			assign(dest, e.right(), s);
+			accumulate(dest, e.left(), s);
+		} else {
+			assign(dest, e.left(), s);
+			accumulate(dest, e.right(), s);
+		}
+	}
+
+	template <typename Dest, typename L, typename R, typename T>
+	void assign(Dest& dest, const BinaryExpression<L, R, std::minus<T>>& e,
+				const typename Dest::value_type& s) {
+		if (e.is_elementwise) {
+			assignElementwise(dest, e, s);
+		} else if (!L::is_elementwise && R::is_elementwise) {
+			assign(dest, e.right(), -s);
+			accumulate(dest, e.left(), s);
+		} else {
+			assign(dest, e.left(), s);
+			accumulate(dest, e.right(), -s);
+		}
+	}
+
+	template <typename Dest, typename E>
+	void assign(Dest& dest, const ScaledExpression<E>& e, const typename Dest::value_type& s) {
+		if (e.is_elementwise) {
+			assignElementwise(dest, e, s);
+		} else {
+			assign(dest, e.expression(), s * e.scale());
+		}
+	}
+
+	template <typename Dest, typename L, typename R, typename T>
+	void accumulate(Dest& dest, const BinaryExpression<L, R, std::plus<T>>& e,
+					const typename Dest::value_type& s) {
+		if (e.is_elementwise) {
+			accumulateElementwise(dest, e, s);
+		} else {
+			accumulate(dest, e.left(), s);
+			accumulate(dest, e.right(), s);
+		}
+	}
+
+	template <typename Dest, typename L, typename R, typename T>
+	void accumulate(Dest& dest, const BinaryExpression<L, R, std::minus<T>>& e,
+					const typename Dest::value_type& s) {
+		if (e.is_elementwise) {
+			accumulateElementwise(dest, e, s);
+		} else {
+			accumulate(dest, e.left(), s);
+			accumulate(dest, e.right(), -s);
+		}
+	}
+
+	template <typename Dest, typename E>
+	void accumulate(Dest& dest, const ScaledExpression<E>& e, const typename Dest::value_type& s) {
+		if (e.is_elementwise) {
+			accumulateElementwise(dest, e, s);
+		} else {
+			accumulate(dest, e.expression(), s * e.scale());
+		}
+	}
+
+	}
+
+}
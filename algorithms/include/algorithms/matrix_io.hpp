@@ -0,0 +1,413 @@
+#pragma once
+
+#include "matrix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <vector>
+#include <istream>
+#include <ostream>
+#include <fstream>
+#include <stdexcept>
+#include <type_traits>
+#include <algorithm>
+
+// MappedMatrix needs POSIX mmap, other platforms only have readMatrix
+#if defined(__unix__) || defined(__APPLE__)
+# define DSA_MATRIX_MMAP 1
+# include <fcntl.h>
+# include <unistd.h>
+# include <sys/mman.h>
+# include <sys/stat.h>
+#endif
+
+namespace DSA {
+
+/*
+Binary matrix file
+
+	offset	size	field
+	0		8		magic "DSAMATRX"
+	8		4		version
+	12		1		element type (MatrixDataType)
+	13		1		element size in bytes
+	14		1		byte order of every field and element (1: little endian, 2: big endian)
+	15		1		reserved
+	16		8		rows
+	24		8		columns
+	32		8		stride: elements between the starts of two rows
+	40		8		data offset: bytes from the start of the file to element (0, 0)
+	48		16		reserved
+
+Rows are padded like the default Matrix storage, so every row of a mapped file
+starts on a 64-byte boundary (the data offset is 64 and mappings start on a page). */
+enum class MatrixDataType : std::uint8_t {
+	Unknown = 0,
+	Int8, UInt8, Int16, UInt16, Int32, UInt32, Int64, UInt64,
+	Float32, Float64
+};
+
+class MatrixFormatError : public std::runtime_error {
+public:
+	using std::runtime_error::runtime_error;
+};
+
+	namespace Detail {
+
+	struct MatrixFileHeader {
+		char magic[8];
+		std::uint32_t version;
+		std::uint8_t data_type;
+		std::uint8_t element_size;
+		std::uint8_t byte_order;
+		std::uint8_t reserved;
+		std::uint64_t rows;
+		std::uint64_t columns;
+		std::uint64_t stride;
+		std::uint64_t data_offset;
+		char padding[16];
+	};
+
+	static_assert(sizeof(MatrixFileHeader) == 64, "matrix file header layout");
+
+	constexpr const char* matrixFileMagic() {
+		return "DSAMATRX";
+	}
+
+	constexpr std::uint32_t matrixFileVersion() {
+		return 1;
+	}
+
+	enum : std::uint8_t {
+		LittleEndian = 1,
+		BigEndian = 2
+	};
+
+	inline std::uint8_t nativeByteOrder() {
+		const std::uint16_t one = 1;
+		unsigned char first;
+		std::memcpy(&first, &one, 1);
+		return first == 1 ? LittleEndian : BigEndian;
+	}
+
+	constexpr MatrixDataType integerDataType(std::size_t size, bool is_signed) {
+		return size == 1 ? (is_signed ? MatrixDataType::Int8 : MatrixDataType::UInt8)
+			: size == 2 ? (is_signed ? MatrixDataType::Int16 : MatrixDataType::UInt16)
+			: size == 4 ? (is_signed ? MatrixDataType::Int32 : MatrixDataType::UInt32)
+			: size == 8 ? (is_signed ? MatrixDataType::Int64 : MatrixDataType::UInt64)
+			: MatrixDataType::Unknown;
+	}
+
+	template <typename T>
+	constexpr MatrixDataType dataTypeOf() {
+		return std::is_same<T, bool>::value ? MatrixDataType::Unknown
+			: std::is_integral<T>::value ? integerDataType(sizeof(T), std::is_signed<T>::value)
+			: std::is_same<T, float>::value ? MatrixDataType::Float32
+			: std::is_same<T, double>::value ? MatrixDataType::Float64
+			: MatrixDataType::Unknown;
+	}
+
+	inline void reverseBytes(void* p, std::size_t size) {
+		unsigned char* bytes = static_cast<unsigned char*>(p);
+		std::reverse(bytes, bytes + size);
+	}
+
+	template <typename U>
+	void reverseBytes(U& value) {
+		reverseBytes(&value, sizeof(U));
+	}
+
+	/*
+	Checks the fixed fields, converts a header of the other byte order to native */
+	template <typename T>
+	void validateHeader(MatrixFileHeader& header) {
+		if (std::memcmp(header.magic, matrixFileMagic(), sizeof(header.magic)) != 0) {
+			throw MatrixFormatError("matrix file: bad magic");
+		}
+		if (header.byte_order != nativeByteOrder()) {
+			if (header.byte_order != LittleEndian && header.byte_order != BigEndian) {
+				throw MatrixFormatError("matrix file: bad byte order");
+			}
+			reverseBytes(header.version);
+			reverseBytes(header.rows);
+			reverseBytes(header.columns);
+			reverseBytes(header.stride);
+			reverseBytes(header.data_offset);
+		}
+		if (header.version != matrixFileVersion()) {
+			throw MatrixFormatError("matrix file: unsupported version");
+		}
+		if (header.data_type != static_cast<std::uint8_t>(dataTypeOf<T>()) || header.element_size != sizeof(T)) {
+			throw MatrixFormatError("matrix file: element type differs from the requested type");
+		}
+		if (header.stride < header.columns || header.data_offset < sizeof(MatrixFileHeader)) {
+			throw MatrixFormatError("matrix file: bad layout");
+		}
+	}
+
+	/*
+	Bytes from the data offset to the end of the last row */
+	template <typename T>
+	std::uint64_t matrixFileDataSize(const MatrixFileHeader& header) {
+		if (header.rows == 0 || header.columns == 0) {
+			return 0;
+		}
+		const std::uint64_t max = UINT64_MAX / sizeof(T);
+		if (header.rows - 1 > (max - header.columns) / header.stride) {
+			throw MatrixFormatError("matrix file: bad dimensions");
+		}
+		return ((header.rows - 1) * header.stride + header.columns) * sizeof(T);
+	}
+
+	template <typename T>
+	void writeMatrixRows(std::ostream& out, const T* data, std::size_t rows, std::size_t columns,
+						std::size_t stride, std::size_t file_stride) {
+		if (stride == columns && file_stride == columns) {
+			out.write(reinterpret_cast<const char*>(data),
+					static_cast<std::streamsize>(rows * columns * sizeof(T)));
+			return;
+		}
+		const std::vector<T> padding(file_stride - columns);
+		for (std::size_t y = 0; y < rows; ++y) {
+			out.write(reinterpret_cast<const char*>(data + y * stride), columns * sizeof(T));
+			if (y + 1 < rows) {
+				out.write(reinterpret_cast<const char*>(padding.data()), padding.size() * sizeof(T));
+			}
+		}
+	}
+
+	/*
+	Elements that are not stored contiguously are gathered one row at a time */
+	template <typename E>
+	void writeMatrixRows(std::ostream& out, const E& m, std::size_t file_stride, std::false_type) {
+		using T = typename E::value_type;
+		std::vector<T> row(file_stride);
+		for (std::size_t y = 0; y < m.getHeight(); ++y) {
+			for (std::size_t x = 0; x < m.getWidth(); ++x) {
+				row[x] = m.get(y, x);
+			}
+			const std::size_t count = y + 1 < m.getHeight() ? file_stride : m.getWidth();
+			out.write(reinterpret_cast<const char*>(row.data()), count * sizeof(T));
+		}
+	}
+
+	template <typename E>
+	void writeMatrixRows(std::ostream& out, const E& m, std::size_t file_stride, std::true_type) {
+		using T = typename E::value_type;
+		if (m.getColumnStride() != 1) {
+			writeMatrixRows(out, m, file_stride, std::false_type());
+			return;
+		}
+		writeMatrixRows<T>(out, m.data(), m.getHeight(), m.getWidth(), m.getStride(), file_stride);
+	}
+
+	}
+
+/*
+Writes the matrix in the binary format, in the native byte order.
+Contiguous rows are written with a single call, the stream should be opened in binary mode. */
+template <typename E>
+void writeMatrix(std::ostream& out, const MatrixExpression<E>& e) {
+	using T = typename E::value_type;
+	static_assert(Detail::dataTypeOf<T>() != MatrixDataType::Unknown, "matrix file: unsupported element type");
+	const E& m = e.derived();
+	Detail::MatrixFileHeader header;
+	std::memset(&header, 0, sizeof(header));
+	std::memcpy(header.magic, Detail::matrixFileMagic(), sizeof(header.magic));
+	header.version = Detail::matrixFileVersion();
+	header.data_type = static_cast<std::uint8_t>(Detail::dataTypeOf<T>());
+	header.element_size = sizeof(T);
+	header.byte_order = Detail::nativeByteOrder();
+	header.rows = m.getHeight();
+	header.columns = m.getWidth();
+	header.stride = Detail::paddedStride<T>(m.getWidth(), 64);
+	header.data_offset = sizeof(header);
+	out.write(reinterpret_cast<const char*>(&header), sizeof(header));
+	if (m.getHeight() == 0 || m.getWidth() == 0) {
+		return;
+	}
+	using contiguous = std::integral_constant<bool, Detail::IsDense<E>::value>;
+	Detail::writeMatrixRows(out, m, header.stride, contiguous());
+}
+
+template <typename E>
+void writeMatrix(const std::string& path, const MatrixExpression<E>& e) {
+	std::ofstream out {path, std::ios::binary | std::ios::trunc};
+	if (!out) {
+		throw std::runtime_error("cannot open " + path);
+	}
+	writeMatrix(out, e);
+	if (!out.flush()) {
+		throw std::runtime_error("cannot write " + path);
+	}
+}
+
+/*
+Reads a matrix written by writeMatrix into memory.
+Files of the other byte order are converted. */
+template <typename T, typename Allocator = AlignedAllocator<T>>
+Matrix<T, Allocator> readMatrix(std::istream& in) {
+	static_assert(Detail::dataTypeOf<T>() != MatrixDataType::Unknown, "matrix file: unsupported element type");
+	Detail::MatrixFileHeader header;
+	if (!in.read(reinterpret_cast<char*>(&header), sizeof(header))) {
+		throw MatrixFormatError("matrix file: truncated header");
+	}
+	const bool swap = header.byte_order != Detail::nativeByteOrder();
+	Detail::validateHeader<T>(header);
+	Detail::matrixFileDataSize<T>(header);
+	in.ignore(static_cast<std::streamsize>(header.data_offset - sizeof(header)));
+	Matrix<T, Allocator> m {static_cast<std::size_t>(header.rows), static_cast<std::size_t>(header.columns)};
+	for (std::size_t y = 0; y < m.getHeight(); ++y) {
+		T* row = m.data() + y * m.getStride();
+		if (!in.read(reinterpret_cast<char*>(row), static_cast<std::streamsize>(m.getWidth() * sizeof(T)))) {
+			throw MatrixFormatError("matrix file: truncated data");
+		}
+		if (swap) {
+			for (std::size_t x = 0; x < m.getWidth(); ++x) {
+				Detail::reverseBytes(row[x]);
+			}
+		}
+		if (y + 1 < m.getHeight()) {
+			in.ignore(static_cast<std::streamsize>((header.stride - header.columns) * sizeof(T)));
+		}
+	}
+	return m;
+}
+
+template <typename T, typename Allocator = AlignedAllocator<T>>
+Matrix<T, Allocator> readMatrix(const std::string& path) {
+	std::ifstream in {path, std::ios::binary};
+	if (!in) {
+		throw std::runtime_error("cannot open " + path);
+	}
+	return readMatrix<T, Allocator>(in);
+}
+
+#if defined(DSA_MATRIX_MMAP)
+
+/*
+Read-only memory mapping of a matrix file: the elements are read straight from the
+page cache, nothing is copied and pages are only loaded when they are accessed.
+The file must be in the native byte order (readMatrix converts other files).
+Views returned by view() are valid as long as the MappedMatrix is alive. */
+template <typename T>
+class MappedMatrix {
+public:
+	using size_type = std::size_t;
+	using value_type = T;
+
+	static_assert(Detail::dataTypeOf<T>() != MatrixDataType::Unknown, "matrix file: unsupported element type");
+
+public:
+	explicit MappedMatrix(const std::string& path)
+	: address(nullptr), length(0), elements(nullptr), height(0), width(0), stride(0) {
+		const int fd = ::open(path.c_str(), O_RDONLY);
+		if (fd == -1) {
+			throw std::runtime_error("cannot open " + path);
+		}
+		struct stat info;
+		if (::fstat(fd, &info) == -1 || static_cast<std::uint64_t>(info.st_size) < sizeof(Detail::MatrixFileHeader)) {
+			::close(fd);
+			throw MatrixFormatError("matrix file: truncated header");
+		}
+		length = static_cast<std::size_t>(info.st_size);
+		address = ::mmap(nullptr, length, PROT_READ, MAP_SHARED, fd, 0);
+		::close(fd);
+		if (address == MAP_FAILED) {
+			address = nullptr;
+			throw std::runtime_error("cannot map " + path);
+		}
+		try {
+			adopt();
+		} catch (...) {
+			unmap();
+			throw;
+		}
+	}
+
+	MappedMatrix(const MappedMatrix& other) = delete;
+	MappedMatrix& operator=(const MappedMatrix& rhs) = delete;
+
+	MappedMatrix(MappedMatrix&& other) noexcept
+	: address(other.address), length(other.length), elements(other.elements),
+	height(other.height), width(other.width), stride(other.stride) {
+		other.address = nullptr;
+		other.length = 0;
+	}
+
+	MappedMatrix& operator=(MappedMatrix&& rhs) noexcept {
+		if (this != &rhs) {
+			unmap();
+			std::swap(address, rhs.address);
+			std::swap(length, rhs.length);
+			elements = rhs.elements;
+			height = rhs.height;
+			width = rhs.width;
+			stride = rhs.stride;
+		}
+		return *this;
+	}
+
+	~MappedMatrix() {
+		unmap();
+	}
+
+	ConstMatrixView<T> view() const {
+		return ConstMatrixView<T>(elements, height, width, stride);
+	}
+
+	size_type getHeight() const {
+		return height;
+	}
+
+	size_type getWidth() const {
+		return width;
+	}
+
+	size_type getStride() const {
+		return stride;
+	}
+
+	const T& get(size_type y, size_type x) const {
+		return elements[y * stride + x];
+	}
+
+private:
+	void adopt() {
+		Detail::MatrixFileHeader header;
+		std::memcpy(&header, address, sizeof(header));
+		if (header.byte_order != Detail::nativeByteOrder()) {
+			throw MatrixFormatError("matrix file: byte order differs from this machine, use readMatrix");
+		}
+		Detail::validateHeader<T>(header);
+		const std::uint64_t size = Detail::matrixFileDataSize<T>(header);
+		if (header.data_offset % alignof(T) != 0 || header.data_offset > length
+			|| size > length - header.data_offset) {
+			throw MatrixFormatError("matrix file: truncated data");
+		}
+		elements = reinterpret_cast<const T*>(static_cast<const char*>(address) + header.data_offset);
+		height = header.rows;
+		width = header.columns;
+		stride = header.stride;
+	}
+
+	void unmap() noexcept {
+		if (address) {
+			::munmap(address, length);
+			address = nullptr;
+		}
+	}
+
+private:
+	void* address;
+	std::size_t length;
+	const T* elements;
+	size_type height;
+	size_type width;
+	size_type stride;
+};
+
+#endif
+
+}
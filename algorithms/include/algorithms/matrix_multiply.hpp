@@ -0,0 +1,398 @@
+#pragma once
+
+#include "matrix_expression.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <vector>
+#include <algorithm>
+#include <type_traits>
+
+#if defined(__AVX2__)
+# include <immintrin.h>
+#endif
+
+namespace DSA {
+
+/*
+Square matrices of a larger size are multiplied with Strassen-Winograd,
+smaller products (and the leaves of the recursion) use the blocked classical kernel.
+
+Measured with benchmarkStrassen (algorithm/main.cpp), Release, double, noisy single-core VM:
+	n = 80:   classical 0.13ms, leaf 64 0.12ms
+	n = 128:  classical 1.0ms, leaf 64 0.56ms
+	n = 1024: classical 337ms, leaf 64 184ms, leaf 256 246ms */
+constexpr std::size_t strassenCrossover() {
+	return 64;
+}
+
+	namespace Detail {
+
+	/*
+	Tile edge of the classical kernel: a tile of b stays in L1 while it is reused for every row */
+	constexpr std::size_t multiplyBlockSize() {
+		return 64;
+	}
+
+	/*
+	Raw row-major kernels: a matrix is a pointer to its first element and a row stride (ld) */
+
+	/*
+	c = alpha * a * b when overwrite, c += alpha * a * b otherwise
+	a: m x k, b: k x n, c: m x n
+	O(m * k * n) */
+	template <typename T>
+	void multiplyBlocked(std::size_t m, std::size_t k, std::size_t n,
+						const T* a, std::size_t lda, const T* b, std::size_t ldb,
+						T* c, std::size_t ldc, const T& alpha, bool overwrite) {
+		const std::size_t block = multiplyBlockSize();
+		if (overwrite) {
+			for (std::size_t y = 0; y < m; ++y) {
+				std::fill(c + y * ldc, c + y * ldc + n, T());
+			}
+		}
+		for (std::size_t kk = 0; kk < k; kk += block) {
+			const std::size_t kend = std::min(kk + block, k);
+			for (std::size_t xx = 0; xx < n; xx += block) {
+				const std::size_t xend = std::min(xx + block, n);
+				for (std::size_t y = 0; y < m; ++y) {
+					T* crow = c + y * ldc;
+					for (std::size_t kx = kk; kx < kend; ++kx) {
+						const T factor = alpha * a[y * lda + kx];
+						const T* brow = b + kx * ldb;
+						for (std::size_t x = xx; x < xend; ++x) {
+							crow[x] += factor * brow[x];
+						}
+					}
+				}
+			}
+		}
+	}
+
+	/*
+	c = a + b, n x n, c may be a or b */
+	template <typename T>
+	void addSquare(std::size_t n, const T* a, std::size_t lda,
+					const T* b, std::size_t ldb, T* c, std::size_t ldc) {
+		for (std::size_t y = 0; y < n; ++y) {
+			for (std::size_t x = 0; x < n; ++x) {
+				c[y * ldc + x] = a[y * lda + x] + b[y * ldb + x];
+			}
+		}
+	}
+
+	/*
+	c = a - b, n x n, c may be a or b */
+	template <typename T>
+	void subtractSquare(std::size_t n, const T* a, std::size_t lda,
+						const T* b, std::size_t ldb, T* c, std::size_t ldc) {
+		for (std::size_t y = 0; y < n; ++y) {
+			for (std::size_t x = 0; x < n; ++x) {
+				c[y * ldc + x] = a[y * lda + x] - b[y * ldb + x];
+			}
+		}
+	}
+
+	/*
+	Number of elements of workspace used by strassenWinograd below:
+	every even level takes two (n/2)^2 temporaries, odd levels are peeled without workspace.
+	Children run one after another, so they all share the space behind their parent's temporaries. */
+	inline std::size_t strassenWorkspace(std::size_t n, std::size_t leaf) {
+		std::size_t total = 0;
+		while (n > leaf) {
+			if (n % 2 == 1) {
+				n -= 1;
+				continue;
+			}
+			n /= 2;
+			total += 2 * n * n;
+		}
+		return total;
+	}
+
+	template <typename T>
+	void strassenWinograd(std::size_t n, const T* a, std::size_t lda,
+						const T* b, std::size_t ldb, T* c, std::size_t ldc,
+						T* workspace, std::size_t leaf);
+
+	/*
+	Dynamic peeling of an odd n: the even (n - 1) x (n - 1) product is computed
+	recursively, the last row and column are fixed up classically in O(n^2) */
+	template <typename T>
+	void strassenPeel(std::size_t n, const T* a, std::size_t lda,
+					const T* b, std::size_t ldb, T* c, std::size_t ldc,
+					T* workspace, std::size_t leaf) {
+		const std::size_t m = n - 1;
+		strassenWinograd(m, a, lda, b, ldb, c, ldc, workspace, leaf);
+		// C11 += a12 * b21 (rank 1 update)
+		multiplyBlocked(m, 1, m, a + m, lda, b + m * ldb, ldb, c, ldc, T(1), false);
+		// c12 = A1* * b*2
+		for (std::size_t y = 0; y < m; ++y) {
+			T sum = T();
+			for (std::size_t k = 0; k < n; ++k) {
+				sum += a[y * lda + k] * b[k * ldb + m];
+			}
+			c[y * ldc + m] = sum;
+		}
+		// [c21 c22] = a2* * B
+		multiplyBlocked(1, n, n, a + m * lda, lda, b, ldb, c + m * ldc, ldc, T(1), true);
+	}
+
+	/*
+	c = a * b, n x n, with the Strassen-Winograd variant: 7 multiplications and 15 additions per level.
+	The schedule (Douglas et al.) only needs two (n/2)^2 temporaries per level,
+	which are taken from the preallocated workspace.
+
+	T(n) = 7 * T(n / 2) + O(n^2) = O(n^log2(7)) = O(n^2.81) */
+	template <typename T>
+	void strassenWinograd(std::size_t n, const T* a, std::size_t lda,
+						const T* b, std::size_t ldb, T* c, std::size_t ldc,
+						T* workspace, std::size_t leaf) {
+		if (n <= leaf) {
+			multiplyBlocked(n, n, n, a, lda, b, ldb, c, ldc, T(1), true);
+			return;
+		} else if (n % 2 == 1) {
+			strassenPeel(n, a, lda, b, ldb, c, ldc, workspace, leaf);
+			return;
+		}
+
+		const std::size_t h = n / 2;
+		const T* a11 = a;
+		const T* a12 = a + h;
+		const T* a21 = a + h * lda;
+		const T* a22 = a21 + h;
+		const T* b11 = b;
+		const T* b12 = b + h;
+		const T* b21 = b + h * ldb;
+		const T* b22 = b21 + h;
+		T* c11 = c;
+		T* c12 = c + h;
+		T* c21 = c + h * ldc;
+		T* c22 = c21 + h;
+		T* x = workspace;
+		T* y = workspace + h * h;
+		T* rest = workspace + 2 * h * h;
+
+		subtractSquare(h, a11, lda, a21, lda, x, h);			// S3 = A11 - A21
+		subtractSquare(h, b22, ldb, b12, ldb, y, h);			// T3 = B22 - B12
+		strassenWinograd(h, x, h, y, h, c21, ldc, rest, leaf);	// P7 = S3 * T3
+		addSquare(h, a21, lda, a22, lda, x, h);					// S1 = A21 + A22
+		subtractSquare(h, b12, ldb, b11, ldb, y, h);			// T1 = B12 - B11
+		strassenWinograd(h, x, h, y, h, c22, ldc, rest, leaf);	// P5 = S1 * T1
+		subtractSquare(h, x, h, a11, lda, x, h);				// S2 = S1 - A11
+		subtractSquare(h, b22, ldb, y, h, y, h);				// T2 = B22 - T1
+		strassenWinograd(h, x, h, y, h, c12, ldc, rest, leaf);	// P6 = S2 * T2
+		subtractSquare(h, a12, lda, x, h, x, h);				// S4 = A12 - S2
+		strassenWinograd(h, x, h, b22, ldb, c11, ldc, rest, leaf);	// P3 = S4 * B22
+		strassenWinograd(h, a11, lda, b11, ldb, x, h, rest, leaf);	// P1 = A11 * B11
+		addSquare(h, x, h, c12, ldc, c12, ldc);					// U2 = P1 + P6
+		addSquare(h, c12, ldc, c21, ldc, c21, ldc);				// U3 = U2 + P7
+		addSquare(h, c12, ldc, c22, ldc, c12, ldc);				// U4 = U2 + P5
+		addSquare(h, c21, ldc, c22, ldc, c22, ldc);				// U7 = U3 + P5 = C22
+		addSquare(h, c12, ldc, c11, ldc, c12, ldc);				// U5 = U4 + P3 = C12
+		subtractSquare(h, y, h, b21, ldb, y, h);				// T4 = T2 - B21
+		strassenWinograd(h, a22, lda, y, h, c11, ldc, rest, leaf);	// P4 = A22 * T4
+		subtractSquare(h, c21, ldc, c11, ldc, c21, ldc);		// U6 = U3 - P4 = C21
+		strassenWinograd(h, a12, lda, b21, ldb, c11, ldc, rest, leaf);	// P2 = A12 * B21
+		addSquare(h, x, h, c11, ldc, c11, ldc);					// U1 = P1 + P2 = C11
+	}
+
+	template <typename A, typename B>
+	bool useStrassen(const A& a, const B& b, std::size_t leaf) {
+		return std::is_arithmetic<typename A::value_type>::value
+			&& a.getHeight() == a.getWidth()
+			&& b.getHeight() == b.getWidth()
+			&& a.getWidth() == b.getHeight()
+			&& a.getHeight() > leaf;
+	}
+
+	/*
+	Workspace arena: one allocation holds the temporaries of every level of the recursion,
+	plus room for the product itself when it has to be scaled or accumulated */
+	template <typename Dest, typename A, typename B>
+	void strassenProduct(Dest& dest, const A& a, const B& b,
+						const typename Dest::value_type& s, bool overwrite, std::size_t leaf) {
+		using T = typename Dest::value_type;
+		const std::size_t n = a.getHeight();
+		const bool direct = overwrite && s == T(1);
+		const std::size_t scratch = strassenWorkspace(n, leaf);
+		std::vector<T> arena(scratch + (direct ? 0 : n * n));
+		if (direct) {
+			strassenWinograd(n, a.data(), a.getStride(), b.data(), b.getStride(),
+							dest.data(), dest.getStride(), arena.data(), leaf);
+			return;
+		}
+		T* product = arena.data() + scratch;
+		strassenWinograd(n, a.data(), a.getStride(), b.data(), b.getStride(),
+						product, n, arena.data(), leaf);
+		for (std::size_t y = 0; y < n; ++y) {
+			T* row = dest.data() + y * dest.getStride();
+			for (std::size_t x = 0; x < n; ++x) {
+				row[x] = (overwrite ? T() : row[x]) + s * product[y * n + x];
+			}
+		}
+	}
+
+	/*
+	Product of dense operands (matrices and views) with contiguous rows,
+	strided columns fall back to the generic kernel */
+	template <typename Dest, typename A, typename B>
+	void productKernel(Dest& dest, const A& a, const B& b,
+						const typename Dest::value_type& s, bool overwrite, std::true_type) {
+		if (dest.getColumnStride() != 1 || a.getColumnStride() != 1 || b.getColumnStride() != 1) {
+			productKernel(dest, a, b, s, overwrite, std::false_type());
+		} else if (useStrassen(a, b, strassenCrossover())) {
+			strassenProduct(dest, a, b, s, overwrite, strassenCrossover());
+		} else {
+			multiplyBlocked(a.getHeight(), a.getWidth(), b.getWidth(),
+							a.data(), a.getStride(), b.data(), b.getStride(),
+							dest.data(), dest.getStride(), s, overwrite);
+		}
+	}
+
+	/*
+	Pairs of k handled per pass of the widening kernel: the packed rows of b
+	for one pass and a strip of the destination stay in L2 */
+	constexpr std::size_t widenBlockSize() {
+		return 128;
+	}
+
+	/*
+	a (m x k) widened to int16, every row padded to 2 * pairs elements */
+	template <typename A>
+	std::vector<std::int16_t> packWidened(const A& a, std::size_t pairs) {
+		std::vector<std::int16_t> packed(a.getHeight() * 2 * pairs, 0);
+		for (std::size_t y = 0; y < a.getHeight(); ++y) {
+			for (std::size_t k = 0; k < a.getWidth(); ++k) {
+				packed[y * 2 * pairs + k] = a.get(y, k);
+			}
+		}
+		return packed;
+	}
+
+	/*
+	b (k x n) widened to int16 and interleaved by pairs of rows:
+	packed[p * 2n + 2x + j] = b(2p + j, x), a zero row pads an odd k.
+	Eight columns of two rows are then one 256-bit load, in the order pmaddwd expects. */
+	template <typename B>
+	std::vector<std::int16_t> packRowPairs(const B& b, std::size_t pairs) {
+		const std::size_t n = b.getWidth();
+		std::vector<std::int16_t> packed(pairs * 2 * n, 0);
+		for (std::size_t k = 0; k < b.getHeight(); ++k) {
+			std::int16_t* row = packed.data() + (k / 2) * 2 * n + k % 2;
+			for (std::size_t x = 0; x < n; ++x) {
+				row[2 * x] = b.get(k, x);
+			}
+		}
+		return packed;
+	}
+
+	/*
+	c += a * b on packed operands, exact in int32:
+	every pair of int16 products is summed by one multiply-add (pmaddwd on AVX2) */
+	inline void multiplyWidened(std::size_t m, std::size_t pairs, std::size_t n,
+								const std::int16_t* a, const std::int16_t* b,
+								std::int32_t* c, std::size_t ldc) {
+		const std::size_t block = widenBlockSize();
+		for (std::size_t pp = 0; pp < pairs; pp += block) {
+			const std::size_t pend = std::min(pp + block, pairs);
+			for (std::size_t y = 0; y < m; ++y) {
+				const std::int16_t* arow = a + y * 2 * pairs;
+				std::int32_t* crow = c + y * ldc;
+				std::size_t x = 0;
+#if defined(__AVX2__)
+				for (; x + 32 <= n; x += 32) {
+					__m256i acc0 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(crow + x));
+					__m256i acc1 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(crow + x + 8));
+					__m256i acc2 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(crow + x + 16));
+					__m256i acc3 = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(crow + x + 24));
+					for (std::size_t p = pp; p < pend; ++p) {
+						std::int32_t word;
+						std::memcpy(&word, arow + 2 * p, sizeof(word));
+						const __m256i pair = _mm256_set1_epi32(word);
+						const __m256i* brow = reinterpret_cast<const __m256i*>(b + p * 2 * n + 2 * x);
+						acc0 = _mm256_add_epi32(acc0, _mm256_madd_epi16(pair, _mm256_loadu_si256(brow)));
+						acc1 = _mm256_add_epi32(acc1, _mm256_madd_epi16(pair, _mm256_loadu_si256(brow + 1)));
+						acc2 = _mm256_add_epi32(acc2, _mm256_madd_epi16(pair, _mm256_loadu_si256(brow + 2)));
+						acc3 = _mm256_add_epi32(acc3, _mm256_madd_epi16(pair, _mm256_loadu_si256(brow + 3)));
+					}
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(crow + x), acc0);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(crow + x + 8), acc1);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(crow + x + 16), acc2);
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(crow + x + 24), acc3);
+				}
+				for (; x + 8 <= n; x += 8) {
+					__m256i acc = _mm256_loadu_si256(reinterpret_cast<const __m256i*>(crow + x));
+					for (std::size_t p = pp; p < pend; ++p) {
+						std::int32_t word;
+						std::memcpy(&word, arow + 2 * p, sizeof(word));
+						const __m256i* brow = reinterpret_cast<const __m256i*>(b + p * 2 * n + 2 * x);
+						acc = _mm256_add_epi32(acc, _mm256_madd_epi16(_mm256_set1_epi32(word), _mm256_loadu_si256(brow)));
+					}
+					_mm256_storeu_si256(reinterpret_cast<__m256i*>(crow + x), acc);
+				}
+#endif
+				for (std::size_t p = pp; p < pend; ++p) {
+					const std::int32_t a0 = arow[2 * p];
+					const std::int32_t a1 = arow[2 * p + 1];
+					const std::int16_t* brow = b + p * 2 * n;
+					for (std::size_t xx = x; xx < n; ++xx) {
+						crow[xx] += a0 * brow[2 * xx] + a1 * brow[2 * xx + 1];
+					}
+				}
+			}
+		}
+	}
+
+	/*
+	dest = s * (a * b) when overwrite, dest += s * (a * b) otherwise, for int8 / int16 operands
+	and an int32 destination. Sums of products are exact only while k * max|a| * max|b| fits in int32:
+	always for int8 up to k = 133144, but for int16 already from k = 3 at full scale,
+	where the scalar loop overflows (undefined behaviour). quantizeRows / quantizeColumns
+	keep to this bound, other int16 callers have to. */
+	template <typename Dest, typename A, typename B>
+	void productKernel(Dest& dest, const A& a, const B& b,
+						const typename Dest::value_type& s, bool overwrite, WideningProduct) {
+		const std::size_t m = a.getHeight();
+		const std::size_t n = b.getWidth();
+		const std::size_t pairs = (a.getWidth() + 1) / 2;
+		const std::vector<std::int16_t> pa = packWidened(a, pairs);
+		const std::vector<std::int16_t> pb = packRowPairs(b, pairs);
+		if (overwrite && s == 1 && dest.getColumnStride() == 1) {
+			for (std::size_t y = 0; y < m; ++y) {
+				std::fill(dest.data() + y * dest.getStride(), dest.data() + y * dest.getStride() + n, 0);
+			}
+			multiplyWidened(m, pairs, n, pa.data(), pb.data(), dest.data(), dest.getStride());
+			return;
+		}
+		std::vector<std::int32_t> product(m * n, 0);
+		multiplyWidened(m, pairs, n, pa.data(), pb.data(), product.data(), n);
+		for (std::size_t y = 0; y < m; ++y) {
+			for (std::size_t x = 0; x < n; ++x) {
+				std::int32_t& e = dest.get(y, x);
+				e = (overwrite ? 0 : e) + s * product[y * n + x];
+			}
+		}
+	}
+
+	}
+
+/*
+Explicit Strassen-Winograd product of square matrices, recursing down to `leaf`.
+Other shapes and n <= leaf use the classical kernel directly (not operator*,
+which would apply strassenCrossover() again). */
+template <typename T, typename A>
+Matrix<T, A> strassenProduct(const Matrix<T, A>& a, const Matrix<T, A>& b,
+							std::size_t leaf = strassenCrossover()) {
+	Matrix<T, A> c {a.getHeight(), b.getWidth(), a.get_allocator()};
+	if (Detail::useStrassen(a, b, leaf)) {
+		Detail::strassenProduct(c, a, b, T(1), true, leaf);
+	} else {
+		Detail::multiplyBlocked(a.getHeight(), a.getWidth(), b.getWidth(),
+								a.data(), a.getStride(), b.data(), b.getStride(),
+								c.data(), c.getStride(), T(1), true);
+	}
+	return c;
+}
+
+}
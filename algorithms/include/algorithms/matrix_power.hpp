@@ -0,0 +1,302 @@
+#pragma once
+
+#include "matrix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+namespace DSA {
+
+	namespace Detail {
+
+	/*
+	c = a * b for square matrices of the same size, c is neither a nor b.
+	The Strassen workspace is passed in, so that repeated products of the same size
+	(exponentiation by squaring) never allocate. */
+	template <typename T, typename A>
+	void multiplySquare(Matrix<T, A>& c, const Matrix<T, A>& a, const Matrix<T, A>& b,
+						std::vector<T>& workspace) {
+		const std::size_t n = a.getHeight();
+		if (useStrassen(a, b, strassenCrossover())) {
+			workspace.resize(strassenWorkspace(n, strassenCrossover()));
+			strassenWinograd(n, a.data(), a.getStride(), b.data(), b.getStride(),
+							c.data(), c.getStride(), workspace.data(), strassenCrossover());
+		} else {
+			c = a * b;
+		}
+	}
+
+	/*
+	Modular arithmetic on residues below 2^32: a product of two residues fits in 64 bits.
+	Sums of products are reduced lazily, every `batch` terms, instead of after every term. */
+	class Modulus {
+	public:
+		explicit Modulus(std::uint64_t m)
+		: m(m) {
+			assert(m > 0 && m <= (std::uint64_t(1) << 32));
+			const std::uint64_t largest = (m - 1) * (m - 1);
+			batch = largest == 0 ? std::numeric_limits<std::size_t>::max()
+				: static_cast<std::size_t>(std::min<std::uint64_t>((UINT64_MAX - (m - 1)) / largest,
+																	std::numeric_limits<std::size_t>::max()));
+		}
+
+		template <typename T>
+		std::uint64_t reduce(T value) const {
+			if (std::is_signed<T>::value && value < 0) {
+				const std::uint64_t r = static_cast<std::uint64_t>(-(value + 1)) % m;
+				return r == m - 1 ? 0 : m - 1 - r;
+			}
+			return static_cast<std::uint64_t>(value) % m;
+		}
+
+		std::uint64_t value() const {
+			return m;
+		}
+
+		/*
+		Products that can be added to a reduced value without overflowing */
+		std::size_t terms() const {
+			return batch;
+		}
+
+	private:
+		std::uint64_t m;
+		std::size_t batch;
+	};
+
+	/*
+	c = a * b mod m, n x n row-major residues, i-k-j order */
+	inline void multiplyModular(std::size_t n, const std::uint64_t* a, const std::uint64_t* b,
+								std::uint64_t* c, const Modulus& mod) {
+		const std::uint64_t m = mod.value();
+		std::fill(c, c + n * n, 0);
+		for (std::size_t y = 0; y < n; ++y) {
+			std::uint64_t* crow = c + y * n;
+			std::size_t pending = 0;
+			for (std::size_t k = 0; k < n; ++k) {
+				if (pending == mod.terms()) {
+					for (std::size_t x = 0; x < n; ++x) {
+						crow[x] %= m;
+					}
+					pending = 0;
+				}
+				const std::uint64_t factor = a[y * n + k];
+				const std::uint64_t* brow = b + k * n;
+				for (std::size_t x = 0; x < n; ++x) {
+					crow[x] += factor * brow[x];
+				}
+				++pending;
+			}
+			for (std::size_t x = 0; x < n; ++x) {
+				crow[x] %= m;
+			}
+		}
+	}
+
+	inline void multiplyVectorModular(std::size_t n, const std::uint64_t* a, const std::uint64_t* v,
+									std::uint64_t* out, const Modulus& mod) {
+		for (std::size_t y = 0; y < n; ++y) {
+			std::uint64_t sum = 0;
+			std::size_t pending = 0;
+			for (std::size_t k = 0; k < n; ++k) {
+				if (pending == mod.terms()) {
+					sum %= mod.value();
+					pending = 0;
+				}
+				sum += a[y * n + k] * v[k];
+				++pending;
+			}
+			out[y] = sum % mod.value();
+		}
+	}
+
+	/*
+	Whether every residue of `modulus`, up to modulus - 1, can be stored in T */
+	template <typename T>
+	bool residuesFit(std::uint64_t modulus) {
+		return modulus > 0 && modulus - 1 <= static_cast<std::uint64_t>(std::numeric_limits<T>::max());
+	}
+
+	template <typename T, typename A>
+	std::vector<std::uint64_t> residues(const Matrix<T, A>& m, const Modulus& mod) {
+		const std::size_t n = m.getHeight();
+		std::vector<std::uint64_t> r(n * n);
+		for (std::size_t y = 0; y < n; ++y) {
+			for (std::size_t x = 0; x < n; ++x) {
+				r[y * n + x] = mod.reduce(m.get(y, x));
+			}
+		}
+		return r;
+	}
+
+	/*
+	Repeated matrix-vector products cost k * n^2, squaring costs about n^3 per bit of k:
+	the vector is multiplied k times when that is cheaper */
+	inline bool repeatVectorProduct(std::size_t n, std::uint64_t k) {
+		std::uint64_t bits = 0;
+		for (std::uint64_t e = k; e > 0; e >>= 1) {
+			bits += 1;
+		}
+		return k <= bits * n;
+	}
+
+	}
+
+/*
+m^k by exponentiation by squaring: O(n^3 log k).
+Three matrices (result, square, scratch) are swapped between steps,
+no step allocates. m^0 is the identity. */
+template <typename T, typename A>
+Matrix<T, A> pow(const Matrix<T, A>& m, std::uint64_t k) {
+	assert(m.getHeight() == m.getWidth());
+	const std::size_t n = m.getHeight();
+	Matrix<T, A> result {n, n, m.get_allocator()};
+	for (std::size_t i = 0; i < n; ++i) {
+		result.get(i, i) = T(1);
+	}
+	if (k == 0) {
+		return result;
+	}
+	Matrix<T, A> base {m};
+	Matrix<T, A> scratch {n, n, m.get_allocator()};
+	std::vector<T> workspace;
+	bool first = true;
+	while (true) {
+		if (k & 1) {
+			if (first) {
+				result = base;
+				first = false;
+			} else {
+				Detail::multiplySquare(scratch, result, base, workspace);
+				result.swap(scratch);
+			}
+		}
+		k >>= 1;
+		if (k == 0) {
+			break;
+		}
+		Detail::multiplySquare(scratch, base, base, workspace);
+		base.swap(scratch);
+	}
+	return result;
+}
+
+/*
+m^k mod modulus for integer matrices, modulus <= 2^32.
+Elements are reduced to [0, modulus) first, negative elements included.
+modulus - 1 has to fit in T (2^32 needs std::uint32_t or a 64-bit type). */
+template <typename T, typename A,
+	typename std::enable_if<std::is_integral<T>::value, bool>::type = true>
+Matrix<T, A> pow(const Matrix<T, A>& m, std::uint64_t k, std::uint64_t modulus) {
+	assert(m.getHeight() == m.getWidth());
+	assert(Detail::residuesFit<T>(modulus));
+	const std::size_t n = m.getHeight();
+	const Detail::Modulus mod {modulus};
+	std::vector<std::uint64_t> base = Detail::residues(m, mod);
+	std::vector<std::uint64_t> result(n * n, 0);
+	std::vector<std::uint64_t> scratch(n * n);
+	for (std::size_t i = 0; i < n; ++i) {
+		result[i * n + i] = 1 % modulus;
+	}
+	for (; k > 0; k >>= 1) {
+		if (k & 1) {
+			Detail::multiplyModular(n, result.data(), base.data(), scratch.data(), mod);
+			result.swap(scratch);
+		}
+		if (k > 1) {
+			Detail::multiplyModular(n, base.data(), base.data(), scratch.data(), mod);
+			base.swap(scratch);
+		}
+	}
+	Matrix<T, A> r {n, n, m.get_allocator()};
+	for (std::size_t y = 0; y < n; ++y) {
+		for (std::size_t x = 0; x < n; ++x) {
+			r.get(y, x) = static_cast<T>(result[y * n + x]);
+		}
+	}
+	return r;
+}
+
+/*
+m^k * v without computing m^k when that is cheaper: small k multiplies the vector
+k times (O(k * n^2)), large k squares m and applies the powers of two that make up k
+to the vector (O(n^3 log k), but no product of two full powers is needed). */
+template <typename T, typename A>
+std::vector<T> powVector(const Matrix<T, A>& m, std::uint64_t k, std::vector<T> v) {
+	assert(m.getHeight() == m.getWidth() && m.getWidth() == v.size());
+	const std::size_t n = m.getHeight();
+	std::vector<T> out(n);
+	auto apply = [&](const Matrix<T, A>& a) {
+		for (std::size_t y = 0; y < n; ++y) {
+			const T* row = a.data() + y * a.getStride();
+			T sum = T();
+			for (std::size_t x = 0; x < n; ++x) {
+				sum += row[x] * v[x];
+			}
+			out[y] = sum;
+		}
+		v.swap(out);
+	};
+	if (Detail::repeatVectorProduct(n, k)) {
+		for (; k > 0; --k) {
+			apply(m);
+		}
+		return v;
+	}
+	Matrix<T, A> base {m};
+	Matrix<T, A> scratch {n, n, m.get_allocator()};
+	std::vector<T> workspace;
+	for (; k > 0; k >>= 1) {
+		if (k & 1) {
+			apply(base);
+		}
+		if (k > 1) {
+			Detail::multiplySquare(scratch, base, base, workspace);
+			base.swap(scratch);
+		}
+	}
+	return v;
+}
+
+/*
+m^k * v mod modulus for integer matrices, modulus <= 2^32.
+modulus - 1 has to fit in T (2^32 needs std::uint32_t or a 64-bit type). */
+template <typename T, typename A,
+	typename std::enable_if<std::is_integral<T>::value, bool>::type = true>
+std::vector<T> powVector(const Matrix<T, A>& m, std::uint64_t k, const std::vector<T>& v, std::uint64_t modulus) {
+	assert(m.getHeight() == m.getWidth() && m.getWidth() == v.size());
+	assert(Detail::residuesFit<T>(modulus));
+	const std::size_t n = m.getHeight();
+	const Detail::Modulus mod {modulus};
+	std::vector<std::uint64_t> base = Detail::residues(m, mod);
+	std::vector<std::uint64_t> scratch(n * n);
+	std::vector<std::uint64_t> x(n);
+	std::vector<std::uint64_t> out(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		x[i] = mod.reduce(v[i]);
+	}
+	if (Detail::repeatVectorProduct(n, k)) {
+		for (; k > 0; --k) {
+			Detail::multiplyVectorModular(n, base.data(), x.data(), out.data(), mod);
+			x.swap(out);
+		}
+	} else {
+		for (; k > 0; k >>= 1) {
+			if (k & 1) {
+				Detail::multiplyVectorModular(n, base.data(), x.data(), out.data(), mod);
+				x.swap(out);
+			}
+			if (k > 1) {
+				Detail::multiplyModular(n, base.data(), base.data(), scratch.data(), mod);
+				base.swap(scratch);
+			}
+		}
+	}
+	return std::vector<T>(x.begin(), x.end());
+}
+
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include "matrix.hpp"
+#include <cstddef>
+#include <cstdint>
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <limits>
+#include <algorithm>
+#include <type_traits>
+
+namespace DSA {
+
+	namespace Detail {
+
+	/*
+	Largest magnitude of a quantized value when `depth` products of two of them are summed:
+	depth * limit^2 has to fit in the int32 accumulator, for int16 that caps the limit from k = 3 on */
+	template <typename Q>
+	float quantizationLimit(std::size_t depth) {
+		const double fits = std::floor(std::sqrt(static_cast<double>(std::numeric_limits<std::int32_t>::max())
+												/ std::max<std::size_t>(1, depth)));
+		return static_cast<float>(std::min<double>(std::numeric_limits<Q>::max(), fits));
+	}
+
+	template <typename Q>
+	Q quantizeValue(float value, float inverse_scale, float limit) {
+		return static_cast<Q>(std::max(-limit, std::min(limit, std::round(value * inverse_scale))));
+	}
+
+	}
+
+/*
+Symmetric linear quantization: element (y, x) represents values(y, x) * scale,
+with one scale per row (quantizeRows) or per column (quantizeColumns).
+int8 values lie in [-127, 127], so that negating a value never overflows.
+The limit is lowered further to floor(sqrt((2^31 - 1) / k)), k the width of a row-quantized
+or the height of a column-quantized matrix, so the int32 product of the two cannot overflow. */
+template <typename Q>
+struct QuantizedMatrix {
+	Matrix<Q> values;
+	std::vector<float> scales;
+};
+
+/*
+Scale of a row: its largest magnitude maps to the largest value of Q. O(m * n) */
+template <typename Q, typename E>
+QuantizedMatrix<Q> quantizeRows(const MatrixExpression<E>& e) {
+	static_assert(std::is_integral<Q>::value && std::is_signed<Q>::value, "quantized type must be a signed integer");
+	const E& m = e.derived();
+	QuantizedMatrix<Q> q {Matrix<Q>(m.getHeight(), m.getWidth()), std::vector<float>(m.getHeight(), 1.0f)};
+	const float limit = Detail::quantizationLimit<Q>(m.getWidth());
+	for (std::size_t y = 0; y < m.getHeight(); ++y) {
+		float largest = 0;
+		for (std::size_t x = 0; x < m.getWidth(); ++x) {
+			largest = std::max(largest, std::fabs(static_cast<float>(m.get(y, x))));
+		}
+		if (largest > 0) {
+			q.scales[y] = largest / limit;
+		}
+		const float inverse = 1.0f / q.scales[y];
+		for (std::size_t x = 0; x < m.getWidth(); ++x) {
+			q.values.get(y, x) = Detail::quantizeValue<Q>(m.get(y, x), inverse, limit);
+		}
+	}
+	return q;
+}
+
+template <typename Q, typename E>
+QuantizedMatrix<Q> quantizeColumns(const MatrixExpression<E>& e) {
+	static_assert(std::is_integral<Q>::value && std::is_signed<Q>::value, "quantized type must be a signed integer");
+	const E& m = e.derived();
+	QuantizedMatrix<Q> q {Matrix<Q>(m.getHeight(), m.getWidth()), std::vector<float>(m.getWidth(), 0.0f)};
+	const float limit = Detail::quantizationLimit<Q>(m.getHeight());
+	for (std::size_t y = 0; y < m.getHeight(); ++y) {
+		for (std::size_t x = 0; x < m.getWidth(); ++x) {
+			q.scales[x] = std::max(q.scales[x], std::fabs(static_cast<float>(m.get(y, x))));
+		}
+	}
+	std::vector<float> inverse(m.getWidth());
+	for (std::size_t x = 0; x < m.getWidth(); ++x) {
+		q.scales[x] = q.scales[x] > 0 ? q.scales[x] / limit : 1.0f;
+		inverse[x] = 1.0f / q.scales[x];
+	}
+	for (std::size_t y = 0; y < m.getHeight(); ++y) {
+		for (std::size_t x = 0; x < m.getWidth(); ++x) {
+			q.values.get(y, x) = Detail::quantizeValue<Q>(m.get(y, x), inverse[x], limit);
+		}
+	}
+	return q;
+}
+
+/*
+Row-quantized matrix back to floats */
+template <typename Q>
+Matrix<float> dequantizeRows(const QuantizedMatrix<Q>& q) {
+	Matrix<float> m {q.values.getHeight(), q.values.getWidth()};
+	for (std::size_t y = 0; y < m.getHeight(); ++y) {
+		for (std::size_t x = 0; x < m.getWidth(); ++x) {
+			m.get(y, x) = q.values.get(y, x) * q.scales[y];
+		}
+	}
+	return m;
+}
+
+/*
+c(y, x) = product(y, x) * row_scales[y] * column_scales[x]:
+the int32 product of a row-quantized and a column-quantized matrix back to floats */
+template <typename E>
+Matrix<float> dequantizeProduct(const MatrixExpression<E>& e,
+								const std::vector<float>& row_scales, const std::vector<float>& column_scales) {
+	const E& product = e.derived();
+	assert(row_scales.size() == product.getHeight() && column_scales.size() == product.getWidth());
+	Matrix<float> c {product.getHeight(), product.getWidth()};
+	for (std::size_t y = 0; y < c.getHeight(); ++y) {
+		for (std::size_t x = 0; x < c.getWidth(); ++x) {
+			c.get(y, x) = static_cast<float>(product.get(y, x)) * row_scales[y] * column_scales[x];
+		}
+	}
+	return c;
+}
+
+/*
+Approximate float product: a is quantized per row, b per column, the integer
+product is accumulated exactly in int32 (matrix_multiply.hpp) and scaled back.
+The error grows with k and with the spread of the values within a row of a or a column of b. */
+template <typename Q = std::int8_t, typename L, typename R>
+Matrix<float> quantizedProduct(const MatrixExpression<L>& a, const MatrixExpression<R>& b) {
+	const QuantizedMatrix<Q> qa = quantizeRows<Q>(a);
+	const QuantizedMatrix<Q> qb = quantizeColumns<Q>(b);
+	const Matrix<std::int32_t> product = qa.values * qb.values;
+	return dequantizeProduct(product, qa.scales, qb.scales);
+}
+
+}
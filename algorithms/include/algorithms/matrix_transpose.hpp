@@ -0,0 +1,287 @@
+#pragma once
+
+#include "matrix_expression.hpp"
+#include <cstddef>
+#include <vector>
+#include <utility>
+#include <type_traits>
+
+#if defined(__AVX__)
+# include <immintrin.h>
+#elif defined(__SSE__)
+# include <xmmintrin.h>
+#endif
+
+namespace DSA {
+
+	namespace Detail {
+
+	/*
+	Blocks of at most this edge are transposed directly:
+	a source and a destination block of doubles fit in L1 together */
+	constexpr std::size_t transposeBlockSize() {
+		return 32;
+	}
+
+	/*
+	Raw row-major kernels, same convention as matrix_multiply.hpp:
+	dst (cols x rows) = transpose of src (rows x cols) */
+
+	template <typename T>
+	void transposeScalar(const T* src, std::size_t lds, T* dst, std::size_t ldd,
+						std::size_t rows, std::size_t cols) {
+		for (std::size_t y = 0; y < rows; ++y) {
+			for (std::size_t x = 0; x < cols; ++x) {
+				dst[x * ldd + y] = src[y * lds + x];
+			}
+		}
+	}
+
+	/*
+	Full K x K blocks go through the SIMD kernel, the remaining strips are copied per element */
+	template <std::size_t K, typename T, typename Kernel>
+	void transposeTileSimd(const T* src, std::size_t lds, T* dst, std::size_t ldd,
+							std::size_t rows, std::size_t cols, Kernel kernel) {
+		const std::size_t rows_k = rows - rows % K;
+		const std::size_t cols_k = cols - cols % K;
+		for (std::size_t y = 0; y < rows_k; y += K) {
+			for (std::size_t x = 0; x < cols_k; x += K) {
+				kernel(src + y * lds + x, lds, dst + x * ldd + y, ldd);
+			}
+		}
+		transposeScalar(src + cols_k, lds, dst + cols_k * ldd, ldd, rows, cols - cols_k);
+		transposeScalar(src + rows_k * lds, lds, dst + rows_k, ldd, rows - rows_k, cols_k);
+	}
+
+	template <typename T>
+	void transposeTile(const T* src, std::size_t lds, T* dst, std::size_t ldd,
+						std::size_t rows, std::size_t cols) {
+		transposeScalar(src, lds, dst, ldd, rows, cols);
+	}
+
+#if defined(__AVX__)
+
+	inline void transpose8x8(const float* src, std::size_t lds, float* dst, std::size_t ldd) {
+		__m256 r0 = _mm256_loadu_ps(src + 0 * lds);
+		__m256 r1 = _mm256_loadu_ps(src + 1 * lds);
+		__m256 r2 = _mm256_loadu_ps(src + 2 * lds);
+		__m256 r3 = _mm256_loadu_ps(src + 3 * lds);
+		__m256 r4 = _mm256_loadu_ps(src + 4 * lds);
+		__m256 r5 = _mm256_loadu_ps(src + 5 * lds);
+		__m256 r6 = _mm256_loadu_ps(src + 6 * lds);
+		__m256 r7 = _mm256_loadu_ps(src + 7 * lds);
+		// interleave pairs of rows
+		__m256 t0 = _mm256_unpacklo_ps(r0, r1);
+		__m256 t1 = _mm256_unpackhi_ps(r0, r1);
+		__m256 t2 = _mm256_unpacklo_ps(r2, r3);
+		__m256 t3 = _mm256_unpackhi_ps(r2, r3);
+		__m256 t4 = _mm256_unpacklo_ps(r4, r5);
+		__m256 t5 = _mm256_unpackhi_ps(r4, r5);
+		__m256 t6 = _mm256_unpacklo_ps(r6, r7);
+		__m256 t7 = _mm256_unpackhi_ps(r6, r7);
+		// 4x4 transposes within each 128-bit lane
+		r0 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(1, 0, 1, 0));
+		r1 = _mm256_shuffle_ps(t0, t2, _MM_SHUFFLE(3, 2, 3, 2));
+		r2 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(1, 0, 1, 0));
+		r3 = _mm256_shuffle_ps(t1, t3, _MM_SHUFFLE(3, 2, 3, 2));
+		r4 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(1, 0, 1, 0));
+		r5 = _mm256_shuffle_ps(t4, t6, _MM_SHUFFLE(3, 2, 3, 2));
+		r6 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(1, 0, 1, 0));
+		r7 = _mm256_shuffle_ps(t5, t7, _MM_SHUFFLE(3, 2, 3, 2));
+		// swap the off-diagonal lanes
+		_mm256_storeu_ps(dst + 0 * ldd, _mm256_permute2f128_ps(r0, r4, 0x20));
+		_mm256_storeu_ps(dst + 1 * ldd, _mm256_permute2f128_ps(r1, r5, 0x20));
+		_mm256_storeu_ps(dst + 2 * ldd, _mm256_permute2f128_ps(r2, r6, 0x20));
+		_mm256_storeu_ps(dst + 3 * ldd, _mm256_permute2f128_ps(r3, r7, 0x20));
+		_mm256_storeu_ps(dst + 4 * ldd, _mm256_permute2f128_ps(r0, r4, 0x31));
+		_mm256_storeu_ps(dst + 5 * ldd, _mm256_permute2f128_ps(r1, r5, 0x31));
+		_mm256_storeu_ps(dst + 6 * ldd, _mm256_permute2f128_ps(r2, r6, 0x31));
+		_mm256_storeu_ps(dst + 7 * ldd, _mm256_permute2f128_ps(r3, r7, 0x31));
+	}
+
+	inline void transpose4x4(const double* src, std::size_t lds, double* dst, std::size_t ldd) {
+		__m256d r0 = _mm256_loadu_pd(src + 0 * lds);
+		__m256d r1 = _mm256_loadu_pd(src + 1 * lds);
+		__m256d r2 = _mm256_loadu_pd(src + 2 * lds);
+		__m256d r3 = _mm256_loadu_pd(src + 3 * lds);
+		__m256d t0 = _mm256_unpacklo_pd(r0, r1);
+		__m256d t1 = _mm256_unpackhi_pd(r0, r1);
+		__m256d t2 = _mm256_unpacklo_pd(r2, r3);
+		__m256d t3 = _mm256_unpackhi_pd(r2, r3);
+		_mm256_storeu_pd(dst + 0 * ldd, _mm256_permute2f128_pd(t0, t2, 0x20));
+		_mm256_storeu_pd(dst + 1 * ldd, _mm256_permute2f128_pd(t1, t3, 0x20));
+		_mm256_storeu_pd(dst + 2 * ldd, _mm256_permute2f128_pd(t0, t2, 0x31));
+		_mm256_storeu_pd(dst + 3 * ldd, _mm256_permute2f128_pd(t1, t3, 0x31));
+	}
+
+	inline void transposeTile(const float* src, std::size_t lds, float* dst, std::size_t ldd,
+							std::size_t rows, std::size_t cols) {
+		transposeTileSimd<8>(src, lds, dst, ldd, rows, cols, transpose8x8);
+	}
+
+	inline void transposeTile(const double* src, std::size_t lds, double* dst, std::size_t ldd,
+							std::size_t rows, std::size_t cols) {
+		transposeTileSimd<4>(src, lds, dst, ldd, rows, cols, transpose4x4);
+	}
+
+#elif defined(__SSE__)
+
+	inline void transpose4x4(const float* src, std::size_t lds, float* dst, std::size_t ldd) {
+		__m128 r0 = _mm_loadu_ps(src + 0 * lds);
+		__m128 r1 = _mm_loadu_ps(src + 1 * lds);
+		__m128 r2 = _mm_loadu_ps(src + 2 * lds);
+		__m128 r3 = _mm_loadu_ps(src + 3 * lds);
+		_MM_TRANSPOSE4_PS(r0, r1, r2, r3);
+		_mm_storeu_ps(dst + 0 * ldd, r0);
+		_mm_storeu_ps(dst + 1 * ldd, r1);
+		_mm_storeu_ps(dst + 2 * ldd, r2);
+		_mm_storeu_ps(dst + 3 * ldd, r3);
+	}
+
+	inline void transposeTile(const float* src, std::size_t lds, float* dst, std::size_t ldd,
+							std::size_t rows, std::size_t cols) {
+		transposeTileSimd<4>(src, lds, dst, ldd, rows, cols, transpose4x4);
+	}
+
+#endif
+
+	/*
+	Cache-oblivious out-of-place transpose: the longer dimension is halved until
+	the block fits in cache (whatever its size), then the block is transposed directly.
+	O(rows * cols) time, O(rows * cols / B) cache misses for cache lines of B elements.
+	src and dst must not overlap. */
+	template <typename T>
+	void transposeRecursive(const T* src, std::size_t lds, T* dst, std::size_t ldd,
+							std::size_t rows, std::size_t cols) {
+		const std::size_t block = transposeBlockSize();
+		if (rows <= block && cols <= block) {
+			transposeTile(src, lds, dst, ldd, rows, cols);
+		} else if (rows >= cols) {
+			const std::size_t h = rows / 2;
+			transposeRecursive(src, lds, dst, ldd, h, cols);
+			transposeRecursive(src + h * lds, lds, dst + h, ldd, rows - h, cols);
+		} else {
+			const std::size_t w = cols / 2;
+			transposeRecursive(src, lds, dst, ldd, rows, w);
+			transposeRecursive(src + w, lds, dst + w * ldd, ldd, rows, cols - w);
+		}
+	}
+
+	/*
+	Swaps block a (rows x cols) with the transpose of block b (cols x rows): a(y, x) <-> b(x, y),
+	recursing like transposeRecursive */
+	template <typename T>
+	void transposeSwap(T* a, T* b, std::size_t ld, std::size_t rows, std::size_t cols) {
+		const std::size_t block = transposeBlockSize();
+		if (rows <= block && cols <= block) {
+			for (std::size_t y = 0; y < rows; ++y) {
+				for (std::size_t x = 0; x < cols; ++x) {
+					std::swap(a[y * ld + x], b[x * ld + y]);
+				}
+			}
+		} else if (rows >= cols) {
+			const std::size_t h = rows / 2;
+			transposeSwap(a, b, ld, h, cols);
+			transposeSwap(a + h * ld, b + h, ld, rows - h, cols);
+		} else {
+			const std::size_t w = cols / 2;
+			transposeSwap(a, b, ld, rows, w);
+			transposeSwap(a + w, b + w * ld, ld, rows, cols - w);
+		}
+	}
+
+	/*
+	In-place transpose of an n x n block: the diagonal quadrants are transposed
+	recursively, the off-diagonal quadrants are swapped with each other's transpose */
+	template <typename T>
+	void transposeSquareInPlace(T* a, std::size_t ld, std::size_t n) {
+		if (n <= transposeBlockSize()) {
+			for (std::size_t y = 0; y < n; ++y) {
+				for (std::size_t x = y + 1; x < n; ++x) {
+					std::swap(a[y * ld + x], a[x * ld + y]);
+				}
+			}
+			return;
+		}
+		const std::size_t h = n / 2;
+		transposeSquareInPlace(a, ld, h);
+		transposeSquareInPlace(a + h * ld + h, ld, n - h);
+		transposeSwap(a + h, a + h * ld, ld, h, n - h);
+	}
+
+	/*
+	In-place transpose of a contiguous rows x cols matrix by cycle-following:
+	the element at index i = y * cols + x moves to x * rows + y.
+	Every permutation cycle is rotated once, the visited set takes one bit per element.
+	O(rows * cols) time */
+	template <typename T>
+	void transposeCycles(T* a, std::size_t rows, std::size_t cols) {
+		const std::size_t n = rows * cols;
+		if (rows <= 1 || cols <= 1) {
+			return;
+		}
+		std::vector<bool> visited(n, false);
+		// the first and the last element never move
+		for (std::size_t start = 1; start + 1 < n; ++start) {
+			if (visited[start]) {
+				continue;
+			}
+			T carried = std::move(a[start]);
+			std::size_t i = start;
+			do {
+				const std::size_t next = (i % cols) * rows + i / cols;
+				std::swap(carried, a[next]);
+				visited[next] = true;
+				i = next;
+			} while (i != start);
+		}
+	}
+
+	/*
+	dest = s * transpose(src): dense operands with contiguous rows use the blocked kernel */
+	template <typename Dest, typename Source>
+	void transposeKernel(Dest& dest, const Source& src, const typename Dest::value_type& s, std::false_type) {
+		using size_type = typename Dest::size_type;
+		for (size_type y = 0; y < dest.getHeight(); ++y) {
+			for (size_type x = 0; x < dest.getWidth(); ++x) {
+				dest.get(y, x) = s * src.get(x, y);
+			}
+		}
+	}
+
+	template <typename Dest, typename Source>
+	void transposeKernel(Dest& dest, const Source& src, const typename Dest::value_type& s, std::true_type) {
+		using value_type = typename Dest::value_type;
+		if (dest.getColumnStride() != 1 || src.getColumnStride() != 1) {
+			transposeKernel(dest, src, s, std::false_type());
+			return;
+		}
+		transposeRecursive(src.data(), src.getStride(), dest.data(), dest.getStride(),
+							src.getHeight(), src.getWidth());
+		if (s != value_type(1)) {
+			for (std::size_t y = 0; y < dest.getHeight(); ++y) {
+				value_type* row = dest.data() + y * dest.getStride();
+				for (std::size_t x = 0; x < dest.getWidth(); ++x) {
+					row[x] *= s;
+				}
+			}
+		}
+	}
+
+	/*
+	An operand containing a product is evaluated once, then transposed like a matrix */
+	template <typename Dest, typename E>
+	void assign(Dest& dest, const TransposeExpression<E>& e, const typename Dest::value_type& s) {
+		using value_type = typename Dest::value_type;
+		typename ProductOperand<E>::type src = e.expression();
+		using Source = typename std::decay<decltype(src)>::type;
+		using dense = std::integral_constant<bool,
+			IsDense<Dest>::value && IsDense<Source>::value
+			&& std::is_same<value_type, typename Source::value_type>::value>;
+		assert(dest.getHeight() == src.getWidth() && dest.getWidth() == src.getHeight());
+		transposeKernel(dest, src, s, dense());
+	}
+
+	}
+
+}
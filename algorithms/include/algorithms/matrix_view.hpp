@@ -0,0 +1,200 @@
+#pragma once
+
+#include "matrix_expression.hpp"
+#include <cstddef>
+#include <cassert>
+#include <algorithm>
+#include <type_traits>
+
+namespace DSA {
+
+/*
+Non-owning view on matrix elements: element (y, x) is data[y * row_stride + x * column_stride].
+Views are cheap to copy and are never invalidated by other views, only by the storage they refer to.
+
+Assigning to a view writes the elements it refers to, copying a view (construction) does not.
+MatrixView<const T> (ConstMatrixView<T>) is read-only. */
+template <typename T>
+class MatrixView : public MatrixExpression<MatrixView<T>> {
+public:
+	using size_type = std::size_t;
+	using value_type = typename std::remove_const<T>::type;
+	using pointer = T*;
+	using reference = T&;
+
+	static constexpr bool is_elementwise = true;
+	// Two views on the same storage may index it differently
+	static constexpr bool is_alias_safe = false;
+
+public:
+	MatrixView()
+	: ptr(nullptr), height(0), width(0), row_stride(0), column_stride(1) {}
+
+	/*
+	Adopts an external row-major buffer, the buffer is not owned (e.g. mmapped data) */
+	MatrixView(pointer data, size_type rows, size_type columns)
+	: MatrixView(data, rows, columns, columns, 1) {}
+
+	MatrixView(pointer data, size_type rows, size_type columns,
+				size_type row_stride, size_type column_stride = 1)
+	: ptr(data), height(rows), width(columns),
+	row_stride(row_stride), column_stride(column_stride) {}
+
+	MatrixView(const MatrixView& other) = default;
+
+	/*
+	MatrixView<T> to MatrixView<const T> */
+	template <typename U,
+		typename std::enable_if<std::is_convertible<U*, T*>::value, bool>::type = true>
+	MatrixView(const MatrixView<U>& other)
+	: ptr(other.data()), height(other.getHeight()), width(other.getWidth()),
+	row_stride(other.getStride()), column_stride(other.getColumnStride()) {}
+
+	~MatrixView() {}
+
+	MatrixView& operator=(const MatrixView& rhs) {
+		return assign(rhs);
+	}
+
+	template <typename E>
+	MatrixView& operator=(const MatrixExpression<E>& e) {
+		return assign(e.derived());
+	}
+
+	template <typename E>
+	MatrixView& operator+=(const MatrixExpression<E>& e) {
+		return accumulate(e.derived(), value_type(1));
+	}
+
+	template <typename E>
+	MatrixView& operator-=(const MatrixExpression<E>& e) {
+		return accumulate(e.derived(), value_type(-1));
+	}
+
+	MatrixView& operator*=(const value_type& scalar) {
+		for (size_type y = 0; y < height; ++y) {
+			for (size_type x = 0; x < width; ++x) {
+				get(y, x) *= scalar;
+			}
+		}
+		return *this;
+	}
+
+	void fill(const value_type& value) {
+		for (size_type y = 0; y < height; ++y) {
+			for (size_type x = 0; x < width; ++x) {
+				get(y, x) = value;
+			}
+		}
+	}
+
+	reference get(size_type y, size_type x) const {
+		return ptr[y * row_stride + x * column_stride];
+	}
+
+	size_type getHeight() const {
+		return height;
+	}
+
+	size_type getWidth() const {
+		return width;
+	}
+
+	size_type getStride() const {
+		return row_stride;
+	}
+
+	size_type getColumnStride() const {
+		return column_stride;
+	}
+
+	pointer data() const {
+		return ptr;
+	}
+
+/*
+Slicing: O(1), no element is copied */
+
+	MatrixView submatrix(size_type y, size_type x, size_type rows, size_type columns) const {
+		assert(y + rows <= height && x + columns <= width);
+		return MatrixView(ptr + y * row_stride + x * column_stride,
+						rows, columns, row_stride, column_stride);
+	}
+
+	MatrixView row(size_type y) const {
+		return submatrix(y, 0, 1, width);
+	}
+
+	MatrixView column(size_type x) const {
+		return submatrix(0, x, height, 1);
+	}
+
+	MatrixView transposed() const {
+		return MatrixView(ptr, width, height, column_stride, row_stride);
+	}
+
+	bool aliases(const void* first, const void* last) const {
+		return Detail::overlaps(storageBegin(), storageEnd(), first, last);
+	}
+
+private:
+	const value_type* storageBegin() const {
+		return ptr;
+	}
+
+	/*
+	One past the last element the view can reach */
+	const value_type* storageEnd() const {
+		if (height == 0 || width == 0) {
+			return ptr;
+		}
+		return ptr + (height - 1) * row_stride + (width - 1) * column_stride + 1;
+	}
+
+	/*
+	is_alias_safe assumes the destination indexes the storage like the expression does,
+	a view may walk it in another order (transposed(), shifted submatrices):
+	any overlap goes through a temporary */
+	template <typename E>
+	MatrixView& assign(const E& expr) {
+		assert(expr.getHeight() == height && expr.getWidth() == width);
+		if (expr.aliases(storageBegin(), storageEnd())) {
+			Matrix<value_type> tmp {expr};
+			Detail::assign(*this, tmp, value_type(1));
+		} else {
+			Detail::assign(*this, expr, value_type(1));
+		}
+		return *this;
+	}
+
+	template <typename E>
+	MatrixView& accumulate(const E& expr, const value_type& s) {
+		assert(expr.getHeight() == height && expr.getWidth() == width);
+		if (expr.aliases(storageBegin(), storageEnd())) {
+			Matrix<value_type> tmp {expr};
+			Detail::accumulate(*this, tmp, s);
+		} else {
+			Detail::accumulate(*this, expr, s);
+		}
+		return *this;
+	}
+
+private:
+	pointer ptr;
+	size_type height;
+	size_type width;
+	size_type row_stride;
+	size_type column_stride;
+};
+
+template <typename T>
+using ConstMatrixView = MatrixView<const T>;
+
+	namespace Detail {
+
+	template <typename T>
+	struct IsDense<MatrixView<T>> : std::true_type {};
+
+	}
+
+}
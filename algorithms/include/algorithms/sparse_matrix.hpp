@@ -0,0 +1,511 @@
+#pragma once
+
+#include "matrix.hpp"
+#include <cstddef>
+#include <cassert>
+#include <vector>
+#include <thread>
+#include <functional>
+#include <algorithm>
+
+namespace DSA {
+
+/*
+Sparse matrices: only the non-zero elements are stored.
+
+CooMatrix: list of (row, column, value) triplets, for construction
+CsrMatrix: compressed sparse rows, for row oriented compute (SpMV, SpGEMM)
+CscMatrix: compressed sparse columns, for column oriented compute
+
+Compressed formats keep the indices of every row (column) sorted and unique. */
+
+template <typename T>
+class CsrMatrix;
+
+template <typename T>
+class CscMatrix;
+
+template <typename T>
+class CooMatrix {
+public:
+	using size_type = std::size_t;
+	using value_type = T;
+
+	struct Entry {
+		size_type row;
+		size_type column;
+		value_type value;
+	};
+
+public:
+	CooMatrix(size_type rows, size_type columns)
+	: height(rows), width(columns) {}
+
+	/*
+	Duplicate positions are summed when the matrix is compressed */
+	void insert(size_type y, size_type x, const T& value) {
+		assert(y < height && x < width);
+		entries.push_back(Entry {y, x, value});
+	}
+
+	void reserve(size_type n) {
+		entries.reserve(n);
+	}
+
+	size_type nonZeros() const {
+		return entries.size();
+	}
+
+	size_type getHeight() const {
+		return height;
+	}
+
+	size_type getWidth() const {
+		return width;
+	}
+
+	const std::vector<Entry>& getEntries() const {
+		return entries;
+	}
+
+private:
+	size_type height;
+	size_type width;
+	std::vector<Entry> entries;
+};
+
+	namespace Detail {
+
+	/*
+	Compressed storage shared by CSR (major = row) and CSC (major = column):
+	the non-zeros of major index i are at [offsets[i], offsets[i + 1]) of indices and values */
+	template <typename T>
+	struct CompressedStorage {
+		using size_type = std::size_t;
+
+		std::vector<size_type> offsets;
+		std::vector<size_type> indices;
+		std::vector<T> values;
+
+		explicit CompressedStorage(size_type majors = 0)
+		: offsets(majors + 1, 0) {}
+
+		size_type majors() const {
+			return offsets.size() - 1;
+		}
+
+		/*
+		Binary search in the sorted indices of one major, nullptr if the element is zero */
+		const T* find(size_type major, size_type minor) const {
+			auto first = indices.begin() + offsets[major];
+			auto last = indices.begin() + offsets[major + 1];
+			auto it = std::lower_bound(first, last, minor);
+			if (it == last || *it != minor) {
+				return nullptr;
+			}
+			return &values[it - indices.begin()];
+		}
+
+		/*
+		The same matrix in the other orientation, with minor_count majors.
+		Counting sort: O(nnz + majors + minors), indices come out sorted. */
+		CompressedStorage transpose(size_type minor_count) const {
+			CompressedStorage out {minor_count};
+			for (size_type index : indices) {
+				out.offsets[index + 1] += 1;
+			}
+			for (size_type i = 0; i < minor_count; ++i) {
+				out.offsets[i + 1] += out.offsets[i];
+			}
+			out.indices.resize(indices.size());
+			out.values.resize(values.size());
+			std::vector<size_type> next(out.offsets.begin(), out.offsets.end() - 1);
+			for (size_type major = 0; major < majors(); ++major) {
+				for (size_type k = offsets[major]; k < offsets[major + 1]; ++k) {
+					size_type position = next[indices[k]]++;
+					out.indices[position] = major;
+					out.values[position] = values[k];
+				}
+			}
+			return out;
+		}
+
+		/*
+		Removes duplicate indices of a sorted storage by summing their values */
+		void sumDuplicates() {
+			size_type write = 0;
+			size_type first = 0;
+			for (size_type major = 0; major < majors(); ++major) {
+				const size_type last = offsets[major + 1];
+				const size_type row_start = write;
+				for (size_type k = first; k < last; ++k) {
+					if (write > row_start && indices[write - 1] == indices[k]) {
+						values[write - 1] += values[k];
+					} else {
+						indices[write] = indices[k];
+						values[write] = values[k];
+						++write;
+					}
+				}
+				first = last;
+				offsets[major + 1] = write;
+			}
+			indices.resize(write);
+			values.resize(write);
+		}
+	};
+
+	/*
+	Compresses triplets on their minor key, then transposes to the requested orientation:
+	two counting sorts leave every major with sorted indices. O(nnz + rows + columns) */
+	template <typename T>
+	CompressedStorage<T> compressTriplets(const CooMatrix<T>& coo, bool row_major) {
+		using size_type = std::size_t;
+		const size_type minors = row_major ? coo.getWidth() : coo.getHeight();
+		const size_type majors = row_major ? coo.getHeight() : coo.getWidth();
+		CompressedStorage<T> by_minor {minors};
+		for (const auto& entry : coo.getEntries()) {
+			by_minor.offsets[(row_major ? entry.column : entry.row) + 1] += 1;
+		}
+		for (size_type i = 0; i < minors; ++i) {
+			by_minor.offsets[i + 1] += by_minor.offsets[i];
+		}
+		by_minor.indices.resize(coo.nonZeros());
+		by_minor.values.resize(coo.nonZeros());
+		std::vector<size_type> next(by_minor.offsets.begin(), by_minor.offsets.end() - 1);
+		for (const auto& entry : coo.getEntries()) {
+			size_type position = next[row_major ? entry.column : entry.row]++;
+			by_minor.indices[position] = row_major ? entry.row : entry.column;
+			by_minor.values[position] = entry.value;
+		}
+		CompressedStorage<T> out = by_minor.transpose(majors);
+		out.sumDuplicates();
+		return out;
+	}
+
+	template <typename E>
+	CompressedStorage<typename E::value_type> compressDense(const E& m, bool row_major) {
+		using size_type = std::size_t;
+		using value_type = typename E::value_type;
+		const size_type majors = row_major ? m.getHeight() : m.getWidth();
+		const size_type minors = row_major ? m.getWidth() : m.getHeight();
+		CompressedStorage<value_type> out {majors};
+		for (size_type major = 0; major < majors; ++major) {
+			for (size_type minor = 0; minor < minors; ++minor) {
+				value_type value = row_major ? m.get(major, minor) : m.get(minor, major);
+				if (value != value_type()) {
+					out.indices.push_back(minor);
+					out.values.push_back(value);
+				}
+			}
+			out.offsets[major + 1] = out.indices.size();
+		}
+		return out;
+	}
+
+	/*
+	Splits the rows of a CSR matrix in `parts` contiguous ranges with about nnz / parts
+	non-zeros each, so that a few heavy rows do not end up in the same range.
+	Range i is [bounds[i], bounds[i + 1]) */
+	inline std::vector<std::size_t> partitionByNonZeros(const std::vector<std::size_t>& offsets,
+														std::size_t parts) {
+		const std::size_t rows = offsets.size() - 1;
+		const std::size_t nnz = offsets.back();
+		std::vector<std::size_t> bounds(parts + 1, rows);
+		bounds[0] = 0;
+		for (std::size_t i = 1; i < parts; ++i) {
+			const std::size_t target = nnz / parts * i + nnz % parts * i / parts;
+			std::size_t row = std::lower_bound(offsets.begin(), offsets.end(), target) - offsets.begin();
+			bounds[i] = std::max(bounds[i - 1], std::min(row, rows));
+		}
+		return bounds;
+	}
+
+	}
+
+template <typename T>
+class CsrMatrix {
+public:
+	using size_type = std::size_t;
+	using value_type = T;
+
+public:
+	CsrMatrix(size_type rows, size_type columns)
+	: height(rows), width(columns), storage(rows) {}
+
+	explicit CsrMatrix(const CooMatrix<T>& coo)
+	: height(coo.getHeight()), width(coo.getWidth()),
+	storage(Detail::compressTriplets(coo, true)) {}
+
+	template <typename E>
+	explicit CsrMatrix(const MatrixExpression<E>& e)
+	: height(e.derived().getHeight()), width(e.derived().getWidth()),
+	storage(Detail::compressDense(e.derived(), true)) {}
+
+	/*
+	Adopts already compressed arrays: offsets has rows + 1 elements,
+	the column indices of every row are sorted and unique */
+	CsrMatrix(size_type rows, size_type columns, std::vector<size_type>&& offsets,
+			std::vector<size_type>&& indices, std::vector<T>&& values)
+	: height(rows), width(columns) {
+		assert(offsets.size() == rows + 1 && indices.size() == values.size());
+		storage.offsets = std::move(offsets);
+		storage.indices = std::move(indices);
+		storage.values = std::move(values);
+	}
+
+	/*
+	O(log(nnz in row y)) */
+	T get(size_type y, size_type x) const {
+		const T* value = storage.find(y, x);
+		return value ? *value : T();
+	}
+
+	size_type getHeight() const {
+		return height;
+	}
+
+	size_type getWidth() const {
+		return width;
+	}
+
+	size_type nonZeros() const {
+		return storage.values.size();
+	}
+
+	const std::vector<size_type>& rowOffsets() const {
+		return storage.offsets;
+	}
+
+	const std::vector<size_type>& columnIndices() const {
+		return storage.indices;
+	}
+
+	const std::vector<T>& values() const {
+		return storage.values;
+	}
+
+	Matrix<T> toDense() const {
+		Matrix<T> m {height, width};
+		for (size_type y = 0; y < height; ++y) {
+			for (size_type k = storage.offsets[y]; k < storage.offsets[y + 1]; ++k) {
+				m.get(y, storage.indices[k]) = storage.values[k];
+			}
+		}
+		return m;
+	}
+
+	CscMatrix<T> toCsc() const {
+		return CscMatrix<T>(height, width, storage.transpose(width));
+	}
+
+private:
+	friend class CscMatrix<T>;
+
+	CsrMatrix(size_type rows, size_type columns, Detail::CompressedStorage<T>&& s)
+	: height(rows), width(columns), storage(std::move(s)) {}
+
+private:
+	size_type height;
+	size_type width;
+	Detail::CompressedStorage<T> storage;
+};
+
+template <typename T>
+class CscMatrix {
+public:
+	using size_type = std::size_t;
+	using value_type = T;
+
+public:
+	CscMatrix(size_type rows, size_type columns)
+	: height(rows), width(columns), storage(columns) {}
+
+	explicit CscMatrix(const CooMatrix<T>& coo)
+	: height(coo.getHeight()), width(coo.getWidth()),
+	storage(Detail::compressTriplets(coo, false)) {}
+
+	template <typename E>
+	explicit CscMatrix(const MatrixExpression<E>& e)
+	: height(e.derived().getHeight()), width(e.derived().getWidth()),
+	storage(Detail::compressDense(e.derived(), false)) {}
+
+	/*
+	O(log(nnz in column x)) */
+	T get(size_type y, size_type x) const {
+		const T* value = storage.find(x, y);
+		return value ? *value : T();
+	}
+
+	size_type getHeight() const {
+		return height;
+	}
+
+	size_type getWidth() const {
+		return width;
+	}
+
+	size_type nonZeros() const {
+		return storage.values.size();
+	}
+
+	const std::vector<size_type>& columnOffsets() const {
+		return storage.offsets;
+	}
+
+	const std::vector<size_type>& rowIndices() const {
+		return storage.indices;
+	}
+
+	const std::vector<T>& values() const {
+		return storage.values;
+	}
+
+	Matrix<T> toDense() const {
+		Matrix<T> m {height, width};
+		for (size_type x = 0; x < width; ++x) {
+			for (size_type k = storage.offsets[x]; k < storage.offsets[x + 1]; ++k) {
+				m.get(storage.indices[k], x) = storage.values[k];
+			}
+		}
+		return m;
+	}
+
+	CsrMatrix<T> toCsr() const {
+		return CsrMatrix<T>(height, width, storage.transpose(height));
+	}
+
+private:
+	friend class CsrMatrix<T>;
+
+	CscMatrix(size_type rows, size_type columns, Detail::CompressedStorage<T>&& s)
+	: height(rows), width(columns), storage(std::move(s)) {}
+
+private:
+	size_type height;
+	size_type width;
+	Detail::CompressedStorage<T> storage;
+};
+
+	namespace Detail {
+
+	/*
+	Fewest non-zeros worth a thread of their own in SpMV: spawning and joining a thread
+	costs about 15us here, the time of some 3k to 15k non-zeros */
+	constexpr std::size_t spmvNonZerosPerThread() {
+		return 1 << 15;
+	}
+
+	template <typename T>
+	void sparseMatrixVectorRows(const CsrMatrix<T>& a, const T* x, T* y,
+								std::size_t first, std::size_t last) {
+		const auto& offsets = a.rowOffsets();
+		const auto& indices = a.columnIndices();
+		const auto& values = a.values();
+		for (std::size_t row = first; row < last; ++row) {
+			T sum = T();
+			for (std::size_t k = offsets[row]; k < offsets[row + 1]; ++k) {
+				sum += values[k] * x[indices[k]];
+			}
+			y[row] = sum;
+		}
+	}
+
+	}
+
+/*
+y = A * x (SpMV), O(nnz)
+The rows are partitioned over `threads` threads by non-zero count, not by row count:
+power-law matrices have a few rows that hold most of the non-zeros.
+Threads are started on every call, so at most one is used per spmvNonZerosPerThread() non-zeros
+and small products (the common case in iterative solvers) stay on the calling thread.
+Scaling with the thread count is unverified: it was only benchmarked on a single core. */
+template <typename T>
+void sparseMatrixVector(const CsrMatrix<T>& a, const std::vector<T>& x, std::vector<T>& y,
+						unsigned threads = std::thread::hardware_concurrency()) {
+	assert(x.size() == a.getWidth());
+	y.resize(a.getHeight());
+	const std::size_t useful = a.nonZeros() / Detail::spmvNonZerosPerThread();
+	threads = static_cast<unsigned>(std::max<std::size_t>(1, std::min<std::size_t>(threads, useful)));
+	if (threads == 1) {
+		Detail::sparseMatrixVectorRows(a, x.data(), y.data(), 0, a.getHeight());
+		return;
+	}
+	std::vector<std::size_t> bounds = Detail::partitionByNonZeros(a.rowOffsets(), threads);
+	std::vector<std::thread> workers;
+	workers.reserve(threads - 1);
+	for (unsigned i = 1; i < threads; ++i) {
+		workers.emplace_back(&Detail::sparseMatrixVectorRows<T>, std::cref(a),
+							x.data(), y.data(), bounds[i], bounds[i + 1]);
+	}
+	Detail::sparseMatrixVectorRows(a, x.data(), y.data(), bounds[0], bounds[1]);
+	for (auto& worker : workers) {
+		worker.join();
+	}
+}
+
+/*
+y = A * x with column storage: every column scatters into y, O(nnz) */
+template <typename T>
+void sparseMatrixVector(const CscMatrix<T>& a, const std::vector<T>& x, std::vector<T>& y) {
+	assert(x.size() == a.getWidth());
+	y.assign(a.getHeight(), T());
+	const auto& offsets = a.columnOffsets();
+	const auto& indices = a.rowIndices();
+	const auto& values = a.values();
+	for (std::size_t column = 0; column < a.getWidth(); ++column) {
+		for (std::size_t k = offsets[column]; k < offsets[column + 1]; ++k) {
+			y[indices[k]] += values[k] * x[column];
+		}
+	}
+}
+
+/*
+C = A * B (SpGEMM), Gustavson's row-by-row algorithm:
+row i of C is the sum of the rows k of B scaled by A(i, k), gathered in a dense
+accumulator of B.getWidth() elements. A marker array records which columns of the
+accumulator are in use so it never has to be cleared.
+O(flops + nnz(C) log(nnz per row)) */
+template <typename T>
+CsrMatrix<T> sparseMatrixProduct(const CsrMatrix<T>& a, const CsrMatrix<T>& b) {
+	using size_type = std::size_t;
+	assert(a.getWidth() == b.getHeight());
+	const size_type none = static_cast<size_type>(-1);
+	std::vector<T> accumulator(b.getWidth());
+	std::vector<size_type> marker(b.getWidth(), none);
+	std::vector<size_type> offsets(a.getHeight() + 1, 0);
+	std::vector<size_type> indices;
+	std::vector<T> values;
+
+	const auto& a_offsets = a.rowOffsets();
+	const auto& a_indices = a.columnIndices();
+	const auto& a_values = a.values();
+	const auto& b_offsets = b.rowOffsets();
+	const auto& b_indices = b.columnIndices();
+	const auto& b_values = b.values();
+	for (size_type row = 0; row < a.getHeight(); ++row) {
+		const size_type row_start = indices.size();
+		for (size_type ka = a_offsets[row]; ka < a_offsets[row + 1]; ++ka) {
+			const size_type k = a_indices[ka];
+			const T factor = a_values[ka];
+			for (size_type kb = b_offsets[k]; kb < b_offsets[k + 1]; ++kb) {
+				const size_type column = b_indices[kb];
+				if (marker[column] != row) {
+					marker[column] = row;
+					accumulator[column] = T();
+					indices.push_back(column);
+				}
+				accumulator[column] += factor * b_values[kb];
+			}
+		}
+		std::sort(indices.begin() + row_start, indices.end());
+		for (size_type k = row_start; k < indices.size(); ++k) {
+			values.push_back(accumulator[indices[k]]);
+		}
+		offsets[row + 1] = indices.size();
+	}
+	return CsrMatrix<T>(a.getHeight(), b.getWidth(), std::move(offsets),
+						std::move(indices), std::move(values));
+}
+
+}
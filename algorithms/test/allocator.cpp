@@ -0,0 +1,57 @@
+#include "algorithms/allocator.hpp"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <vector>
+
+TEST_CASE("aligned allocator", "[allocator]") {
+	std::vector<char, DSA::AlignedAllocator<char>> v;
+	for (int i = 0; i < 100; ++i) {
+		v.push_back(static_cast<char>(i));
+		REQUIRE(reinterpret_cast<std::uintptr_t>(v.data()) % 64 == 0);
+	}
+	std::vector<double, DSA::AlignedAllocator<double, 256>> w(10, 1.5);
+	REQUIRE(reinterpret_cast<std::uintptr_t>(w.data()) % 256 == 0);
+	REQUIRE(w[9] == 1.5);
+}
+
+TEST_CASE("arena", "[allocator]") {
+	DSA::Arena arena {1024};
+	void* a = arena.allocate(100, 64);
+	void* b = arena.allocate(10, 8);
+	REQUIRE(reinterpret_cast<std::uintptr_t>(a) % 64 == 0);
+	REQUIRE(static_cast<char*>(b) == static_cast<char*>(a) + 104);
+
+	// stack order: the last allocation is reclaimed
+	arena.deallocate(b, 10);
+	void* c = arena.allocate(10, 8);
+	REQUIRE(c == b);
+
+	// larger than a block
+	void* big = arena.allocate(5000, 64);
+	REQUIRE(reinterpret_cast<std::uintptr_t>(big) % 64 == 0);
+	REQUIRE(arena.blockCount() == 2);
+
+	arena.reset();
+	REQUIRE(arena.allocate(100, 64) == a);
+	REQUIRE(arena.blockCount() == 2);
+	REQUIRE(arena.capacity() == 1024 + 5000);
+	arena.release();
+	REQUIRE(arena.blockCount() == 0);
+}
+
+TEST_CASE("arena allocator", "[allocator]") {
+	DSA::Arena arena;
+	{
+		std::vector<int, DSA::ArenaAllocator<int>> v {DSA::ArenaAllocator<int>(arena)};
+		for (int i = 0; i < 1000; ++i) {
+			v.push_back(i);
+		}
+		REQUIRE(v[999] == 999);
+		std::vector<int, DSA::ArenaAllocator<int>> w {std::move(v)};
+		REQUIRE(w.size() == 1000);
+	}
+	// every allocation was released: the arena starts over in the same block
+	std::vector<int, DSA::ArenaAllocator<int>> x(10, 3, DSA::ArenaAllocator<int>(arena));
+	REQUIRE(arena.blockCount() == 1);
+	REQUIRE(DSA::ArenaAllocator<int>(arena) == x.get_allocator());
+}
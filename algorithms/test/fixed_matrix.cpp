@@ -0,0 +1,45 @@
+#include "algorithms/fixed_matrix.hpp"
+#include "matrix_util.hpp"
+#include <catch2/catch.hpp>
+
+using namespace MatrixUtil;
+
+TEST_CASE("fixed matrix product", "[matrix]") {
+	DSA::FixedMatrix<int, 2, 3> a {1, 2, 3, 4, 5, 6};
+	DSA::FixedMatrix<int, 3, 2> b {7, 8, 9, 10, 11, 12};
+	DSA::FixedMatrix<int, 2, 2> c = a * b;
+	REQUIRE(c == (DSA::FixedMatrix<int, 2, 2> {58, 64, 139, 154}));
+	REQUIRE(a.transposed().get(2, 1) == 6);
+
+	auto i4 = DSA::FixedMatrix<double, 4, 4>::identity();
+	DSA::FixedMatrix<double, 4, 4> m;
+	for (std::size_t y = 0; y < 4; ++y) {
+		for (std::size_t x = 0; x < 4; ++x) {
+			m.get(y, x) = static_cast<double>(y * 4 + x) / 3;
+		}
+	}
+	REQUIRE(m * i4 == m);
+	REQUIRE(i4 * m == m);
+	REQUIRE((m + m - 2.0 * m) == DSA::FixedMatrix<double, 4, 4> {});
+	static_assert(DSA::FixedMatrix<float, 3, 5>::getWidth() == 5, "constexpr dimensions");
+}
+
+TEST_CASE("fixed matrix large product", "[matrix]") {
+	DSA::FixedMatrix<long, 20, 17> a {DSA::Matrix<long>(sequenceMatrix<long>(20, 17, -40))};
+	DSA::FixedMatrix<long, 17, 21> b {DSA::Matrix<long>(sequenceMatrix<long>(17, 21, 3))};
+	DSA::Matrix<long> c = a * b;
+	REQUIRE(equalMatrix(c, naiveProduct(sequenceMatrix<long>(20, 17, -40), sequenceMatrix<long>(17, 21, 3))));
+}
+
+TEST_CASE("fixed matrix dynamic interoperation", "[matrix]") {
+	DSA::FixedMatrix<int, 3, 3> f {2, 0, 0, 0, 2, 0, 0, 0, 2};
+	auto m = sequenceMatrix<int>(3, 4);
+	DSA::Matrix<int> doubled = f * m;
+	REQUIRE(doubled.get(2, 3) == 22);
+	DSA::Matrix<int> sum = f + m.submatrix(0, 1, 3, 3);
+	REQUIRE(sum.get(0, 0) == 3);
+	REQUIRE(sum.get(1, 1) == 8);
+	DSA::FixedMatrix<int, 3, 3> back {m.submatrix(0, 0, 3, 3)};
+	back = back * f;
+	REQUIRE(back.get(2, 2) == 20);
+}
@@ -1,5 +1,6 @@
 #include "algorithms/matrix.hpp"
 #include <catch2/catch.hpp>
+#include <cstdint>
 
 template <typename T>
 void fillMatrix(DSA::Matrix<T>& m) {
@@ -19,3 +20,55 @@ TEST_CASE("matrix", "[matrix]") {
 	std::cout << m2 << std::endl;
 	std::cout << (m * m2) << std::endl;
 }
+
+TEST_CASE("matrix padded stride", "[matrix]") {
+	DSA::Matrix<double> small {3, 3};
+	REQUIRE(small.getStride() == 3);
+
+	DSA::Matrix<double> m {4, 13};
+	REQUIRE(m.getStride() == 16);
+	REQUIRE(reinterpret_cast<std::uintptr_t>(m.data()) % 64 == 0);
+	REQUIRE(reinterpret_cast<std::uintptr_t>(&m.get(1, 0)) % 64 == 0);
+
+	// 512 doubles = 4096 bytes: rows of a column would share a cache set
+	DSA::Matrix<double> page {2, 512};
+	REQUIRE(page.getStride() == 520);
+
+	DSA::Matrix<double, std::allocator<double>> unpadded {4, 13};
+	REQUIRE(unpadded.getStride() == 13);
+}
+
+TEST_CASE("matrix padded in-place transpose", "[matrix]") {
+	DSA::Matrix<float> m {5, 37};
+	for (std::size_t y = 0; y < 5; ++y) {
+		for (std::size_t x = 0; x < 37; ++x) {
+			m.get(y, x) = y * 100 + x;
+		}
+	}
+	m.transposeInPlace();
+	REQUIRE(m.getHeight() == 37);
+	REQUIRE(m.getWidth() == 5);
+	REQUIRE(m.getStride() == 5);
+	for (std::size_t y = 0; y < 37; ++y) {
+		for (std::size_t x = 0; x < 5; ++x) {
+			REQUIRE(m.get(y, x) == x * 100 + y);
+		}
+	}
+	m.transposeInPlace();
+	REQUIRE(m.getStride() == 48);
+	REQUIRE(m.get(4, 36) == 436);
+}
+
+TEST_CASE("matrix arena storage", "[matrix]") {
+	using ArenaMatrix = DSA::Matrix<double, DSA::ArenaAllocator<double>>;
+	DSA::Arena arena;
+	DSA::Matrix<double> a {20, 20};
+	a.fill(1);
+	for (int i = 0; i < 3; ++i) {
+		ArenaMatrix b {a * a, arena};
+		ArenaMatrix c {b * a + b, arena};
+		REQUIRE(c.get(3, 4) == 420);
+		REQUIRE(reinterpret_cast<std::uintptr_t>(c.data()) % 64 == 0);
+	}
+	REQUIRE(arena.blockCount() == 1);
+}
@@ -0,0 +1,52 @@
+#include "algorithms/matrix_chain.hpp"
+#include "matrix_util.hpp"
+#include <catch2/catch.hpp>
+
+using namespace MatrixUtil;
+
+TEST_CASE("matrix chain plan", "[matrix]") {
+	// CLRS 15.2
+	DSA::MatrixChainPlan plan {{30, 35, 15, 5, 10, 20, 25}};
+	REQUIRE(plan.size() == 6);
+	REQUIRE(plan.cost() == 15125);
+	REQUIRE(plan.toString() == "((A0(A1A2))((A3A4)A5))");
+
+	DSA::MatrixChainPlan single {{4, 7}};
+	REQUIRE(single.cost() == 0);
+	REQUIRE(single.toString() == "A0");
+
+	std::vector<std::size_t> skewed {1000, 2, 1000, 2, 1000};
+	DSA::MatrixChainPlan p {skewed};
+	REQUIRE(p.cost() < DSA::MatrixChainPlan::sequentialCost(skewed));
+	REQUIRE(DSA::MatrixChainPlan::sequentialCost(skewed) == 1000ull * 2 * 1000 + 1000ull * 1000 * 2 + 1000ull * 2 * 1000);
+}
+
+TEST_CASE("matrix chain product", "[matrix]") {
+	auto a = sequenceMatrix<long>(5, 2);
+	auto b = sequenceMatrix<long>(2, 6, -3);
+	auto c = sequenceMatrix<long>(6, 1, 1);
+	auto d = sequenceMatrix<long>(1, 4, 2);
+	auto expected = naiveProduct(naiveProduct(naiveProduct(a, b), c), d);
+	REQUIRE(equalMatrix(DSA::chainProduct(a, b, c, d), expected));
+	REQUIRE(equalMatrix(DSA::chainProduct(a), a));
+	REQUIRE(equalMatrix(DSA::chainProduct(a, b), naiveProduct(a, b)));
+}
+
+TEST_CASE("matrix chain plan cache and buffers", "[matrix]") {
+	DSA::MatrixChain<int> chain;
+	DSA::Matrix<int> result;
+	for (int i = 0; i < 3; ++i) {
+		auto a = sequenceMatrix<int>(3, 8, i);
+		auto b = sequenceMatrix<int>(8, 2);
+		auto c = sequenceMatrix<int>(2, 9, -i);
+		auto d = sequenceMatrix<int>(9, 3);
+		chain.multiply({a.view(), b.view(), c.view(), d.view()}, result);
+		REQUIRE(equalMatrix(result, naiveProduct(naiveProduct(naiveProduct(a, b), c), d)));
+	}
+	REQUIRE(chain.cachedPlans() == 1);
+
+	auto m = sequenceMatrix<int>(4, 4);
+	chain.multiply({m.view(), m.submatrix(0, 0, 4, 2)}, result);
+	REQUIRE(equalMatrix(result, naiveProduct(m, DSA::Matrix<int>(m.submatrix(0, 0, 4, 2)))));
+	REQUIRE(chain.cachedPlans() == 2);
+}
@@ -0,0 +1,77 @@
+#include "algorithms/matrix.hpp"
+#include "matrix_util.hpp"
+#include <catch2/catch.hpp>
+
+using namespace MatrixUtil;
+
+TEST_CASE("matrix expression element-wise", "[matrix]") {
+	auto a = sequenceMatrix<int>(3, 4);
+	auto b = sequenceMatrix<int>(3, 4, 7);
+	DSA::Matrix<int> c = a + b - 2 * a;
+	for (std::size_t y = 0; y < 3; ++y) {
+		for (std::size_t x = 0; x < 4; ++x) {
+			REQUIRE(c.get(y, x) == b.get(y, x) - a.get(y, x));
+		}
+	}
+	DSA::Matrix<int> d = DSA::elementProduct(a, b);
+	REQUIRE(d.get(2, 3) == a.get(2, 3) * b.get(2, 3));
+}
+
+TEST_CASE("matrix expression product", "[matrix]") {
+	auto a = sequenceMatrix<int>(3, 5);
+	auto b = sequenceMatrix<int>(5, 2, -4);
+	DSA::Matrix<int> c = a * b;
+	REQUIRE(c.getHeight() == 3);
+	REQUIRE(c.getWidth() == 2);
+	REQUIRE(equalMatrix(c, naiveProduct(a, b)));
+}
+
+TEST_CASE("matrix expression fused sum of products", "[matrix]") {
+	auto a = sequenceMatrix<int>(4, 4);
+	auto b = sequenceMatrix<int>(4, 4, 3);
+	auto e = sequenceMatrix<int>(4, 4, -9);
+	DSA::Matrix<int> r = a * b + b * 3 - e;
+	DSA::Matrix<int> expected = naiveProduct(a, b);
+	for (std::size_t y = 0; y < 4; ++y) {
+		for (std::size_t x = 0; x < 4; ++x) {
+			expected.get(y, x) += b.get(y, x) * 3 - e.get(y, x);
+		}
+	}
+	REQUIRE(equalMatrix(r, expected));
+
+	DSA::Matrix<int> r2 = e - a * b;
+	REQUIRE(r2.get(1, 2) == e.get(1, 2) - naiveProduct(a, b).get(1, 2));
+	DSA::Matrix<int> r3 = (a * b) * e;
+	REQUIRE(equalMatrix(r3, naiveProduct(naiveProduct(a, b), e)));
+}
+
+TEST_CASE("matrix expression accumulate product", "[matrix]") {
+	auto a = sequenceMatrix<int>(3, 3);
+	auto b = sequenceMatrix<int>(3, 3, 1);
+	auto c = sequenceMatrix<int>(3, 3, 5);
+	auto expected = naiveProduct(a, b);
+	for (std::size_t y = 0; y < 3; ++y) {
+		for (std::size_t x = 0; x < 3; ++x) {
+			expected.get(y, x) += c.get(y, x);
+		}
+	}
+	c += a * b;
+	REQUIRE(equalMatrix(c, expected));
+	c -= a * b;
+	REQUIRE(equalMatrix(c, sequenceMatrix<int>(3, 3, 5)));
+}
+
+TEST_CASE("matrix expression aliasing", "[matrix]") {
+	auto a = sequenceMatrix<int>(3, 3);
+	auto b = sequenceMatrix<int>(3, 3, 2);
+	auto expected = naiveProduct(a, b);
+	a = a * b;
+	REQUIRE(equalMatrix(a, expected));
+
+	auto t = sequenceMatrix<int>(2, 3);
+	t = DSA::transpose(t);
+	REQUIRE(t.getHeight() == 3);
+	REQUIRE(t.getWidth() == 2);
+	REQUIRE(t.get(2, 1) == 5);
+	REQUIRE(t.get(1, 0) == 1);
+}
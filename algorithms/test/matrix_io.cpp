@@ -0,0 +1,120 @@
+#include "algorithms/matrix_io.hpp"
+#include "matrix_util.hpp"
+#include <catch2/catch.hpp>
+#include <sstream>
+#include <cstdio>
+#include <cstdint>
+#include <cstring>
+
+using namespace MatrixUtil;
+
+TEST_CASE("matrix binary stream round trip", "[matrix]") {
+	auto m = sequenceMatrix<double>(7, 19, 0.5);
+	std::stringstream buffer;
+	DSA::writeMatrix(buffer, m);
+	// header and 7 padded rows of 24 doubles, no padding after the last row
+	REQUIRE(buffer.str().size() == 64 + (6 * 24 + 19) * sizeof(double));
+	auto r = DSA::readMatrix<double>(buffer);
+	REQUIRE(equalMatrix(r, m));
+
+	// strided source and an empty matrix
+	std::stringstream transposed;
+	DSA::writeMatrix(transposed, m.view().transposed());
+	REQUIRE(equalMatrix(DSA::readMatrix<double>(transposed), DSA::Matrix<double>(DSA::transpose(m))));
+	std::stringstream empty;
+	DSA::writeMatrix(empty, DSA::Matrix<double>());
+	REQUIRE(DSA::readMatrix<double>(empty).getHeight() == 0);
+}
+
+TEST_CASE("matrix binary format errors", "[matrix]") {
+	auto m = sequenceMatrix<int>(3, 3);
+	std::stringstream buffer;
+	DSA::writeMatrix(buffer, m);
+	const std::string bytes = buffer.str();
+
+	std::stringstream wrong_type {bytes};
+	REQUIRE_THROWS_AS(DSA::readMatrix<float>(wrong_type), DSA::MatrixFormatError);
+	std::stringstream truncated {bytes.substr(0, bytes.size() - 1)};
+	REQUIRE_THROWS_AS(DSA::readMatrix<int>(truncated), DSA::MatrixFormatError);
+	std::stringstream garbage {std::string(100, 'x')};
+	REQUIRE_THROWS_AS(DSA::readMatrix<int>(garbage), DSA::MatrixFormatError);
+}
+
+TEST_CASE("matrix binary other byte order", "[matrix]") {
+	auto m = sequenceMatrix<std::int32_t>(2, 3, 1000);
+	std::stringstream buffer;
+	DSA::writeMatrix(buffer, m);
+	std::string bytes = buffer.str();
+	auto reverse = [&](std::size_t offset, std::size_t size) {
+		std::reverse(bytes.begin() + offset, bytes.begin() + offset + size);
+	};
+	bytes[14] = bytes[14] == 1 ? 2 : 1;
+	reverse(8, 4);
+	for (std::size_t offset = 16; offset < 48; offset += 8) {
+		reverse(offset, 8);
+	}
+	for (std::size_t offset = 64; offset < bytes.size(); offset += 4) {
+		reverse(offset, 4);
+	}
+	std::stringstream swapped {bytes};
+	REQUIRE(equalMatrix(DSA::readMatrix<std::int32_t>(swapped), m));
+}
+
+TEST_CASE("matrix binary view padding", "[matrix]") {
+	// the view has the same stride as the file, the rest of its parent's rows must not leak into the padding
+	auto m = sequenceMatrix<float>(5, 70, 1);
+	auto v = m.submatrix(0, 0, 5, 66);
+	std::stringstream stream;
+	DSA::writeMatrix(stream, v);
+	const std::string bytes = stream.str();
+	const std::size_t stride = m.getStride();
+	REQUIRE(bytes.size() == 64 + (4 * stride + 66) * sizeof(float));
+	for (std::size_t y = 0; y < 4; ++y) {
+		for (std::size_t x = 66; x < stride; ++x) {
+			float padding;
+			std::memcpy(&padding, bytes.data() + 64 + (y * stride + x) * sizeof(float), sizeof(float));
+			REQUIRE(padding == 0);
+		}
+	}
+	REQUIRE(equalMatrix(DSA::readMatrix<float>(stream), DSA::Matrix<float>(v)));
+}
+
+#if defined(DSA_MATRIX_MMAP)
+
+TEST_CASE("matrix memory mapped", "[matrix]") {
+	const std::string path = "matrix_io_test.bin";
+	auto m = sequenceMatrix<float>(33, 70);
+	DSA::writeMatrix(path, m);
+	{
+		DSA::MappedMatrix<float> mapped {path};
+		REQUIRE(mapped.getHeight() == 33);
+		REQUIRE(mapped.getWidth() == 70);
+		REQUIRE(reinterpret_cast<std::uintptr_t>(mapped.view().data()) % 64 == 0);
+		REQUIRE(equalMatrix(DSA::Matrix<float>(mapped.view()), m));
+
+		DSA::MappedMatrix<float> moved {std::move(mapped)};
+		DSA::Matrix<float> product = moved.view() * DSA::transpose(m);
+		REQUIRE(product.get(1, 2) == naiveProduct(m, DSA::Matrix<float>(DSA::transpose(m))).get(1, 2));
+		REQUIRE_THROWS_AS(DSA::MappedMatrix<double>(path), DSA::MatrixFormatError);
+	}
+	REQUIRE(equalMatrix(DSA::readMatrix<float>(path), m));
+	std::remove(path.c_str());
+	REQUIRE_THROWS(DSA::MappedMatrix<float>(path));
+}
+
+#endif
+
+TEST_CASE("matrix text output", "[matrix]") {
+	auto m = sequenceMatrix<int>(2, 3);
+	std::ostringstream out;
+	out << m;
+	REQUIRE(out.str() == "0 1 2 \n3 4 5 \n");
+
+	std::ostringstream hex;
+	hex << std::hex << sequenceMatrix<int>(1, 2, 10);
+	REQUIRE(hex.str() == "a b \n");
+
+	std::ostringstream large;
+	large << DSA::Matrix<int>(2000, 100);
+	REQUIRE(large.str().size() == 2000 * 201);
+}
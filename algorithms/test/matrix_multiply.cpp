@@ -0,0 +1,57 @@
+#include "algorithms/matrix.hpp"
+#include "matrix_util.hpp"
+#include <catch2/catch.hpp>
+
+using namespace MatrixUtil;
+
+TEST_CASE("matrix blocked product", "[matrix]") {
+	auto a = sequenceMatrix<long>(70, 130, -50);
+	auto b = sequenceMatrix<long>(130, 90, -3000);
+	DSA::Matrix<long> c = a * b;
+	REQUIRE(equalMatrix(c, naiveProduct(a, b)));
+}
+
+TEST_CASE("matrix strassen product", "[matrix]") {
+	const std::size_t sizes[] = {1, 2, 7, 8, 16, 31, 33, 64, 75};
+	for (std::size_t n : sizes) {
+		SECTION(std::to_string(n)) {
+			auto a = sequenceMatrix<long>(n, n, -100);
+			auto b = sequenceMatrix<long>(n, n, -7);
+			REQUIRE(equalMatrix(DSA::strassenProduct(a, b, 4), naiveProduct(a, b)));
+			REQUIRE(equalMatrix(DSA::strassenProduct(a, b, 1), naiveProduct(a, b)));
+		}
+	}
+}
+
+TEST_CASE("matrix strassen classical fallback", "[matrix]") {
+	// n <= leaf must be the classical kernel all the way down: with fractions, any Strassen level rounds differently
+	const std::size_t n = 2 * DSA::strassenCrossover() + 1;
+	DSA::Matrix<double> a {n, n};
+	DSA::Matrix<double> b {n, n};
+	for (std::size_t y = 0; y < n; ++y) {
+		for (std::size_t x = 0; x < n; ++x) {
+			a.get(y, x) = 1.0 / (y * n + x + 1);
+			b.get(y, x) = 1.0 / (x * n + y + 3);
+		}
+	}
+	DSA::Matrix<double> expected {n, n};
+	DSA::Detail::multiplyBlocked(n, n, n, a.data(), a.getStride(), b.data(), b.getStride(),
+								expected.data(), expected.getStride(), 1.0, true);
+	DSA::Matrix<double> c = DSA::strassenProduct(a, b, n);
+	for (std::size_t y = 0; y < n; ++y) {
+		for (std::size_t x = 0; x < n; ++x) {
+			REQUIRE(c.get(y, x) == expected.get(y, x));
+		}
+	}
+}
+
+TEST_CASE("matrix strassen operator", "[matrix]") {
+	const std::size_t n = DSA::strassenCrossover() + 3;
+	auto a = sequenceMatrix<long>(n, n, -1000);
+	auto b = sequenceMatrix<long>(n, n, 17);
+	auto c = sequenceMatrix<long>(n, n);
+	auto expected = naiveProduct(a, b);
+	REQUIRE(equalMatrix(DSA::Matrix<long>(a * b), expected));
+	c += a * b;
+	REQUIRE(c.get(n - 1, 5) == expected.get(n - 1, 5) + static_cast<long>((n - 1) * n + 5));
+}
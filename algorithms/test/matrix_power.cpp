@@ -0,0 +1,120 @@
+#include "algorithms/matrix_power.hpp"
+#include "matrix_util.hpp"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <vector>
+
+using namespace MatrixUtil;
+
+template <typename T>
+static DSA::Matrix<T> repeatedProduct(const DSA::Matrix<T>& m, std::uint64_t k) {
+	DSA::Matrix<T> r {m.getHeight(), m.getWidth()};
+	for (std::size_t i = 0; i < m.getHeight(); ++i) {
+		r.get(i, i) = 1;
+	}
+	while (k-- > 0) {
+		r = naiveProduct(r, m);
+	}
+	return r;
+}
+
+TEST_CASE("matrix power", "[matrix]") {
+	DSA::Matrix<std::int64_t> fib {2, 2};
+	fib.get(0, 0) = 1;
+	fib.get(0, 1) = 1;
+	fib.get(1, 0) = 1;
+	REQUIRE(DSA::pow(fib, 0).get(0, 0) == 1);
+	REQUIRE(DSA::pow(fib, 0).get(0, 1) == 0);
+	REQUIRE(DSA::pow(fib, 1).get(0, 1) == 1);
+	REQUIRE(DSA::pow(fib, 90).get(0, 1) == 2880067194370816120ll);
+
+	auto m = sequenceMatrix<std::int64_t>(5, 5, -12);
+	for (std::uint64_t k : {2, 3, 7, 8}) {
+		REQUIRE(equalMatrix(DSA::pow(m, k), repeatedProduct(m, k)));
+	}
+}
+
+TEST_CASE("matrix power large square", "[matrix]") {
+	// above the Strassen crossover: the workspace is reused between steps
+	DSA::Matrix<double> m {100, 100};
+	for (std::size_t i = 0; i < 100; ++i) {
+		m.get(i, (i + 1) % 100) = 1;
+	}
+	auto p = DSA::pow(m, 13);
+	REQUIRE(p.get(0, 13) == 1);
+	REQUIRE(p.get(95, 8) == 1);
+	REQUIRE(p.get(0, 12) == 0);
+	REQUIRE(equalMatrix(DSA::pow(m, 100), DSA::pow(m, 0)));
+}
+
+TEST_CASE("matrix power modular", "[matrix]") {
+	DSA::Matrix<std::int64_t> fib {2, 2};
+	fib.get(0, 0) = 1;
+	fib.get(0, 1) = 1;
+	fib.get(1, 0) = 1;
+	const std::uint64_t p = 1000000007;
+	// F(10^18) mod 10^9 + 7
+	REQUIRE(DSA::pow(fib, 1000000000000000000ull, p).get(0, 1) == 209783453);
+	REQUIRE(DSA::pow(fib, 90, p).get(0, 1) == 2880067194370816120ll % p);
+
+	auto m = sequenceMatrix<std::int64_t>(4, 4, -7);
+	auto exact = repeatedProduct(m, 5);
+	auto modular = DSA::pow(m, 5, 97);
+	for (std::size_t y = 0; y < 4; ++y) {
+		for (std::size_t x = 0; x < 4; ++x) {
+			REQUIRE(modular.get(y, x) == ((exact.get(y, x) % 97) + 97) % 97);
+		}
+	}
+
+	DSA::Matrix<std::uint32_t> big {30, 30};
+	big.fill(4294967295u);
+	auto q = DSA::pow(big, 2, 4294967296ull);
+	REQUIRE(q.get(3, 4) == 30);
+	REQUIRE(DSA::pow(big, 3, 1).get(0, 0) == 0);
+
+	// the largest residue has to fit in the element type
+	REQUIRE(DSA::Detail::residuesFit<std::uint32_t>(4294967296ull));
+	REQUIRE(!DSA::Detail::residuesFit<std::int32_t>(4294967296ull));
+	REQUIRE(DSA::Detail::residuesFit<std::int32_t>(2147483648ull));
+	REQUIRE(!DSA::Detail::residuesFit<std::int8_t>(129));
+	DSA::Matrix<std::int32_t> wide {3, 3};
+	wide.fill(-1);
+	// (-1 mod 2^31)^2 summed 3 times: 3 * (2^31 - 1)^2 = 3 mod 2^31
+	REQUIRE(DSA::pow(wide, 2, 2147483648ull).get(2, 1) == 3);
+	DSA::Matrix<std::int8_t> small {2, 2};
+	small.fill(127);
+	REQUIRE(DSA::pow(small, 3, 128).get(1, 1) == 4 * 127 % 128);
+	// the same bound for the vector power: (2^32 - 1) * 2 mod 2^32 needs an unsigned 32-bit result
+	DSA::Matrix<std::uint32_t> ones {2, 2};
+	ones.fill(4294967295u);
+	REQUIRE(DSA::powVector(ones, 1, std::vector<std::uint32_t> {1, 1}, 4294967296ull)
+			== std::vector<std::uint32_t>(2, 4294967294u));
+	wide.fill(-1);
+	REQUIRE(DSA::powVector(wide, 1, std::vector<std::int32_t>(3, 1), 2147483648ull)
+			== std::vector<std::int32_t>(3, 2147483645));
+}
+
+TEST_CASE("matrix vector power", "[matrix]") {
+	auto m = sequenceMatrix<std::int64_t>(6, 6, -20);
+	std::vector<std::int64_t> v {1, -2, 3, 0, 5, 1};
+	for (std::uint64_t k : {0, 1, 2, 5, 40}) {
+		auto expected = repeatedProduct(m, k);
+		std::vector<std::int64_t> r = DSA::powVector(m, k, v);
+		for (std::size_t y = 0; y < 6; ++y) {
+			std::int64_t sum = 0;
+			for (std::size_t x = 0; x < 6; ++x) {
+				sum += expected.get(y, x) * v[x];
+			}
+			REQUIRE(r[y] == sum);
+		}
+	}
+
+	// Markov chain: every state moves to the next one
+	DSA::Matrix<std::int32_t> shift {3, 3};
+	shift.get(1, 0) = 1;
+	shift.get(2, 1) = 1;
+	shift.get(0, 2) = 1;
+	std::vector<std::int32_t> state {1, 0, 0};
+	REQUIRE(DSA::powVector(shift, 1000000000001ull, state, 1000000007) == std::vector<std::int32_t>({0, 0, 1}));
+	REQUIRE(DSA::powVector(shift, 4, state, 1000000007) == std::vector<std::int32_t>({0, 1, 0}));
+}
@@ -0,0 +1,140 @@
+#include "algorithms/matrix_quantized.hpp"
+#include <catch2/catch.hpp>
+#include <cstdint>
+#include <cmath>
+
+template <typename T>
+static DSA::Matrix<T> patternMatrix(std::size_t rows, std::size_t columns, int seed) {
+	DSA::Matrix<T> m {rows, columns};
+	for (std::size_t y = 0; y < rows; ++y) {
+		for (std::size_t x = 0; x < columns; ++x) {
+			m.get(y, x) = static_cast<T>(static_cast<int>((y * 131 + x * 71 + seed * 17) % 255) - 127);
+		}
+	}
+	return m;
+}
+
+template <typename A, typename B>
+static DSA::Matrix<std::int64_t> wideProduct(const DSA::Matrix<A>& a, const DSA::Matrix<B>& b) {
+	DSA::Matrix<std::int64_t> c {a.getHeight(), b.getWidth()};
+	for (std::size_t y = 0; y < a.getHeight(); ++y) {
+		for (std::size_t x = 0; x < b.getWidth(); ++x) {
+			for (std::size_t k = 0; k < a.getWidth(); ++k) {
+				c.get(y, x) += static_cast<std::int64_t>(a.get(y, k)) * b.get(k, x);
+			}
+		}
+	}
+	return c;
+}
+
+template <typename A>
+static bool equalWide(const A& c, const DSA::Matrix<std::int64_t>& expected) {
+	for (std::size_t y = 0; y < expected.getHeight(); ++y) {
+		for (std::size_t x = 0; x < expected.getWidth(); ++x) {
+			if (c.get(y, x) != expected.get(y, x)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+TEST_CASE("int8 product widens to int32", "[matrix]") {
+	const std::size_t sizes[][3] = {{1, 1, 1}, {3, 5, 7}, {17, 33, 41}, {64, 257, 70}};
+	for (const auto& size : sizes) {
+		auto a = patternMatrix<std::int8_t>(size[0], size[1], 1);
+		auto b = patternMatrix<std::int8_t>(size[1], size[2], 2);
+		DSA::Matrix<std::int32_t> c = a * b;
+		REQUIRE(equalWide(c, wideProduct(a, b)));
+	}
+	// every element at the limit: 257 * 127 * 127 overflows int16 and int8 accumulators
+	DSA::Matrix<std::int8_t> a {2, 257};
+	a.fill(-127);
+	DSA::Matrix<std::int32_t> c = a * DSA::transpose(a);
+	REQUIRE(c.get(1, 0) == 257 * 127 * 127);
+}
+
+TEST_CASE("int16 and uint8 products", "[matrix]") {
+	auto a = patternMatrix<std::int16_t>(9, 40, 3);
+	auto b = patternMatrix<std::int16_t>(40, 35, 4);
+	a.get(0, 0) = 30000;
+	b.get(0, 0) = -30000;
+	DSA::Matrix<std::int32_t> c = a * b;
+	REQUIRE(equalWide(c, wideProduct(a, b)));
+
+	DSA::Matrix<std::uint8_t> u {5, 11};
+	u.fill(255);
+	auto s = patternMatrix<std::int8_t>(11, 9, 5);
+	DSA::Matrix<std::int32_t> us = u * s;
+	REQUIRE(equalWide(us, wideProduct(u, s)));
+}
+
+TEST_CASE("int8 product scaled and accumulated", "[matrix]") {
+	auto a = patternMatrix<std::int8_t>(6, 10, 6);
+	auto b = patternMatrix<std::int8_t>(10, 12, 7);
+	auto expected = wideProduct(a, b);
+	DSA::Matrix<std::int32_t> c {6, 12};
+	c.fill(5);
+	c += a * b;
+	c -= 3 * (a * b);
+	for (std::size_t y = 0; y < 6; ++y) {
+		for (std::size_t x = 0; x < 12; ++x) {
+			REQUIRE(c.get(y, x) == 5 - 2 * expected.get(y, x));
+		}
+	}
+}
+
+TEST_CASE("quantized float product", "[matrix]") {
+	DSA::Matrix<float> a {8, 50};
+	DSA::Matrix<float> b {50, 6};
+	for (std::size_t y = 0; y < 8; ++y) {
+		for (std::size_t x = 0; x < 50; ++x) {
+			a.get(y, x) = std::sin(static_cast<float>(y * 50 + x)) * (y + 1);
+		}
+	}
+	for (std::size_t y = 0; y < 50; ++y) {
+		for (std::size_t x = 0; x < 6; ++x) {
+			b.get(y, x) = std::cos(static_cast<float>(y * 6 + x)) / (x + 1);
+		}
+	}
+	DSA::Matrix<float> exact = a * b;
+	DSA::Matrix<float> approx = DSA::quantizedProduct(a, b);
+	for (std::size_t y = 0; y < 8; ++y) {
+		for (std::size_t x = 0; x < 6; ++x) {
+			REQUIRE(std::fabs(approx.get(y, x) - exact.get(y, x)) < 0.02f * (y + 1) * 50 / (x + 1) / 10);
+		}
+	}
+
+	auto q = DSA::quantizeRows<std::int8_t>(a);
+	REQUIRE(q.scales.size() == 8);
+	auto back = DSA::dequantizeRows(q);
+	for (std::size_t x = 0; x < 50; ++x) {
+		REQUIRE(std::fabs(back.get(3, x) - a.get(3, x)) <= q.scales[3] / 2 + 1e-6f);
+	}
+
+	DSA::Matrix<float> zero {2, 2};
+	REQUIRE(DSA::quantizeColumns<std::int8_t>(zero).scales[1] == 1.0f);
+}
+
+TEST_CASE("int16 quantized product at full scale", "[matrix]") {
+	// 32767^2 * k overflows int32 from k = 3 on, the limit has to shrink with k
+	const std::size_t depths[] = {3, 4, 1000};
+	for (std::size_t k : depths) {
+		DSA::Matrix<float> a {3, k};
+		DSA::Matrix<float> b {k, 2};
+		a.fill(1.0f);
+		b.fill(-1.0f);
+		DSA::Matrix<float> c = DSA::quantizedProduct<std::int16_t>(a, b);
+		REQUIRE(std::fabs(c.get(2, 1) + static_cast<float>(k)) < 1e-3f * k);
+
+		auto q = DSA::quantizeRows<std::int16_t>(a);
+		const std::int64_t limit = q.values.get(0, 0);
+		REQUIRE(limit * limit * static_cast<std::int64_t>(k) <= INT32_MAX);
+	}
+	DSA::Matrix<float> ones {4, 4};
+	ones.fill(1.0f);
+	REQUIRE(DSA::quantizedProduct<std::int16_t>(ones, ones).get(3, 3) == Approx(4.0f));
+	REQUIRE(DSA::quantizedProduct<std::int8_t>(ones, ones).get(3, 3) == Approx(4.0f));
+	// a single product per sum keeps the full int16 range
+	REQUIRE(DSA::quantizeRows<std::int16_t>(DSA::Matrix<float>(ones.column(0))).values.get(0, 0) == 32767);
+}
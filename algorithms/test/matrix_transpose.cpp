@@ -0,0 +1,81 @@
+#include "algorithms/matrix.hpp"
+#include "matrix_util.hpp"
+#include <catch2/catch.hpp>
+
+using namespace MatrixUtil;
+
+template <typename T>
+static bool isTransposed(const DSA::Matrix<T>& t, const DSA::Matrix<T>& m) {
+	if (t.getHeight() != m.getWidth() || t.getWidth() != m.getHeight()) {
+		return false;
+	}
+	for (std::size_t y = 0; y < m.getHeight(); ++y) {
+		for (std::size_t x = 0; x < m.getWidth(); ++x) {
+			if (t.get(x, y) != m.get(y, x)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+TEMPLATE_TEST_CASE("matrix transpose out-of-place", "[matrix]", int, float, double) {
+	const std::size_t sizes[][2] = {
+		{1, 1}, {1, 9}, {4, 4}, {8, 8}, {3, 7}, {17, 5}, {33, 65}, {100, 64}, {129, 130}
+	};
+	for (const auto& size : sizes) {
+		auto m = sequenceMatrix<TestType>(size[0], size[1]);
+		DSA::Matrix<TestType> t = DSA::transpose(m);
+		REQUIRE(isTransposed(t, m));
+	}
+}
+
+TEST_CASE("matrix transpose of views and scaled", "[matrix]") {
+	auto m = sequenceMatrix<float>(70, 50);
+	DSA::Matrix<float> dest {60, 80};
+	auto block = m.submatrix(5, 3, 40, 45);
+	dest.submatrix(10, 20, 45, 40) = DSA::transpose(block);
+	for (std::size_t y = 0; y < 40; ++y) {
+		for (std::size_t x = 0; x < 45; ++x) {
+			REQUIRE(dest.get(10 + x, 20 + y) == block.get(y, x));
+		}
+	}
+	REQUIRE(dest.get(0, 0) == 0);
+
+	DSA::Matrix<float> scaled = DSA::transpose(DSA::Matrix<float>(m * 2.0f));
+	REQUIRE(scaled.get(49, 69) == 2 * m.get(69, 49));
+
+	// strided source: element-wise fallback
+	DSA::Matrix<float> strided = DSA::transpose(m.view().transposed());
+	REQUIRE(equalMatrix(strided, m));
+}
+
+TEST_CASE("matrix transpose of a product", "[matrix]") {
+	auto a = sequenceMatrix<int>(3, 4);
+	auto b = sequenceMatrix<int>(4, 5, -2);
+	DSA::Matrix<int> t = DSA::transpose(a * b);
+	REQUIRE(isTransposed(t, naiveProduct(a, b)));
+}
+
+TEST_CASE("matrix transpose in-place square", "[matrix]") {
+	for (std::size_t n : {1, 2, 31, 32, 33, 100}) {
+		auto m = sequenceMatrix<double>(n, n);
+		auto t = m;
+		t.transposeInPlace();
+		REQUIRE(isTransposed(t, m));
+		t.transposeInPlace();
+		REQUIRE(equalMatrix(t, m));
+	}
+}
+
+TEST_CASE("matrix transpose in-place rectangular", "[matrix]") {
+	const std::size_t sizes[][2] = {{1, 5}, {5, 1}, {2, 3}, {3, 2}, {7, 13}, {64, 10}, {33, 100}};
+	for (const auto& size : sizes) {
+		auto m = sequenceMatrix<int>(size[0], size[1]);
+		auto t = m;
+		t.transposeInPlace();
+		REQUIRE(isTransposed(t, m));
+		t.transposeInPlace();
+		REQUIRE(equalMatrix(t, m));
+	}
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include "algorithms/matrix.hpp"
+#include <cstddef>
+
+namespace MatrixUtil {
+
+template <typename T>
+DSA::Matrix<T> sequenceMatrix(std::size_t rows, std::size_t columns, T offset = T()) {
+	DSA::Matrix<T> m {rows, columns};
+	for (std::size_t y = 0; y < rows; ++y) {
+		for (std::size_t x = 0; x < columns; ++x) {
+			m.get(y, x) = offset + static_cast<T>(y * columns + x);
+		}
+	}
+	return m;
+}
+
+template <typename T>
+DSA::Matrix<T> naiveProduct(const DSA::Matrix<T>& a, const DSA::Matrix<T>& b) {
+	DSA::Matrix<T> c {a.getHeight(), b.getWidth()};
+	for (std::size_t y = 0; y < a.getHeight(); ++y) {
+		for (std::size_t x = 0; x < b.getWidth(); ++x) {
+			for (std::size_t k = 0; k < a.getWidth(); ++k) {
+				c.get(y, x) += a.get(y, k) * b.get(k, x);
+			}
+		}
+	}
+	return c;
+}
+
+template <typename T>
+bool equalMatrix(const DSA::Matrix<T>& a, const DSA::Matrix<T>& b) {
+	if (a.getHeight() != b.getHeight() || a.getWidth() != b.getWidth()) {
+		return false;
+	}
+	for (std::size_t y = 0; y < a.getHeight(); ++y) {
+		for (std::size_t x = 0; x < a.getWidth(); ++x) {
+			if (a.get(y, x) != b.get(y, x)) {
+				return false;
+			}
+		}
+	}
+	return true;
+}
+
+}
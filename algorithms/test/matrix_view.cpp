@@ -0,0 +1,97 @@
+#include "algorithms/matrix.hpp"
+#include "matrix_util.hpp"
+#include <catch2/catch.hpp>
+
+using namespace MatrixUtil;
+
+TEST_CASE("matrix view slicing", "[matrix]") {
+	auto m = sequenceMatrix<int>(4, 5);
+	auto sub = m.submatrix(1, 2, 2, 3);
+	REQUIRE(sub.getHeight() == 2);
+	REQUIRE(sub.getWidth() == 3);
+	REQUIRE(sub.get(0, 0) == 7);
+	REQUIRE(sub.get(1, 2) == 14);
+	REQUIRE(m.row(3).get(0, 4) == 19);
+	REQUIRE(m.column(1).get(2, 0) == 11);
+
+	auto t = m.view().transposed();
+	REQUIRE(t.getHeight() == 5);
+	REQUIRE(t.get(4, 3) == m.get(3, 4));
+
+	sub.fill(-1);
+	REQUIRE(m.get(2, 4) == -1);
+	REQUIRE(m.get(2, 1) == 11);
+	m.row(0) = m.row(3);
+	REQUIRE(m.get(0, 2) == 17);
+}
+
+TEST_CASE("matrix view external buffer", "[matrix]") {
+	double buffer[6] = {1, 2, 3, 4, 5, 6};
+	DSA::ConstMatrixView<double> v {buffer, 2, 3};
+	DSA::Matrix<double> m = v * DSA::transpose(v);
+	REQUIRE(m.get(0, 0) == 14);
+	REQUIRE(m.get(0, 1) == 32);
+	REQUIRE(m.get(1, 1) == 77);
+
+	DSA::MatrixView<double> w {buffer, 3, 2};
+	w.column(1) *= 10;
+	REQUIRE(buffer[5] == 60);
+}
+
+TEST_CASE("matrix view tiled product", "[matrix]") {
+	const std::size_t n = 12;
+	const std::size_t tile = 4;
+	auto a = sequenceMatrix<long>(n, n, -20);
+	auto b = sequenceMatrix<long>(n, n, 3);
+	DSA::Matrix<long> c {n, n};
+	for (std::size_t y = 0; y < n; y += tile) {
+		for (std::size_t x = 0; x < n; x += tile) {
+			for (std::size_t k = 0; k < n; k += tile) {
+				c.submatrix(y, x, tile, tile) += a.submatrix(y, k, tile, tile) * b.submatrix(k, x, tile, tile);
+			}
+		}
+	}
+	REQUIRE(equalMatrix(c, naiveProduct(a, b)));
+	DSA::Matrix<long> d = a.view() * b.view().transposed();
+	REQUIRE(equalMatrix(d, naiveProduct(a, DSA::Matrix<long>(DSA::transpose(b)))));
+}
+
+TEST_CASE("matrix view aliasing", "[matrix]") {
+	auto m = sequenceMatrix<int>(1, 6);
+	// Overlapping, shifted views are evaluated through a temporary
+	m.submatrix(0, 1, 1, 5) = m.submatrix(0, 0, 1, 5);
+	for (int x = 1; x < 6; ++x) {
+		REQUIRE(m.get(0, x) == x - 1);
+	}
+	auto sq = sequenceMatrix<int>(3, 3);
+	sq.view() = sq.view().transposed();
+	REQUIRE(sq.get(0, 2) == 6);
+	REQUIRE(sq.get(2, 0) == 2);
+
+	// the matrix itself is alias-safe only when written in the same order
+	auto a = sequenceMatrix<int>(3, 3);
+	auto expected = sequenceMatrix<int>(3, 3);
+	a.view().transposed() = a;
+	for (std::size_t y = 0; y < 3; ++y) {
+		for (std::size_t x = 0; x < 3; ++x) {
+			REQUIRE(a.get(y, x) == expected.get(x, y));
+		}
+	}
+	a = expected;
+	a.view().transposed() += a;
+	for (std::size_t y = 0; y < 3; ++y) {
+		for (std::size_t x = 0; x < 3; ++x) {
+			REQUIRE(a.get(y, x) == expected.get(y, x) + expected.get(x, y));
+		}
+	}
+}
+
+TEST_CASE("matrix view strassen product", "[matrix]") {
+	const std::size_t n = DSA::strassenCrossover() + 9;
+	auto a = sequenceMatrix<long>(n + 5, n + 3, -500);
+	auto b = sequenceMatrix<long>(n + 2, n + 7, 11);
+	DSA::Matrix<long> c = a.submatrix(5, 3, n, n) * b.submatrix(2, 7, n, n);
+	DSA::Matrix<long> expected = naiveProduct(DSA::Matrix<long>(a.submatrix(5, 3, n, n)),
+											DSA::Matrix<long>(b.submatrix(2, 7, n, n)));
+	REQUIRE(equalMatrix(c, expected));
+}
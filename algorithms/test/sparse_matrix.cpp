@@ -0,0 +1,109 @@
+#include "algorithms/sparse_matrix.hpp"
+#include "matrix_util.hpp"
+#include <catch2/catch.hpp>
+#include <random>
+
+using namespace MatrixUtil;
+
+static DSA::Matrix<long> randomSparse(std::size_t rows, std::size_t columns, int percent) {
+	static std::mt19937 mersenne(42);
+	std::uniform_int_distribution<> die(0, 99);
+	DSA::Matrix<long> m {rows, columns};
+	for (std::size_t y = 0; y < rows; ++y) {
+		for (std::size_t x = 0; x < columns; ++x) {
+			if (die(mersenne) < percent) {
+				m.get(y, x) = die(mersenne) - 50;
+			}
+		}
+	}
+	return m;
+}
+
+TEST_CASE("sparse coo construction", "[sparse]") {
+	DSA::CooMatrix<int> coo {3, 4};
+	coo.insert(2, 3, 5);
+	coo.insert(0, 1, 1);
+	coo.insert(2, 0, 7);
+	coo.insert(0, 1, 2);
+	DSA::CsrMatrix<int> csr {coo};
+	REQUIRE(csr.nonZeros() == 3);
+	REQUIRE(csr.get(0, 1) == 3);
+	REQUIRE(csr.get(2, 0) == 7);
+	REQUIRE(csr.get(1, 1) == 0);
+	REQUIRE(csr.columnIndices() == std::vector<std::size_t>({1, 0, 3}));
+
+	DSA::CscMatrix<int> csc {coo};
+	REQUIRE(csc.nonZeros() == 3);
+	REQUIRE(csc.get(2, 3) == 5);
+	REQUIRE(csc.rowIndices() == std::vector<std::size_t>({2, 0, 2}));
+	REQUIRE(equalMatrix(csr.toDense(), csc.toDense()));
+}
+
+TEST_CASE("sparse dense conversion", "[sparse]") {
+	auto m = randomSparse(30, 20, 10);
+	DSA::CsrMatrix<long> csr {m};
+	DSA::CscMatrix<long> csc {m};
+	REQUIRE(equalMatrix(csr.toDense(), m));
+	REQUIRE(equalMatrix(csc.toDense(), m));
+	REQUIRE(equalMatrix(csr.toCsc().toDense(), m));
+	REQUIRE(equalMatrix(csc.toCsr().toDense(), m));
+}
+
+TEST_CASE("sparse matrix vector", "[sparse]") {
+	auto m = randomSparse(57, 40, 15);
+	DSA::CsrMatrix<long> csr {m};
+	DSA::Matrix<long> x = sequenceMatrix<long>(40, 1, -20);
+	std::vector<long> v;
+	for (std::size_t i = 0; i < 40; ++i) {
+		v.push_back(x.get(i, 0));
+	}
+	DSA::Matrix<long> expected = m * x;
+	for (unsigned threads = 1; threads <= 8; ++threads) {
+		std::vector<long> y;
+		DSA::sparseMatrixVector(csr, v, y, threads);
+		REQUIRE(y.size() == 57);
+		for (std::size_t i = 0; i < 57; ++i) {
+			REQUIRE(y[i] == expected.get(i, 0));
+		}
+	}
+	std::vector<long> y;
+	DSA::sparseMatrixVector(DSA::CscMatrix<long>(m), v, y);
+	REQUIRE(y[13] == expected.get(13, 0));
+}
+
+TEST_CASE("sparse matrix vector threads", "[sparse]") {
+	// enough non-zeros for four threads, with a heavy first row
+	const std::size_t n = 4096;
+	DSA::CooMatrix<long> coo {n, n};
+	for (std::size_t x = 0; x < n; ++x) {
+		coo.insert(0, x, 1);
+	}
+	for (std::size_t y = 0; y < n; ++y) {
+		for (std::size_t k = 0; k < 4 * DSA::Detail::spmvNonZerosPerThread() / n; ++k) {
+			coo.insert(y, (y * 31 + k * 17) % n, static_cast<long>(k) - 10);
+		}
+	}
+	DSA::CsrMatrix<long> csr {coo};
+	std::vector<long> v;
+	for (std::size_t i = 0; i < n; ++i) {
+		v.push_back(static_cast<long>(i % 13) - 6);
+	}
+	std::vector<long> expected;
+	DSA::sparseMatrixVector(csr, v, expected, 1);
+	for (unsigned threads = 2; threads <= 8; threads *= 2) {
+		std::vector<long> y;
+		DSA::sparseMatrixVector(csr, v, y, threads);
+		REQUIRE(y == expected);
+	}
+}
+
+TEST_CASE("sparse matrix product", "[sparse]") {
+	auto a = randomSparse(25, 30, 10);
+	auto b = randomSparse(30, 18, 20);
+	DSA::CsrMatrix<long> c = DSA::sparseMatrixProduct(DSA::CsrMatrix<long>(a), DSA::CsrMatrix<long>(b));
+	REQUIRE(equalMatrix(c.toDense(), naiveProduct(a, b)));
+	const auto& offsets = c.rowOffsets();
+	for (std::size_t row = 0; row < c.getHeight(); ++row) {
+		REQUIRE(std::is_sorted(c.columnIndices().begin() + offsets[row], c.columnIndices().begin() + offsets[row + 1]));
+	}
+}
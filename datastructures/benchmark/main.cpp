@@ -0,0 +1,603 @@
+#include "heap/heap.hpp"
+#include "heap/multi_queue.hpp"
+#include "heap/pairing_heap.hpp"
+#include "heap/leftist_heap.hpp"
+#include "heap/radix_heap.hpp"
+#include "heap/indexed_heap.hpp"
+#include "heap/keyed_heap.hpp"
+#include "timer/timer_wheel.hpp"
+#include "redblack/redblack.hpp"
+#include "map/map.hpp"
+#include "timer.hpp"
+#include <cstdint>
+#include <cstdlib>
+#include <vector>
+#include <queue>
+#include <set>
+#include <map>
+#include <random>
+#include <iostream>
+#include <iomanip>
+#include <functional>
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <mutex>
+
+/*
+Timer queue entry: the earliest deadline is on top */
+struct TimerEntry {
+	std::uint64_t deadline;
+	std::uint64_t id;
+};
+
+struct LaterDeadline {
+	bool operator()(const TimerEntry& a, const TimerEntry& b) const {
+		return a.deadline > b.deadline;
+	}
+};
+
+template <typename Function, typename... Args>
+double Benchmark(Function func, Args&&... args) {
+	util::Timer timer;
+	func(std::forward<Args>(args)...);
+	return timer.elapsed();
+}
+
+/*
+Fill the queue with n timers, then n times: expire the earliest timer and re-arm it
+(the steady state of a timer queue), then expire everything */
+template <typename Queue>
+void benchmarkTimerQueue(const std::string& name, std::size_t n) {
+	std::mt19937_64 rng {42};
+	std::uniform_int_distribution<std::uint64_t> delay {1, 1000000};
+	Queue q;
+	std::uint64_t checksum = 0;
+	double fill = Benchmark([&]() {
+		for (std::size_t i = 0; i < n; ++i) {
+			q.push(TimerEntry {delay(rng), i});
+		}
+	});
+	double rearm = Benchmark([&]() {
+		for (std::size_t i = 0; i < n; ++i) {
+			TimerEntry e = q.top();
+			q.pop();
+			checksum += e.id;
+			e.deadline += delay(rng);
+			q.push(e);
+		}
+	});
+	double drain = Benchmark([&]() {
+		while (!q.empty()) {
+			checksum += q.top().deadline;
+			q.pop();
+		}
+	});
+	std::cout << "  " << std::setw(16) << std::left << name << std::fixed << std::setprecision(3)
+		<< " fill: " << fill << " rearm: " << rearm << " drain: " << drain
+		<< " (" << checksum % 1000 << ")" << std::endl;
+}
+
+void benchmarkHeapArity(std::size_t n) {
+	using Entries = std::vector<TimerEntry>;
+	std::cout << __FUNCTION__ << ": " << n << std::endl;
+	benchmarkTimerQueue<std::priority_queue<TimerEntry, Entries, LaterDeadline>>("std", n);
+	benchmarkTimerQueue<DSA::Heap<TimerEntry, Entries, LaterDeadline, 2>>("arity 2", n);
+	benchmarkTimerQueue<DSA::Heap<TimerEntry, Entries, LaterDeadline, 4>>("arity 4", n);
+	benchmarkTimerQueue<DSA::Heap<TimerEntry, Entries, LaterDeadline, 8>>("arity 8", n);
+	benchmarkTimerQueue<DSA::Heap<TimerEntry, Entries, LaterDeadline,
+		DSA::cacheLineArity<TimerEntry>()>>("cache line", n);
+}
+
+std::vector<std::string> randomJobs(std::size_t n) {
+	std::mt19937_64 rng {7};
+	std::vector<std::string> jobs;
+	for (std::size_t i = 0; i < n; ++i) {
+		// longer than the small string buffer, so copies allocate
+		jobs.push_back(std::to_string(rng()) + std::string(32, 'x'));
+	}
+	return jobs;
+}
+
+/*
+Consume every job of a heap of strings: copy the top before pop(), or pop_value() */
+void benchmarkStringJobs(std::size_t n) {
+	const std::vector<std::string> jobs {randomJobs(n)};
+	std::size_t total = 0;
+	std::cout << __FUNCTION__ << ": " << n << std::endl;
+
+	std::priority_queue<std::string> pq {jobs.begin(), jobs.end()};
+	double std_time = Benchmark([&]() {
+		while (!pq.empty()) {
+			std::string job = pq.top();
+			pq.pop();
+			total += job.size();
+		}
+	});
+	DSA::Heap<std::string> copied {jobs.begin(), jobs.end()};
+	double copy_time = Benchmark([&]() {
+		while (!copied.empty()) {
+			std::string job = copied.top();
+			copied.pop();
+			total += job.size();
+		}
+	});
+	DSA::Heap<std::string> moved {jobs.begin(), jobs.end()};
+	double move_time = Benchmark([&]() {
+		while (!moved.empty()) {
+			total += moved.pop_value().size();
+		}
+	});
+	DSA::Heap<std::string> replaced {jobs.begin(), jobs.end()};
+	double replace_time = Benchmark([&]() {
+		for (std::size_t i = 0; i < n; ++i) {
+			total += replaced.replace_top(jobs[i]).size();
+		}
+	});
+	std::cout << std::fixed << std::setprecision(3)
+		<< "  std top + pop: " << std_time << std::endl
+		<< "  top + pop:     " << copy_time << std::endl
+		<< "  pop_value:     " << move_time << std::endl
+		<< "  replace_top:   " << replace_time << " (" << total % 1000 << ")" << std::endl;
+}
+
+/*
+Global mutex around a Heap, the baseline for the MultiQueue */
+class LockedHeap {
+public:
+	void push(std::uint64_t v) {
+		std::lock_guard<std::mutex> guard {lock};
+		heap.push(v);
+	}
+
+	bool try_pop(std::uint64_t& out) {
+		std::lock_guard<std::mutex> guard {lock};
+		if (heap.empty()) {
+			return false;
+		}
+		out = heap.pop_value();
+		return true;
+	}
+
+private:
+	std::mutex lock;
+	DSA::Heap<std::uint64_t, std::vector<std::uint64_t>, std::greater<std::uint64_t>> heap;
+};
+
+/*
+Every thread repeatedly pops a job and pushes a later one: million operations per second */
+template <typename Queue>
+double queueThroughput(Queue& q, std::size_t threads, std::size_t operations) {
+	for (std::size_t i = 0; i < operations / 4; ++i) {
+		q.push(i);
+	}
+	std::vector<std::thread> workers;
+	double time = Benchmark([&]() {
+		for (std::size_t t = 0; t < threads; ++t) {
+			workers.emplace_back([&q, t, threads, operations]() {
+				std::uint64_t v = t;
+				for (std::size_t i = 0; i < operations / threads; ++i) {
+					q.try_pop(v);
+					q.push(v + 1 + i % 1000);
+				}
+			});
+		}
+		for (std::thread& w : workers) {
+			w.join();
+		}
+	});
+	return operations * 2 / time / 1e6;
+}
+
+void benchmarkConcurrentQueue(std::size_t operations, std::size_t max_threads) {
+	using Queue = DSA::MultiQueue<std::uint64_t, std::greater<std::uint64_t>>;
+	std::cout << __FUNCTION__ << ": " << operations << " (Mops/s)" << std::endl;
+	for (std::size_t threads = 1; threads <= max_threads; threads *= 2) {
+		LockedHeap locked;
+		Queue multi {threads};
+		double locked_ops = queueThroughput(locked, threads, operations);
+		double multi_ops = queueThroughput(multi, threads, operations);
+		std::cout << "  threads " << std::setw(2) << std::right << threads << std::fixed << std::setprecision(2)
+			<< " mutex: " << locked_ops << " multiqueue: " << multi_ops << std::endl;
+	}
+}
+
+/*
+Fill per-shard queues, merge them into one and drain it */
+template <typename Queue, typename Merge>
+void benchmarkShards(const std::string& name, std::size_t n, std::size_t shards, Merge merge) {
+	std::mt19937_64 rng {3};
+	std::vector<Queue> queues(shards);
+	std::uint64_t checksum = 0;
+	double fill = Benchmark([&]() {
+		for (std::size_t i = 0; i < n; ++i) {
+			queues[i % shards].push(rng());
+		}
+	});
+	Queue merged;
+	double meld = Benchmark([&]() {
+		for (Queue& q : queues) {
+			merge(merged, q);
+		}
+	});
+	double drain = Benchmark([&]() {
+		while (!merged.empty()) {
+			checksum += merged.top();
+			merged.pop();
+		}
+	});
+	std::cout << "  " << std::setw(16) << std::left << name << std::fixed << std::setprecision(3)
+		<< " fill: " << fill << " merge: " << meld << " drain: " << drain
+		<< " (" << checksum % 1000 << ")" << std::endl;
+}
+
+void benchmarkMerge(std::size_t n, std::size_t shards) {
+	using Value = std::uint64_t;
+	std::cout << __FUNCTION__ << ": " << n << ", " << shards << " shards" << std::endl;
+	benchmarkShards<DSA::Heap<Value>>("heap", n, shards, [](DSA::Heap<Value>& to, DSA::Heap<Value>& from) {
+		while (!from.empty()) {
+			to.push(from.pop_value());
+		}
+	});
+	benchmarkShards<DSA::PairingHeap<Value>>("pairing heap", n, shards,
+		[](DSA::PairingHeap<Value>& to, DSA::PairingHeap<Value>& from) {
+		to.merge(from);
+	});
+	benchmarkShards<DSA::LeftistHeap<Value>>("leftist heap", n, shards,
+		[](DSA::LeftistHeap<Value>& to, DSA::LeftistHeap<Value>& from) {
+		to.merge(from);
+	});
+}
+
+/*
+Monotone key stream, as produced by Dijkstra: pop the minimum and push
+keys at the popped key plus a random edge weight below `range` */
+template <typename Pop, typename Push>
+double monotoneStream(const std::vector<std::uint32_t>& weights, std::size_t live, Pop pop, Push push) {
+	for (std::size_t i = 0; i < live; ++i) {
+		push(weights[i], static_cast<std::uint32_t>(i));
+	}
+	std::uint64_t checksum = 0;
+	double time = Benchmark([&]() {
+		for (std::size_t i = live; i + 1 < weights.size(); i += 2) {
+			std::uint64_t key = pop();
+			checksum += key;
+			push(key + weights[i], static_cast<std::uint32_t>(i));
+			if (i % 4 == 0) {
+				push(key + weights[i + 1], static_cast<std::uint32_t>(i + 1));
+			} else {
+				checksum += pop();
+			}
+		}
+	});
+	std::cout << "(" << checksum % 1000 << ") ";
+	return time;
+}
+
+void benchmarkRadixHeap(std::size_t n, std::uint32_t range) {
+	using Entry = std::pair<std::uint64_t, std::uint32_t>;
+	std::mt19937 rng {11};
+	std::vector<std::uint32_t> weights(n);
+	for (std::uint32_t& w : weights) {
+		w = rng() % range;
+	}
+	const std::size_t live = n / 100;
+	std::cout << __FUNCTION__ << ": " << n << ", weights below " << range << std::endl << "  ";
+
+	DSA::Heap<Entry, std::vector<Entry>, std::greater<Entry>> binary;
+	double binary_time = monotoneStream(weights, live,
+		[&]() { return binary.pop_value().first; },
+		[&](std::uint64_t key, std::uint32_t v) { binary.push(Entry(key, v)); });
+	DSA::Heap<Entry, std::vector<Entry>, std::greater<Entry>, 4> quaternary;
+	double quaternary_time = monotoneStream(weights, live,
+		[&]() { return quaternary.pop_value().first; },
+		[&](std::uint64_t key, std::uint32_t v) { quaternary.push(Entry(key, v)); });
+	DSA::RadixHeap<std::uint64_t, std::uint32_t> radix;
+	double radix_time = monotoneStream(weights, live,
+		[&]() { return radix.pop_value().first; },
+		[&](std::uint64_t key, std::uint32_t v) { radix.push(key, v); });
+	std::cout << std::endl << std::fixed << std::setprecision(3)
+		<< "  heap:       " << binary_time << std::endl
+		<< "  heap 4-ary: " << quaternary_time << std::endl
+		<< "  radix heap: " << radix_time << std::endl;
+}
+
+/*
+Appending k elements to a heap of n: k pushes against push_range.
+Ascending elements are the worst case for push: each one rises to the root */
+void benchmarkPushRange(std::size_t n, std::size_t k, bool ascending = false) {
+	std::mt19937 rng {5};
+	std::vector<std::uint32_t> base(n);
+	std::vector<std::uint32_t> batch(k);
+	for (std::uint32_t& x : base) {
+		x = rng();
+	}
+	for (std::uint32_t& x : batch) {
+		x = rng();
+	}
+	if (ascending) {
+		std::sort(batch.begin(), batch.end());
+	}
+	std::cout << __FUNCTION__ << ": " << n << " + " << k << (ascending ? " ascending" : "") << std::endl;
+	DSA::Heap<std::uint32_t> pushed {base.begin(), base.end()};
+	double push_time = Benchmark([&]() {
+		for (std::uint32_t x : batch) {
+			pushed.push(x);
+		}
+	});
+	DSA::Heap<std::uint32_t> ranged {base.begin(), base.end()};
+	double range_time = Benchmark([&]() {
+		ranged.push_range(batch.begin(), batch.end());
+	});
+	std::cout << std::fixed << std::setprecision(4)
+		<< "  push:       " << push_time << std::endl
+		<< "  push_range: " << range_time << std::endl;
+}
+
+/*
+Timeouts that are mostly cancelled: every tick schedules `per_tick` timers with a delay
+below `horizon`, 90% of them are cancelled in batches every 64 ticks, before they fire.
+Scheduler is called as schedule(deadline, id), cancel(id) and expire(now) */
+template <typename Schedule, typename Cancel, typename Expire>
+double cancellationWorkload(std::size_t timers, std::size_t per_tick, std::uint64_t horizon,
+							Schedule schedule, Cancel cancel, Expire expire) {
+	std::mt19937_64 rng {13};
+	std::vector<std::uint32_t> to_cancel;
+	return Benchmark([&]() {
+		std::uint64_t now = 0;
+		std::size_t id = 0;
+		while (id < timers) {
+			++now;
+			for (std::size_t i = 0; i < per_tick && id < timers; ++i, ++id) {
+				schedule(now + 65 + rng() % horizon, static_cast<std::uint32_t>(id));
+				if (rng() % 10 != 0) {
+					to_cancel.push_back(static_cast<std::uint32_t>(id));
+				}
+			}
+			if (now % 64 == 0) {
+				for (std::uint32_t x : to_cancel) {
+					cancel(x);
+				}
+				to_cancel.clear();
+			}
+			expire(now);
+		}
+	});
+}
+
+void benchmarkTimerWheel(std::size_t timers, std::size_t per_tick, std::uint64_t horizon) {
+	struct Timer {
+		std::uint64_t deadline;
+		std::uint32_t id;
+	};
+	struct LaterTimer {
+		bool operator()(const Timer& a, const Timer& b) const {
+			return a.deadline > b.deadline;
+		}
+	};
+	std::cout << __FUNCTION__ << ": " << timers << " timers, 90% cancelled" << std::endl;
+	std::size_t fired = 0;
+
+	DSA::Heap<Timer, std::vector<Timer>, LaterTimer, 4> heap;
+	std::vector<bool> cancelled(timers, false);
+	double heap_time = cancellationWorkload(timers, per_tick, horizon,
+		[&](std::uint64_t deadline, std::uint32_t id) { heap.push(Timer {deadline, id}); },
+		[&](std::uint32_t id) { cancelled[id] = true; },
+		[&](std::uint64_t now) {
+			while (!heap.empty() && heap.top().deadline <= now) {
+				fired += !cancelled[heap.pop_value().id];
+			}
+		});
+	std::size_t heap_fired = fired;
+
+	DSA::IndexedHeap<std::uint64_t, std::greater<std::uint64_t>, 4> indexed;
+	indexed.reserve(timers);
+	fired = 0;
+	double indexed_time = cancellationWorkload(timers, per_tick, horizon,
+		[&](std::uint64_t deadline, std::uint32_t id) { indexed.push(id, deadline); },
+		[&](std::uint32_t id) { indexed.erase(id); },
+		[&](std::uint64_t now) {
+			while (!indexed.empty() && indexed.top() <= now) {
+				indexed.pop();
+				++fired;
+			}
+		});
+	std::size_t indexed_fired = fired;
+
+	DSA::TimerWheel<std::uint32_t> wheel;
+	std::vector<DSA::TimerHandle> handles(timers);
+	fired = 0;
+	double wheel_time = cancellationWorkload(timers, per_tick, horizon,
+		[&](std::uint64_t deadline, std::uint32_t id) { handles[id] = wheel.schedule(deadline, id); },
+		[&](std::uint32_t id) { wheel.cancel(handles[id]); },
+		[&](std::uint64_t now) {
+			wheel.advance(now, [&](std::uint64_t, std::vector<std::uint32_t>& batch) { fired += batch.size(); });
+		});
+	std::cout << std::fixed << std::setprecision(3)
+		<< "  heap, lazy cancel:  " << heap_time << " (" << heap_fired << " fired)" << std::endl
+		<< "  indexed heap erase: " << indexed_time << " (" << indexed_fired << " fired)" << std::endl
+		<< "  timer wheel:        " << wheel_time << " (" << fired << " fired)" << std::endl;
+}
+
+/*
+256-byte job descriptors ordered by priority: whole jobs in a Heap against
+keys and payload indices in a KeyedHeap */
+struct Job {
+	std::uint64_t priority;
+	char descriptor[248];
+};
+
+struct LowerPriority {
+	bool operator()(const Job& a, const Job& b) const {
+		return a.priority < b.priority;
+	}
+};
+
+void benchmarkKeyedHeap(std::size_t n) {
+	std::mt19937_64 rng {17};
+	std::vector<std::uint64_t> priorities(n);
+	for (std::uint64_t& p : priorities) {
+		p = rng();
+	}
+	std::cout << __FUNCTION__ << ": " << n << " jobs of " << sizeof(Job) << " bytes" << std::endl;
+	std::uint64_t checksum = 0;
+	Job job {};
+
+	DSA::Heap<Job, std::vector<Job>, LowerPriority> jobs;
+	double heap_time = Benchmark([&]() {
+		for (std::uint64_t p : priorities) {
+			job.priority = p;
+			jobs.push(job);
+		}
+		while (!jobs.empty()) {
+			checksum += jobs.pop_value().priority;
+		}
+	});
+	DSA::Heap<Job, std::vector<Job>, LowerPriority, 4> jobs4;
+	double heap4_time = Benchmark([&]() {
+		for (std::uint64_t p : priorities) {
+			job.priority = p;
+			jobs4.push(job);
+		}
+		while (!jobs4.empty()) {
+			checksum += jobs4.pop_value().priority;
+		}
+	});
+	DSA::KeyedHeap<std::uint64_t, Job> keyed;
+	double keyed_time = Benchmark([&]() {
+		for (std::uint64_t p : priorities) {
+			job.priority = p;
+			keyed.push(p, job);
+		}
+		while (!keyed.empty()) {
+			checksum += keyed.pop_value().priority;
+		}
+	});
+	std::cout << std::fixed << std::setprecision(3)
+		<< "  heap:        " << heap_time << std::endl
+		<< "  heap 4-ary:  " << heap4_time << std::endl
+		<< "  keyed heap:  " << keyed_time << " (" << checksum % 1000 << ")" << std::endl;
+}
+
+/*
+Node-based insertion, lookup and teardown: RedBlackTree against std::set */
+template <typename Set>
+void benchmarkTree(const char* name, const std::vector<int>& values) {
+	Set s;
+	std::size_t found = 0;
+	double insert_time = Benchmark([&]() {
+		for (int v : values) {
+			s.insert(v);
+		}
+	});
+	double find_time = Benchmark([&]() {
+		for (int v : values) {
+			found += s.find(v) != s.end();
+		}
+	});
+	double clear_time = Benchmark([&]() {
+		s.clear();
+	});
+	std::cout << "  " << std::setw(16) << std::left << name << std::fixed << std::setprecision(3)
+		<< "insert " << insert_time << ", find " << find_time << ", clear " << clear_time
+		<< " (" << found << ")" << std::endl;
+}
+
+void benchmarkRedBlackTree(std::size_t n) {
+	std::mt19937 rng {23};
+	std::vector<int> values(n);
+	for (int& v : values) {
+		v = static_cast<int>(rng());
+	}
+	std::cout << __FUNCTION__ << ": " << n << ", " << sizeof(RedBlackNode<int>) << " bytes per node" << std::endl;
+	benchmarkTree<std::set<int>>("std::set", values);
+	benchmarkTree<RedBlackTree<int>>("RedBlackTree", values);
+}
+
+/*
+Loading sorted keys: one insert per key against the linear bulk build */
+void benchmarkSortedBuild(std::size_t n) {
+	std::vector<int> values(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		values[i] = static_cast<int>(i * 2);
+	}
+	std::cout << __FUNCTION__ << ": " << n << std::endl;
+	std::size_t size = 0;
+	double insert_time = Benchmark([&]() {
+		RedBlackTree<int> s;
+		for (int v : values) {
+			s.insert(v);
+		}
+		size += s.size();
+	});
+	double build_time = Benchmark([&]() {
+		RedBlackTree<int> s(values.begin(), values.end());
+		size += s.size();
+	});
+	std::cout << std::fixed << std::setprecision(3)
+		<< "  insert:      " << insert_time << std::endl
+		<< "  bulk build:  " << build_time << " (" << size << ")" << std::endl;
+}
+
+template <class Map>
+void benchmarkMap(const char* name, const std::vector<int>& keys) {
+	std::size_t size = 0;
+	double hinted = Benchmark([&]() {
+		Map m;
+		for (int k : keys) {
+			m.emplace_hint(m.end(), k, k);
+		}
+		size += m.size();
+	});
+	double unhinted = Benchmark([&]() {
+		Map m;
+		for (int k : keys) {
+			m.emplace(k, k);
+		}
+		size += m.size();
+	});
+	Map m;
+	for (int k : keys) {
+		m.emplace_hint(m.end(), k, k);
+	}
+	double repeated = Benchmark([&]() {
+		for (int k : keys) {
+			size += m[k] == k;
+		}
+	});
+	std::cout << std::fixed << std::setprecision(3) << "  " << name << std::endl
+		<< "    hinted insert:      " << hinted << std::endl
+		<< "    insert:             " << unhinted << std::endl
+		<< "    operator[] (hit):   " << repeated << " (" << size << ")" << std::endl;
+}
+
+void benchmarkOrderedMap(std::size_t n) {
+	std::vector<int> keys(n);
+	for (std::size_t i = 0; i < n; ++i) {
+		keys[i] = static_cast<int>(i);
+	}
+	std::cout << __FUNCTION__ << ": " << n << std::endl;
+	benchmarkMap<std::map<int, int>>("std::map", keys);
+	benchmarkMap<DSA::map<int, int>>("DSA::map", keys);
+}
+
+int main(int argc, char** argv) {
+	std::size_t n = argc > 1 ? std::strtoull(argv[1], NULL, 10) : 10000000;
+
+	benchmarkHeapArity(n);
+	benchmarkStringJobs(n / 10);
+	benchmarkConcurrentQueue(n / 2, 64);
+	benchmarkMerge(n / 10, 64);
+	benchmarkRadixHeap(n, 1000);
+	benchmarkRadixHeap(n, 1 << 30);
+	benchmarkPushRange(n, n / 100);
+	benchmarkPushRange(n, n / 10);
+	benchmarkPushRange(n / 10, n);
+	benchmarkPushRange(n, n / 10, true);
+	benchmarkTimerWheel(n, 100, 20000);
+	benchmarkKeyedHeap(n / 10);
+	benchmarkRedBlackTree(n);
+	benchmarkSortedBuild(n);
+	benchmarkOrderedMap(n);
+	return 0;
+}
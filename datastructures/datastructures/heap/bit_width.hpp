@@ -0,0 +1,29 @@
+#ifndef BIT_WIDTH_HPP
+#define BIT_WIDTH_HPP
+
+#include <cstddef>
+#include <cstdint>
+
+namespace DSA {
+
+	namespace HeapDetail {
+
+	/*
+	Number of bits needed to represent x, 0 for 0 */
+	inline std::size_t bitWidth(std::uint64_t x) {
+#if defined(__GNUC__)
+		return x == 0 ? 0 : 64 - __builtin_clzll(x);
+#else
+		std::size_t width = 0;
+		for (; x != 0; x >>= 1) {
+			++width;
+		}
+		return width;
+#endif
+	}
+
+	}
+
+}
+
+#endif /* BIT_WIDTH_HPP */
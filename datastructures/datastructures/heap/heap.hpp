@@ -5,96 +5,256 @@
 #include <vector>
 #include <functional>
 #include <algorithm>
+#include <iterator>
+#include <cstddef>
 
 namespace DSA {
 
 	namespace HeapDetail {
-	
-	std::size_t parentIndex(std::size_t index);
-	std::size_t leftChildIndex(std::size_t index);
-	std::size_t rightChildIndex(std::size_t index);
-
-	template <typename RandomIt, typename Compare>
-	void heapifyDown(RandomIt first, RandomIt last, Compare comp, std::size_t index) {
-		std::size_t size = std::distance(first, last) - 1;
-		while (index < size) {
-			std::size_t left = HeapDetail::leftChildIndex(index);
-			std::size_t right = HeapDetail::rightChildIndex(index);
-			// if index is a leaf or greater than all it's children
-			if (left >= size ||
-					(comp(first[left], first[index])
-						&& (right >= size || comp(first[right], first[index])))) {
+
+	/*
+	Index math of an Arity-ary heap stored in an array: the children of index i
+	are Arity * i + 1 ... Arity * i + Arity, they are contiguous, so that a larger arity
+	reads the children of a node from one or two cache lines and halves the height (4-ary) or
+	thirds it (8-ary) compared to a binary heap. */
+	template <std::size_t Arity>
+	constexpr std::size_t parentIndex(std::size_t index) {
+		return (index - 1) / Arity;
+	}
+
+	template <std::size_t Arity>
+	constexpr std::size_t firstChildIndex(std::size_t index) {
+		return index * Arity + 1;
+	}
+
+	/*
+	Called with every index that received another element, so that a container
+	keeping track of where its elements are (IndexedHeap) can use the same sifts */
+	struct NoTracking {
+		void operator()(std::size_t) const {}
+	};
+
+	/*
+	Places value in the hole at `index` within the first `size` elements, moving the hole down:
+	the larger child moves up into the hole, one move per level instead of a swap (three moves) */
+	template <std::size_t Arity, typename RandomIt, typename Compare, typename T, typename Track>
+	void siftHoleDown(RandomIt first, std::size_t size, Compare comp, std::size_t index, T&& value, Track track) {
+		static_assert(Arity >= 2, "a heap needs at least two children per node");
+		while (true) {
+			const std::size_t child = HeapDetail::firstChildIndex<Arity>(index);
+			if (child >= size) {
 				break;
 			}
-			// if left is greater than right or only left exists, swap left
-			if (right >= size || comp(first[right], first[left])) {
-				std::swap(first[index], first[left]);
-				index = left;
-			} else if (right < size) {
-				std::swap(first[index], first[right]);
-				index = right;
+			// largest child: a conditional move instead of a branch, the outcome is random.
+			// Every node but the last has Arity children, that loop has a constant bound and is unrolled
+			std::size_t largest = child;
+			if (child + Arity <= size) {
+				for (std::size_t i = child + 1; i < child + Arity; ++i) {
+					largest = comp(first[largest], first[i]) ? i : largest;
+				}
+			} else {
+				for (std::size_t i = child + 1; i < size; ++i) {
+					largest = comp(first[largest], first[i]) ? i : largest;
+				}
+			}
+			if (!comp(value, first[largest])) {
+				break;
+			}
+			first[index] = std::move(first[largest]);
+			track(index);
+			index = largest;
+		}
+		first[index] = std::forward<T>(value);
+		track(index);
+	}
+
+	/*
+	Sifts first[index] down within the first `size` elements */
+	template <std::size_t Arity, typename RandomIt, typename Compare, typename Track>
+	void heapifyDown(RandomIt first, std::size_t size, Compare comp, std::size_t index, Track track) {
+		typename std::iterator_traits<RandomIt>::value_type value = std::move(first[index]);
+		HeapDetail::siftHoleDown<Arity>(first, size, comp, index, std::move(value), track);
+	}
+
+	template <std::size_t Arity, typename RandomIt, typename Compare>
+	void heapifyDown(RandomIt first, std::size_t size, Compare comp, std::size_t index) {
+		HeapDetail::heapifyDown<Arity>(first, size, comp, index, NoTracking());
+	}
+
+	/*
+	Sifts first[index] up towards the root, parents move down into the hole */
+	template <std::size_t Arity, typename RandomIt, typename Compare, typename Track>
+	void heapifyUp(RandomIt first, Compare comp, std::size_t index, Track track) {
+		if (index == 0 || !comp(first[HeapDetail::parentIndex<Arity>(index)], first[index])) {
+			track(index);
+			return;
+		}
+		typename std::iterator_traits<RandomIt>::value_type value = std::move(first[index]);
+		do {
+			const std::size_t parent = HeapDetail::parentIndex<Arity>(index);
+			first[index] = std::move(first[parent]);
+			track(index);
+			index = parent;
+		} while (index != 0 && comp(first[HeapDetail::parentIndex<Arity>(index)], value));
+		first[index] = std::move(value);
+		track(index);
+	}
+
+	/*
+	Number of levels of an Arity-ary heap of `size` elements */
+	template <std::size_t Arity>
+	std::size_t heapHeight(std::size_t size) {
+		std::size_t height = 0;
+		for (std::size_t level = 1; size > 0; level *= Arity) {
+			size = size > level ? size - level : 0;
+			++height;
+		}
+		return height;
+	}
+
+	/*
+	first[0, middle) is a heap, first[middle, size) was appended.
+	Sifts down the ancestors of the new elements, a level at a time from the bottom:
+	like make_heap, restricted to the nodes whose subtree changed.
+	Subtrees without a new element are still heaps, so O(k + log^2 n) for k new elements. */
+	template <std::size_t Arity, typename RandomIt, typename Compare>
+	void heapifyTail(RandomIt first, std::size_t middle, std::size_t size, Compare comp) {
+		if (middle == 0) {
+			middle = 1;
+		}
+		std::size_t low = HeapDetail::parentIndex<Arity>(middle);
+		std::size_t high = HeapDetail::parentIndex<Arity>(size - 1);
+		while (true) {
+			for (std::size_t i = high + 1; i > low; --i) {
+				HeapDetail::heapifyDown<Arity>(first, size, comp, i - 1);
+			}
+			if (low == 0) {
+				break;
 			}
+			// parents of this level, without the ones already sifted above
+			const std::size_t next_low = HeapDetail::parentIndex<Arity>(low);
+			high = std::min(HeapDetail::parentIndex<Arity>(high), low - 1);
+			low = next_low;
 		}
 	}
 
 	}
 
-template <class RandomIt, class Compare,
+/*
+Number of children per node such that the children of a node fill one cache line */
+template <typename T>
+constexpr std::size_t cacheLineArity() {
+	return 64 / sizeof(T) < 2 ? 2 : (64 / sizeof(T) > 16 ? 16 : 64 / sizeof(T));
+}
+
+/*
+The primitives take the arity as their first template argument: DSA::make_heap<4>(first, last, comp).
+The default is a binary heap, compatible with std::make_heap. */
+template <std::size_t Arity = 2, class RandomIt, class Compare,
 	RequireRandomAccessIterator<RandomIt> = true>
 void make_heap(RandomIt first, RandomIt last, Compare comp) {
-	if (first == last) {
+	const std::size_t size = std::distance(first, last);
+	if (size < 2) {
 		return;
 	}
-	std::size_t size = std::distance(first, last) - 1;
-	std::size_t index = HeapDetail::parentIndex(size);
-	while (index <= size) {
-		HeapDetail::heapifyDown(first, last, comp, index);
+	std::size_t index = HeapDetail::parentIndex<Arity>(size - 1) + 1;
+	while (index > 0) {
 		--index;
+		HeapDetail::heapifyDown<Arity>(first, size, comp, index);
 	}
 }
 
-template <class RandomIt>
+template <std::size_t Arity = 2, class RandomIt>
 void make_heap(RandomIt first, RandomIt last) {
-	make_heap(first, last, std::less<decltype(*first)>());
+	DSA::make_heap<Arity>(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
 }
 
-template <class RandomIt, class Compare,
+template <std::size_t Arity = 2, class RandomIt, class Compare,
 	RequireRandomAccessIterator<RandomIt> = true>
 void push_heap(RandomIt first, RandomIt last, Compare comp) {
-	std::size_t index = std::distance(first, last) - 1;
-	std::size_t parent = HeapDetail::parentIndex(index);
-	while (index != 0 && comp(first[parent], first[index])) {
-		std::swap(first[index], first[parent]);
-		index = parent;
-		parent = HeapDetail::parentIndex(index);
+	if (first == last) {
+		return;
 	}
+	HeapDetail::heapifyUp<Arity>(first, comp, std::distance(first, last) - 1, HeapDetail::NoTracking());
 }
 
-template <class RandomIt>
+template <std::size_t Arity = 2, class RandomIt>
 void push_heap(RandomIt first, RandomIt last) {
-	push_heap(first, last, std::less<decltype(*first)>());
+	DSA::push_heap<Arity>(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
 }
 
-template <class RandomIt, class Compare,
+template <std::size_t Arity = 2, class RandomIt, class Compare,
 	RequireRandomAccessIterator<RandomIt> = true>
 void pop_heap(RandomIt first, RandomIt last, Compare comp) {
-	std::swap(*first, *(last - 1));
-	HeapDetail::heapifyDown(first, last, comp, 0);
+	const std::size_t size = std::distance(first, last);
+	if (size < 2) {
+		return;
+	}
+	typename std::iterator_traits<RandomIt>::value_type value = std::move(*(last - 1));
+	*(last - 1) = std::move(*first);
+	HeapDetail::siftHoleDown<Arity>(first, size - 1, comp, 0, std::move(value), HeapDetail::NoTracking());
 }
 
-template <class RandomIt>
+template <std::size_t Arity = 2, class RandomIt>
 void pop_heap(RandomIt first, RandomIt last) {
-	pop_heap(first, last, std::less<decltype(*first)>());
+	DSA::pop_heap<Arity>(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/*
+[first, middle) is a heap and [middle, last) are new elements: makes [first, last) a heap.
+A few elements are sifted up one by one, more are inserted with a batched sift
+of the tail and as many as the heap holds with a complete rebuild. */
+template <std::size_t Arity = 2, class RandomIt, class Compare,
+	RequireRandomAccessIterator<RandomIt> = true>
+void push_heap_range(RandomIt first, RandomIt middle, RandomIt last, Compare comp) {
+	const std::size_t n = std::distance(first, middle);
+	const std::size_t size = std::distance(first, last);
+	const std::size_t k = size - n;
+	if (k <= HeapDetail::heapHeight<Arity>(n)) {
+		for (std::size_t i = n; i < size; ++i) {
+			HeapDetail::heapifyUp<Arity>(first, comp, i, HeapDetail::NoTracking());
+		}
+	} else if (k >= n) {
+		DSA::make_heap<Arity>(first, last, comp);
+	} else {
+		HeapDetail::heapifyTail<Arity>(first, n, size, comp);
+	}
+}
+
+template <std::size_t Arity = 2, class RandomIt>
+void push_heap_range(RandomIt first, RandomIt middle, RandomIt last) {
+	DSA::push_heap_range<Arity>(first, middle, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
+}
+
+/*
+Checks the heap property of an Arity-ary heap */
+template <std::size_t Arity = 2, class RandomIt, class Compare,
+	RequireRandomAccessIterator<RandomIt> = true>
+bool is_heap(RandomIt first, RandomIt last, Compare comp) {
+	const std::size_t size = std::distance(first, last);
+	for (std::size_t i = 1; i < size; ++i) {
+		if (comp(first[HeapDetail::parentIndex<Arity>(i)], first[i])) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <std::size_t Arity = 2, class RandomIt>
+bool is_heap(RandomIt first, RandomIt last) {
+	return DSA::is_heap<Arity>(first, last, std::less<typename std::iterator_traits<RandomIt>::value_type>());
 }
 
 template <
 	typename T,
 	typename Container = std::vector<T>,
-	typename Compare = std::less<typename Container::value_type>
+	typename Compare = std::less<typename Container::value_type>,
+	std::size_t Arity = 2
 >
 class Heap {
 public:
 	static_assert(std::is_same<T, typename Container::value_type>::value, "invalid container");
+	static_assert(Arity >= 2, "a heap needs at least two children per node");
 public:
 	using container_type	= Container;
 	using value_compare		= Compare;
@@ -106,6 +266,8 @@ public:
 	using iterator			= typename Container::iterator;
 	using const_iterator	= typename Container::const_iterator;
 
+	static constexpr std::size_t arity = Arity;
+
 public:
 	Heap()
 	: Heap(Compare(), Container()) {}
@@ -269,10 +431,62 @@ Priority Queue functions */
 		heapifyUp();
 	}
 
+	/*
+	Appends [first, last) and restores the heap with push_heap_range:
+	one sift per element for a few elements, O(n + k) for many */
+	template <class InputIt,
+		RequireInputIterator<InputIt> = true>
+	void push_range(InputIt first, InputIt last) {
+		const size_type n = c.size();
+		c.insert(c.end(), first, last);
+		DSA::push_heap_range<Arity>(c.begin(), c.begin() + n, c.end(), comp);
+	}
+
+	/*
+	Moves the elements of other into this heap, the smaller heap is appended
+	to the larger one. other is left empty. */
+	void merge(Heap&& other) {
+		if (this == &other) {
+			return;
+		}
+		if (c.size() < other.c.size()) {
+			std::swap(c, other.c);
+		}
+		push_range(std::make_move_iterator(other.c.begin()), std::make_move_iterator(other.c.end()));
+		other.c.clear();
+	}
+
 	void pop() {
 		heapifyDown();
 	}
 
+	/*
+	Removes the top and returns it by move, instead of copying top() before pop() */
+	value_type pop_value() {
+		value_type v = std::move(c.front());
+		heapifyDown();
+		return v;
+	}
+
+	/*
+	Removes the top and inserts v in one sift, returns the old top.
+	The heap may not be empty. */
+	value_type replace_top(value_type v) {
+		value_type top = std::move(c.front());
+		siftDown(std::move(v));
+		return top;
+	}
+
+	/*
+	Inserts v and removes the top in one sift, returns the removed top:
+	v itself when the heap is empty or v would be the new top */
+	value_type pushpop(value_type v) {
+		if (c.empty() || !comp(v, c.front())) {
+			return v;
+		}
+		return replace_top(std::move(v));
+	}
+
 	void swap(Heap& other) noexcept {
 		std::swap(c, other.c);
 		std::swap(comp, other.comp);
@@ -284,15 +498,24 @@ Priority Queue functions */
 
 private:
 	void makeHeap() {
-		DSA::make_heap(c.begin(), c.end(), comp);
+		DSA::make_heap<Arity>(c.begin(), c.end(), comp);
 	}
 	void heapifyUp() {
-		DSA::push_heap(c.begin(), c.end(), comp);
+		DSA::push_heap<Arity>(c.begin(), c.end(), comp);
 	}
 
+	/*
+	The last element fills the hole left by the top, the top is not moved */
 	void heapifyDown() {
-		DSA::pop_heap(c.begin(), c.end(), comp);
+		value_type last = std::move(c.back());
 		c.pop_back();
+		if (!c.empty()) {
+			siftDown(std::move(last));
+		}
+	}
+
+	void siftDown(value_type&& v) {
+		HeapDetail::siftHoleDown<Arity>(c.begin(), c.size(), comp, 0, std::move(v), HeapDetail::NoTracking());
 	}
 
 protected:
@@ -300,13 +523,16 @@ protected:
 	container_type c;
 };
 
+template <typename T, typename Container, typename Compare, std::size_t Arity>
+constexpr std::size_t Heap<T, Container, Compare, Arity>::arity;
+
 }
 
 namespace std {
 
-template <class T, class Container, class Compare>
-void swap(  DSA::Heap<T, Container, Compare>& lhs,
-			DSA::Heap<T, Container, Compare>& rhs) {
+template <class T, class Container, class Compare, std::size_t Arity>
+void swap(  DSA::Heap<T, Container, Compare, Arity>& lhs,
+			DSA::Heap<T, Container, Compare, Arity>& rhs) {
 	lhs.swap(rhs);
 }
 
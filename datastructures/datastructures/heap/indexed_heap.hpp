@@ -0,0 +1,245 @@
+#ifndef INDEXED_HEAP_HPP
+#define INDEXED_HEAP_HPP
+
+#include "heap.hpp"
+#include <vector>
+#include <limits>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+
+namespace DSA {
+
+/*
+Priority queue of keys identified by dense ids (0, 1, 2 ...).
+
+Next to the heap, a position map from id to heap slot is kept up to date by
+the sifts of heap.hpp, so that the key of any element can be changed or the
+element removed in O(log n) instead of pushing a new entry and skipping
+the stale one when it reaches the top.
+
+Like Heap, the top is the greatest key according to Compare:
+increaseKey moves an element towards the top, decreaseKey away from it.
+For a min-queue (Compare = std::greater, e.g. Dijkstra) lowering a distance is an increaseKey;
+update() accepts a change in either direction. */
+template <
+	typename Key,
+	typename Compare = std::less<Key>,
+	std::size_t Arity = 2
+>
+class IndexedHeap {
+public:
+	static_assert(Arity >= 2, "a heap needs at least two children per node");
+public:
+	using key_type			= Key;
+	using key_compare		= Compare;
+	using size_type			= std::size_t;
+	using id_type			= std::size_t;
+
+	static constexpr std::size_t arity = Arity;
+
+private:
+	struct Entry {
+		id_type id;
+		key_type key;
+	};
+
+	struct EntryCompare {
+		EntryCompare(const Compare& comp)
+		: comp(comp) {}
+
+		bool operator()(const Entry& a, const Entry& b) const {
+			return comp(a.key, b.key);
+		}
+
+		Compare comp;
+	};
+
+	/*
+	Sift callback: the entry at `index` moved there */
+	struct Track {
+		Track(IndexedHeap& h)
+		: h(h) {}
+
+		void operator()(size_type index) const {
+			h.position[h.heap[index].id] = index;
+		}
+
+		IndexedHeap& h;
+	};
+
+	static constexpr size_type npos = std::numeric_limits<size_type>::max();
+
+public:
+	IndexedHeap()
+	: IndexedHeap(Compare()) {}
+
+	explicit IndexedHeap(const Compare& compare)
+	: comp(compare) {}
+
+	/*
+	Reserves room for the ids [0, ids) */
+	void reserve(size_type ids) {
+		heap.reserve(ids);
+		if (position.size() < ids) {
+			position.resize(ids, npos);
+		}
+	}
+
+	bool empty() const {
+		return heap.empty();
+	}
+
+	size_type size() const {
+		return heap.size();
+	}
+
+	bool contains(id_type id) const {
+		return id < position.size() && position[id] != npos;
+	}
+
+	const key_type& top() const {
+		return heap.front().key;
+	}
+
+	id_type topId() const {
+		return heap.front().id;
+	}
+
+	/*
+	Key of an element in the heap */
+	const key_type& key(id_type id) const {
+		assert(contains(id));
+		return heap[position[id]].key;
+	}
+
+	/*
+	Inserts id with its key, id may not be in the heap. O(log n) */
+	void push(id_type id, const key_type& key) {
+		emplace(id, key);
+	}
+
+	void push(id_type id, key_type&& key) {
+		emplace(id, std::move(key));
+	}
+
+	template <typename... Args>
+	void emplace(id_type id, Args&&... args) {
+		assert(!contains(id));
+		if (id >= position.size()) {
+			position.resize(id + 1, npos);
+		}
+		heap.push_back(Entry {id, key_type(std::forward<Args>(args)...)});
+		HeapDetail::heapifyUp<Arity>(heap.begin(), comp, heap.size() - 1, Track(*this));
+	}
+
+	void pop() {
+		erase(topId());
+	}
+
+	/*
+	Removes id from the heap, id must be in the heap. O(log n) */
+	void erase(id_type id) {
+		assert(contains(id));
+		const size_type index = position[id];
+		position[id] = npos;
+		if (index + 1 == heap.size()) {
+			heap.pop_back();
+			return;
+		}
+		heap[index] = std::move(heap.back());
+		heap.pop_back();
+		siftAny(index);
+	}
+
+	/*
+	The new key may not be smaller than the current one. O(log n) */
+	void increaseKey(id_type id, const key_type& key) {
+		assert(contains(id) && !comp.comp(key, this->key(id)));
+		const size_type index = position[id];
+		heap[index].key = key;
+		HeapDetail::heapifyUp<Arity>(heap.begin(), comp, index, Track(*this));
+	}
+
+	/*
+	The new key may not be greater than the current one. O(log n) */
+	void decreaseKey(id_type id, const key_type& key) {
+		assert(contains(id) && !comp.comp(this->key(id), key));
+		const size_type index = position[id];
+		heap[index].key = key;
+		HeapDetail::heapifyDown<Arity>(heap.begin(), heap.size(), comp, index, Track(*this));
+	}
+
+	/*
+	Changes the key of id in either direction. O(log n) */
+	void update(id_type id, const key_type& key) {
+		assert(contains(id));
+		const size_type index = position[id];
+		heap[index].key = key;
+		siftAny(index);
+	}
+
+	/*
+	Inserts id or changes its key */
+	void pushOrUpdate(id_type id, const key_type& key) {
+		if (contains(id)) {
+			update(id, key);
+		} else {
+			push(id, key);
+		}
+	}
+
+	void clear() {
+		for (const Entry& e : heap) {
+			position[e.id] = npos;
+		}
+		heap.clear();
+	}
+
+	void swap(IndexedHeap& other) noexcept {
+		std::swap(heap, other.heap);
+		std::swap(position, other.position);
+		std::swap(comp, other.comp);
+	}
+
+	key_compare key_comp() const {
+		return comp.comp;
+	}
+
+private:
+	/*
+	The entry at index has a new key: it moves up or down */
+	void siftAny(size_type index) {
+		if (index != 0 && comp(heap[HeapDetail::parentIndex<Arity>(index)], heap[index])) {
+			HeapDetail::heapifyUp<Arity>(heap.begin(), comp, index, Track(*this));
+		} else {
+			HeapDetail::heapifyDown<Arity>(heap.begin(), heap.size(), comp, index, Track(*this));
+		}
+	}
+
+private:
+	EntryCompare comp;
+	std::vector<Entry> heap;
+	std::vector<size_type> position;
+};
+
+template <typename Key, typename Compare, std::size_t Arity>
+constexpr std::size_t IndexedHeap<Key, Compare, Arity>::arity;
+
+template <typename Key, typename Compare, std::size_t Arity>
+constexpr std::size_t IndexedHeap<Key, Compare, Arity>::npos;
+
+}
+
+namespace std {
+
+template <class Key, class Compare, std::size_t Arity>
+void swap(  DSA::IndexedHeap<Key, Compare, Arity>& lhs,
+			DSA::IndexedHeap<Key, Compare, Arity>& rhs) {
+	lhs.swap(rhs);
+}
+
+}
+
+#endif /* INDEXED_HEAP_HPP */
@@ -0,0 +1,182 @@
+#ifndef KEYED_HEAP_HPP
+#define KEYED_HEAP_HPP
+
+#include "heap.hpp"
+#include <vector>
+#include <limits>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <functional>
+#include <type_traits>
+
+namespace DSA {
+
+/*
+Priority queue of (key, payload) with the keys and the payloads in separate arrays.
+
+Only the array of {key, 32-bit payload index} is sifted: a sift moves and compares
+16 bytes per element for 64-bit keys, however large the payload, and four of them share
+a cache line. Payloads stay in their slot of a side array from push to pop,
+freed slots are reused.
+
+The top is the greatest key according to Compare, as in DSA::Heap. */
+template <
+	typename Key,
+	typename Payload,
+	typename Compare = std::less<Key>,
+	std::size_t Arity = 4
+>
+class KeyedHeap {
+public:
+	static_assert(Arity >= 2, "a heap needs at least two children per node");
+public:
+	using key_type			= Key;
+	using payload_type		= Payload;
+	using key_compare		= Compare;
+	using size_type			= std::size_t;
+	using slot_type			= std::uint32_t;
+
+	static constexpr std::size_t arity = Arity;
+
+private:
+	struct Entry {
+		key_type key;
+		slot_type slot;
+	};
+
+	struct EntryCompare {
+		EntryCompare(const Compare& comp)
+		: comp(comp) {}
+
+		bool operator()(const Entry& a, const Entry& b) const {
+			return comp(a.key, b.key);
+		}
+
+		Compare comp;
+	};
+
+public:
+	KeyedHeap()
+	: KeyedHeap(Compare()) {}
+
+	explicit KeyedHeap(const Compare& compare)
+	: comp(compare) {}
+
+	void reserve(size_type n) {
+		keys.reserve(n);
+		payloads.reserve(n);
+	}
+
+	bool empty() const {
+		return keys.empty();
+	}
+
+	size_type size() const {
+		return keys.size();
+	}
+
+	const key_type& top_key() const {
+		return keys.front().key;
+	}
+
+	const payload_type& top() const {
+		return payloads[keys.front().slot];
+	}
+
+	payload_type& top() {
+		return payloads[keys.front().slot];
+	}
+
+	void push(const key_type& key, const payload_type& payload) {
+		emplace(key, payload);
+	}
+
+	void push(const key_type& key, payload_type&& payload) {
+		emplace(key, std::move(payload));
+	}
+
+	/*
+	Constructs the payload in a free slot of the side array */
+	template <typename... Args>
+	void emplace(const key_type& key, Args&&... args) {
+		slot_type slot;
+		if (free_slots.empty()) {
+			assert(payloads.size() < std::numeric_limits<slot_type>::max());
+			slot = static_cast<slot_type>(payloads.size());
+			payloads.emplace_back(std::forward<Args>(args)...);
+		} else {
+			slot = free_slots.back();
+			payloads[slot] = payload_type(std::forward<Args>(args)...);
+			free_slots.pop_back();
+		}
+		keys.push_back(Entry {key, slot});
+		DSA::push_heap<Arity>(keys.begin(), keys.end(), comp);
+	}
+
+	void pop() {
+		const slot_type slot = keys.front().slot;
+		DSA::pop_heap<Arity>(keys.begin(), keys.end(), comp);
+		keys.pop_back();
+		if (keys.empty()) {
+			// nothing refers to the side array, it can start over
+			payloads.clear();
+			free_slots.clear();
+			return;
+		}
+		if (!std::is_trivially_destructible<payload_type>::value) {
+			// releases what the payload owns now instead of when the slot is reused
+			payloads[slot] = payload_type();
+		}
+		free_slots.push_back(slot);
+	}
+
+	/*
+	Removes the top and returns its payload by move */
+	payload_type pop_value() {
+		payload_type v = std::move(top());
+		pop();
+		return v;
+	}
+
+	void clear() {
+		keys.clear();
+		payloads.clear();
+		free_slots.clear();
+	}
+
+	void swap(KeyedHeap& other) noexcept {
+		std::swap(comp, other.comp);
+		std::swap(keys, other.keys);
+		std::swap(payloads, other.payloads);
+		std::swap(free_slots, other.free_slots);
+	}
+
+	key_compare key_comp() const {
+		return comp.comp;
+	}
+
+private:
+	EntryCompare comp;
+	std::vector<Entry> keys;
+	std::vector<payload_type> payloads;
+	std::vector<slot_type> free_slots;
+};
+
+template <typename Key, typename Payload, typename Compare, std::size_t Arity>
+constexpr std::size_t KeyedHeap<Key, Payload, Compare, Arity>::arity;
+
+}
+
+namespace std {
+
+template <class Key, class Payload, class Compare, std::size_t Arity>
+void swap(  DSA::KeyedHeap<Key, Payload, Compare, Arity>& lhs,
+			DSA::KeyedHeap<Key, Payload, Compare, Arity>& rhs) {
+	lhs.swap(rhs);
+}
+
+}
+
+#endif /* KEYED_HEAP_HPP */
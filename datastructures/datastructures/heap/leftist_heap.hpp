@@ -0,0 +1,224 @@
+#ifndef LEFTIST_HEAP_HPP
+#define LEFTIST_HEAP_HPP
+
+#include "sfinae.hpp"
+#include "pool/node_pool.hpp"
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+namespace DSA {
+
+/*
+Leftist heap: a heap-ordered binary tree in which the right spine of every
+subtree is its shortest path to a missing child (rank), so it has at most
+log(n + 1) nodes. Two heaps are melded by merging their right spines, O(log n)
+in the worst case, not amortised, push and pop are melds.
+
+Nodes come from a NodePool, merge adopts the pool of the other heap.
+The interface matches DSA::Heap and DSA::PairingHeap. */
+template <
+	typename T,
+	typename Compare = std::less<T>,
+	typename Alloc = std::allocator<T>
+>
+class LeftistHeap {
+private:
+	struct Node {
+		template <typename... Args>
+		explicit Node(Args&&... args)
+		: value(std::forward<Args>(args)...), left(nullptr), right(nullptr), rank(1) {}
+
+		T value;
+		Node* left;
+		Node* right;
+		std::size_t rank;
+	};
+
+	using pool_type = NodePool<Node, typename std::allocator_traits<Alloc>::template rebind_alloc<Node>>;
+
+public:
+	using value_type		= T;
+	using value_compare		= Compare;
+	using allocator_type	= Alloc;
+	using size_type			= std::size_t;
+	using reference			= T&;
+	using const_reference	= const T&;
+
+public:
+	LeftistHeap()
+	: LeftistHeap(Compare()) {}
+
+	explicit LeftistHeap(const Compare& compare, const Alloc& alloc = Alloc())
+	: comp(compare), pool(alloc), root(nullptr), count(0) {}
+
+	template <class InputIt,
+		RequireInputIterator<InputIt> = true>
+	LeftistHeap(InputIt first, InputIt last,
+			const Compare& compare = Compare(), const Alloc& alloc = Alloc())
+	: LeftistHeap(compare, alloc) {
+		for (; first != last; ++first) {
+			push(*first);
+		}
+	}
+
+	LeftistHeap(const LeftistHeap& other) = delete;
+	LeftistHeap& operator=(const LeftistHeap& rhs) = delete;
+
+	LeftistHeap(LeftistHeap&& other) noexcept
+	: comp(other.comp), pool(std::move(other.pool)), root(other.root), count(other.count) {
+		other.root = nullptr;
+		other.count = 0;
+	}
+
+	LeftistHeap& operator=(LeftistHeap&& rhs) noexcept {
+		if (this != &rhs) {
+			clear();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	~LeftistHeap() {
+		clear();
+	}
+
+	const_reference top() const {
+		return root->value;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	size_type size() const {
+		return count;
+	}
+
+	void push(const value_type& v) {
+		emplace(v);
+	}
+
+	void push(value_type&& v) {
+		emplace(std::move(v));
+	}
+
+	template <typename... Args>
+	void emplace(Args&&... args) {
+		root = meld(root, pool.create(std::forward<Args>(args)...));
+		++count;
+	}
+
+	void pop() {
+		Node* old = root;
+		root = meld(old->left, old->right);
+		pool.destroy(old);
+		--count;
+	}
+
+	value_type pop_value() {
+		value_type v = std::move(root->value);
+		pop();
+		return v;
+	}
+
+	/*
+	Moves every element of other into this heap, O(log n) plus the chunks of its pool */
+	void merge(LeftistHeap& other) {
+		if (this == &other || other.root == nullptr) {
+			return;
+		}
+		pool.splice(other.pool);
+		root = meld(root, other.root);
+		count += other.count;
+		other.root = nullptr;
+		other.count = 0;
+	}
+
+	void merge(LeftistHeap&& other) {
+		merge(other);
+	}
+
+	void clear() {
+		if (!std::is_trivially_destructible<T>::value && root) {
+			std::vector<Node*> stack {root};
+			while (!stack.empty()) {
+				Node* x = stack.back();
+				stack.pop_back();
+				if (x->left) {
+					stack.push_back(x->left);
+				}
+				if (x->right) {
+					stack.push_back(x->right);
+				}
+				x->~Node();
+			}
+		}
+		pool.release();
+		root = nullptr;
+		count = 0;
+	}
+
+	void swap(LeftistHeap& other) noexcept {
+		std::swap(comp, other.comp);
+		pool.swap(other.pool);
+		std::swap(root, other.root);
+		std::swap(count, other.count);
+	}
+
+	value_compare value_comp() const {
+		return comp;
+	}
+
+	allocator_type get_allocator() const {
+		return allocator_type(pool.get_allocator());
+	}
+
+private:
+	static std::size_t rank(const Node* x) {
+		return x ? x->rank : 0;
+	}
+
+	/*
+	Merges the right spines, the recursion depth is the sum of both ranks: O(log n) */
+	Node* meld(Node* a, Node* b) {
+		if (a == nullptr) {
+			return b;
+		}
+		if (b == nullptr) {
+			return a;
+		}
+		if (comp(a->value, b->value)) {
+			std::swap(a, b);
+		}
+		a->right = meld(a->right, b);
+		if (rank(a->left) < rank(a->right)) {
+			std::swap(a->left, a->right);
+		}
+		a->rank = rank(a->right) + 1;
+		return a;
+	}
+
+private:
+	value_compare comp;
+	pool_type pool;
+	Node* root;
+	size_type count;
+};
+
+}
+
+namespace std {
+
+template <class T, class Compare, class Alloc>
+void swap(  DSA::LeftistHeap<T, Compare, Alloc>& lhs,
+			DSA::LeftistHeap<T, Compare, Alloc>& rhs) {
+	lhs.swap(rhs);
+}
+
+}
+
+#endif /* LEFTIST_HEAP_HPP */
@@ -0,0 +1,386 @@
+#ifndef MINMAX_HEAP_HPP
+#define MINMAX_HEAP_HPP
+
+#include "heap.hpp"
+#include "bit_width.hpp"
+#include "sfinae.hpp"
+#include <vector>
+#include <utility>
+#include <cstddef>
+#include <functional>
+
+namespace DSA {
+
+	namespace HeapDetail {
+
+	/*
+	Levels 0, 2, 4 ... of a min-max heap are min levels */
+	inline bool isMinLevel(std::size_t index) {
+		return HeapDetail::bitWidth(index + 1) % 2 == 1;
+	}
+
+	}
+
+/*
+Double-ended priority queue: a binary heap whose levels alternate between
+min levels (each element is the smallest of its subtree) and max levels
+(the greatest of its subtree). The root is the minimum, the greater of its
+two children the maximum.
+
+min() and max() are O(1), push, pop_min and pop_max O(log n).
+A container adapter like DSA::Heap, Compare orders the elements as for std::sort. */
+template <
+	typename T,
+	typename Container = std::vector<T>,
+	typename Compare = std::less<typename Container::value_type>
+>
+class MinMaxHeap {
+public:
+	static_assert(std::is_same<T, typename Container::value_type>::value, "invalid container");
+public:
+	using container_type	= Container;
+	using value_compare		= Compare;
+	using value_type		= typename Container::value_type;
+	using size_type			= typename Container::size_type;
+	using reference			= typename Container::reference;
+	using const_reference	= typename Container::const_reference;
+
+	using iterator			= typename Container::iterator;
+	using const_iterator	= typename Container::const_iterator;
+
+public:
+	MinMaxHeap()
+	: MinMaxHeap(Compare(), Container()) {}
+	explicit MinMaxHeap(const Compare& compare)
+	: MinMaxHeap(compare, Container()) {}
+
+	MinMaxHeap(const Compare& compare, const Container& cont)
+	: comp(compare), c(cont) {
+		makeHeap();
+	}
+
+	MinMaxHeap(const Compare& compare, Container&& cont)
+	: comp(compare), c(std::move(cont)) {
+		makeHeap();
+	}
+
+	MinMaxHeap(const MinMaxHeap& other) = default;
+	MinMaxHeap(MinMaxHeap&& other) = default;
+
+	template <class InputIt,
+		RequireInputIterator<InputIt> = true>
+	MinMaxHeap(InputIt first, InputIt last,
+			const Compare& compare = Compare())
+	: comp(compare), c(first, last) {
+		makeHeap();
+	}
+
+	template <class InputIt,
+		RequireInputIterator<InputIt> = true>
+	MinMaxHeap(InputIt first, InputIt last,
+		const Compare& compare, const Container& cont)
+	: comp(compare), c(cont) {
+		c.insert(c.end(), first, last);
+		makeHeap();
+	}
+
+	template <class InputIt,
+		RequireInputIterator<InputIt> = true>
+	MinMaxHeap(InputIt first, InputIt last,
+		const Compare& compare, Container&& cont)
+	: comp(compare), c(std::move(cont)) {
+		c.insert(c.end(), first, last);
+		makeHeap();
+	}
+
+	template <class Alloc,
+		RequireAllocator<container_type, Alloc> = true>
+	explicit MinMaxHeap(const Alloc& alloc)
+	: MinMaxHeap(Compare(), alloc) {}
+
+	template <class Alloc,
+		RequireAllocator<container_type, Alloc> = true>
+	MinMaxHeap(const Compare& compare, const Alloc& alloc)
+	: comp(compare), c(alloc) {}
+
+	template <class Alloc,
+		RequireAllocator<container_type, Alloc> = true>
+	MinMaxHeap(const Compare& compare, const Container& cont,
+		const Alloc& alloc)
+	: comp(compare), c(cont, alloc) {
+		makeHeap();
+	}
+
+	template <class Alloc,
+		RequireAllocator<container_type, Alloc> = true>
+	MinMaxHeap(const Compare& compare, Container&& cont,
+		const Alloc& alloc)
+	: comp(compare), c(std::move(cont), alloc) {
+		makeHeap();
+	}
+
+	template <class Alloc,
+		RequireAllocator<container_type, Alloc> = true>
+	MinMaxHeap(const MinMaxHeap& other, const Alloc& alloc)
+	: comp(other.comp), c(other.c, alloc) {}
+
+	template <class Alloc,
+		RequireAllocator<container_type, Alloc> = true>
+	MinMaxHeap(MinMaxHeap&& other, const Alloc& alloc)
+	: comp(std::move(other.comp)), c(std::move(other.c), alloc) {}
+
+	template <class InputIt, class Alloc,
+		RequireInputIterator<InputIt> = true,
+		RequireAllocator<container_type, Alloc> = true>
+	MinMaxHeap(InputIt first, InputIt last, const Compare& compare,
+		const Alloc& alloc)
+	: comp(compare), c(first, last, alloc) {
+		makeHeap();
+	}
+
+	~MinMaxHeap() {}
+
+	MinMaxHeap& operator=(const MinMaxHeap& other) = default;
+	MinMaxHeap& operator=(MinMaxHeap&& other) = default;
+
+/*
+Iterators */
+
+	iterator begin() {
+		return c.begin();
+	}
+
+	const_iterator begin() const {
+		return c.cbegin();
+	}
+
+	iterator end() {
+		return c.end();
+	}
+
+	const_iterator end() const {
+		return c.cend();
+	}
+
+/*
+Double-ended priority queue functions */
+	const_reference min() const {
+		return c.front();
+	}
+
+	const_reference max() const {
+		return c[maxIndex()];
+	}
+
+	bool empty() const {
+		return c.empty();
+	}
+
+	size_type size() const {
+		return c.size();
+	}
+
+	void push(const value_type& v) {
+		c.push_back(v);
+		bubbleUp(c.size() - 1);
+	}
+
+	void push(value_type&& v) {
+		c.push_back(std::move(v));
+		bubbleUp(c.size() - 1);
+	}
+
+	template <typename... Args>
+	void emplace(Args&&... args) {
+		c.emplace_back(std::forward<Args>(args)...);
+		bubbleUp(c.size() - 1);
+	}
+
+	void pop_min() {
+		remove(0);
+	}
+
+	void pop_max() {
+		remove(maxIndex());
+	}
+
+	value_type pop_min_value() {
+		value_type v = std::move(c.front());
+		remove(0);
+		return v;
+	}
+
+	value_type pop_max_value() {
+		const size_type index = maxIndex();
+		value_type v = std::move(c[index]);
+		remove(index);
+		return v;
+	}
+
+	void swap(MinMaxHeap& other) noexcept {
+		std::swap(c, other.c);
+		std::swap(comp, other.comp);
+	}
+
+	value_compare value_comp() const {
+		return comp;
+	}
+
+	/*
+	Checks the min-max property: every element is the smallest (min level) or
+	the greatest (max level) of its subtree */
+	bool valid() const {
+		for (size_type i = 1; i < c.size(); ++i) {
+			size_type ancestor = HeapDetail::parentIndex<2>(i);
+			while (true) {
+				if (HeapDetail::isMinLevel(ancestor) ? comp(c[i], c[ancestor]) : comp(c[ancestor], c[i])) {
+					return false;
+				}
+				if (ancestor == 0) {
+					break;
+				}
+				ancestor = HeapDetail::parentIndex<2>(ancestor);
+			}
+		}
+		return true;
+	}
+
+private:
+	/*
+	a belongs above b on a min level (Max = false) or a max level (Max = true) */
+	template <bool Max>
+	bool before(const value_type& a, const value_type& b) const {
+		return Max ? comp(b, a) : comp(a, b);
+	}
+
+	size_type maxIndex() const {
+		if (c.size() <= 2) {
+			return c.size() - 1;
+		}
+		return comp(c[1], c[2]) ? 2 : 1;
+	}
+
+	void makeHeap() {
+		if (c.size() < 2) {
+			return;
+		}
+		for (size_type i = HeapDetail::parentIndex<2>(c.size() - 1) + 1; i > 0; --i) {
+			trickleDown(i - 1);
+		}
+	}
+
+	/*
+	The element at index is replaced by the last element */
+	void remove(size_type index) {
+		if (index + 1 != c.size()) {
+			c[index] = std::move(c.back());
+		}
+		c.pop_back();
+		if (index < c.size()) {
+			trickleDown(index);
+		}
+	}
+
+	/*
+	A new element at index: it belongs on the min levels above it if it is smaller
+	than its parent on a max level, otherwise on the max levels (and conversely) */
+	void bubbleUp(size_type index) {
+		if (index == 0) {
+			return;
+		}
+		const size_type parent = HeapDetail::parentIndex<2>(index);
+		if (HeapDetail::isMinLevel(index)) {
+			if (comp(c[parent], c[index])) {
+				std::swap(c[parent], c[index]);
+				bubbleUpLevels<true>(parent);
+			} else {
+				bubbleUpLevels<false>(index);
+			}
+		} else {
+			if (comp(c[index], c[parent])) {
+				std::swap(c[parent], c[index]);
+				bubbleUpLevels<false>(parent);
+			} else {
+				bubbleUpLevels<true>(index);
+			}
+		}
+	}
+
+	/*
+	Sifts up over grandparents, which are on the same kind of level */
+	template <bool Max>
+	void bubbleUpLevels(size_type index) {
+		while (index > 2) {
+			const size_type grandparent = HeapDetail::parentIndex<2>(HeapDetail::parentIndex<2>(index));
+			if (!before<Max>(c[index], c[grandparent])) {
+				break;
+			}
+			std::swap(c[index], c[grandparent]);
+			index = grandparent;
+		}
+	}
+
+	void trickleDown(size_type index) {
+		if (HeapDetail::isMinLevel(index)) {
+			trickleDownLevels<false>(index);
+		} else {
+			trickleDownLevels<true>(index);
+		}
+	}
+
+	/*
+	The best of the children and grandchildren moves up; a grandchild is on the same
+	kind of level, so the sift continues from there, after restoring the order
+	with its parent on the other kind of level */
+	template <bool Max>
+	void trickleDownLevels(size_type index) {
+		const size_type size = c.size();
+		while (true) {
+			const size_type child = HeapDetail::firstChildIndex<2>(index);
+			if (child >= size) {
+				return;
+			}
+			size_type best = child;
+			if (child + 1 < size && before<Max>(c[child + 1], c[best])) {
+				best = child + 1;
+			}
+			const size_type grandchild = HeapDetail::firstChildIndex<2>(child);
+			const size_type last = std::min(grandchild + 4, size);
+			for (size_type i = grandchild; i < last; ++i) {
+				if (before<Max>(c[i], c[best])) {
+					best = i;
+				}
+			}
+			if (!before<Max>(c[best], c[index])) {
+				return;
+			}
+			std::swap(c[best], c[index]);
+			if (best < grandchild) {
+				return;
+			}
+			const size_type parent = HeapDetail::parentIndex<2>(best);
+			if (before<Max>(c[parent], c[best])) {
+				std::swap(c[parent], c[best]);
+			}
+			index = best;
+		}
+	}
+
+protected:
+	value_compare comp;
+	container_type c;
+};
+
+}
+
+namespace std {
+
+template <class T, class Container, class Compare>
+void swap(  DSA::MinMaxHeap<T, Container, Compare>& lhs,
+			DSA::MinMaxHeap<T, Container, Compare>& rhs) {
+	lhs.swap(rhs);
+}
+
+}
+
+#endif /* MINMAX_HEAP_HPP */
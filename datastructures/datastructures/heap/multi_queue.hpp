@@ -0,0 +1,192 @@
+#ifndef MULTI_QUEUE_HPP
+#define MULTI_QUEUE_HPP
+
+#include "heap.hpp"
+#include <vector>
+#include <mutex>
+#include <atomic>
+#include <thread>
+#include <random>
+#include <cstddef>
+#include <functional>
+
+namespace DSA {
+
+/*
+Concurrent relaxed priority queue (MultiQueue).
+
+The elements are spread over (factor * threads) heaps, each with its own mutex.
+push() inserts into a random heap, pop() locks two random heaps with try_lock and
+takes the better of their tops. No lock is ever waited on in relaxed mode,
+so threads do not serialize on one mutex; in exchange a pop may return an element
+that is not the greatest, but close to it with high probability.
+
+Strict mode locks every heap for a pop and returns the greatest element,
+for tests that need an exact order. */
+template <
+	typename T,
+	typename Compare = std::less<T>,
+	std::size_t Arity = 2
+>
+class MultiQueue {
+public:
+	using value_type		= T;
+	using value_compare		= Compare;
+	using size_type			= std::size_t;
+	using heap_type			= Heap<T, std::vector<T>, Compare, Arity>;
+
+	enum class Mode {
+		Relaxed,
+		Strict
+	};
+
+private:
+	struct Queue {
+		std::mutex lock;
+		heap_type heap;
+		// keeps the mutexes of neighbouring queues off the same cache line
+		char padding[64];
+	};
+
+public:
+	explicit MultiQueue(size_type threads = std::thread::hardware_concurrency(), size_type factor = 2,
+						Mode mode = Mode::Relaxed, const Compare& compare = Compare())
+	: comp(compare), mode(mode), queues(threads * factor < 2 ? 2 : threads * factor), count(0) {
+		for (Queue& q : queues) {
+			q.heap = heap_type(compare);
+		}
+	}
+
+	MultiQueue(const MultiQueue& other) = delete;
+	MultiQueue& operator=(const MultiQueue& rhs) = delete;
+
+	void push(const value_type& v) {
+		emplace(v);
+	}
+
+	void push(value_type&& v) {
+		emplace(std::move(v));
+	}
+
+	template <typename... Args>
+	void emplace(Args&&... args) {
+		while (true) {
+			Queue& q = queues[randomIndex()];
+			std::unique_lock<std::mutex> guard {q.lock, std::try_to_lock};
+			if (guard.owns_lock()) {
+				q.heap.emplace(std::forward<Args>(args)...);
+				count.fetch_add(1, std::memory_order_release);
+				return;
+			}
+		}
+	}
+
+	/*
+	Moves an element into out, false if the queue was found empty */
+	bool try_pop(value_type& out) {
+		if (mode == Mode::Strict) {
+			return popStrict(out);
+		}
+		for (size_type attempt = 0; attempt < queues.size(); ++attempt) {
+			if (count.load(std::memory_order_acquire) == 0) {
+				return false;
+			}
+			Queue& a = queues[randomIndex()];
+			Queue& b = queues[randomIndex()];
+			std::unique_lock<std::mutex> guard_a {a.lock, std::try_to_lock};
+			if (!guard_a.owns_lock()) {
+				continue;
+			}
+			std::unique_lock<std::mutex> guard_b;
+			if (&a != &b) {
+				guard_b = std::unique_lock<std::mutex> {b.lock, std::try_to_lock};
+			}
+			Queue* best = a.heap.empty() ? nullptr : &a;
+			if (guard_b.owns_lock() && !b.heap.empty()
+					&& (best == nullptr || comp(best->heap.top(), b.heap.top()))) {
+				best = &b;
+			}
+			if (best != nullptr) {
+				take(*best, out);
+				return true;
+			}
+		}
+		// the random picks kept missing: most queues are locked or empty
+		return popAny(out);
+	}
+
+	/*
+	Number of elements, exact only when no other thread is modifying the queue */
+	size_type size() const {
+		return count.load(std::memory_order_acquire);
+	}
+
+	bool empty() const {
+		return size() == 0;
+	}
+
+	size_type queueCount() const {
+		return queues.size();
+	}
+
+	Mode getMode() const {
+		return mode;
+	}
+
+private:
+	void take(Queue& q, value_type& out) {
+		out = q.heap.pop_value();
+		count.fetch_sub(1, std::memory_order_release);
+	}
+
+	/*
+	Locks every queue, in index order so that two strict pops cannot deadlock */
+	bool popStrict(value_type& out) {
+		std::vector<std::unique_lock<std::mutex>> guards;
+		guards.reserve(queues.size());
+		Queue* best = nullptr;
+		for (Queue& q : queues) {
+			guards.emplace_back(q.lock);
+			if (!q.heap.empty() && (best == nullptr || comp(best->heap.top(), q.heap.top()))) {
+				best = &q;
+			}
+		}
+		if (best == nullptr) {
+			return false;
+		}
+		take(*best, out);
+		return true;
+	}
+
+	/*
+	Visits every queue once, waiting for each lock */
+	bool popAny(value_type& out) {
+		const size_type start = randomIndex();
+		for (size_type i = 0; i < queues.size(); ++i) {
+			Queue& q = queues[(start + i) % queues.size()];
+			std::lock_guard<std::mutex> guard {q.lock};
+			if (!q.heap.empty()) {
+				take(q, out);
+				return true;
+			}
+		}
+		return false;
+	}
+
+	size_type randomIndex() {
+		static thread_local std::minstd_rand rng {
+			static_cast<std::minstd_rand::result_type>(std::hash<std::thread::id>()(std::this_thread::get_id()))
+		};
+		return rng() % queues.size();
+	}
+
+private:
+	value_compare comp;
+	Mode mode;
+	std::vector<Queue> queues;
+	std::atomic<size_type> count;
+};
+
+}
+
+#endif /* MULTI_QUEUE_HPP */
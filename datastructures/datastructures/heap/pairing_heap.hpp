@@ -0,0 +1,357 @@
+#ifndef PAIRING_HEAP_HPP
+#define PAIRING_HEAP_HPP
+
+#include "sfinae.hpp"
+#include "pool/node_pool.hpp"
+#include <memory>
+#include <vector>
+#include <utility>
+#include <cassert>
+#include <cstddef>
+#include <functional>
+#include <type_traits>
+
+namespace DSA {
+
+/*
+Pairing heap: a heap-ordered tree of any shape, children in a linked list.
+
+push and merge link two roots with one comparison, O(1).
+pop links the children of the root pairwise, left to right, then melds
+the pairs right to left, amortised O(log n).
+
+Nodes come from a NodePool, merge adopts the pool of the other heap.
+push returns a handle to the element, which stays valid until the element
+is removed and allows increaseKey (towards the top, amortised O(log n) at most),
+decreaseKey and erase.
+
+push/emplace/top/pop/size/empty/value_comp match DSA::Heap, so either can be
+passed where a priority queue type is a template parameter. */
+template <
+	typename T,
+	typename Compare = std::less<T>,
+	typename Alloc = std::allocator<T>
+>
+class PairingHeap {
+private:
+	struct Node {
+		template <typename... Args>
+		explicit Node(Args&&... args)
+		: value(std::forward<Args>(args)...), child(nullptr), next(nullptr), prev(nullptr) {}
+
+		T value;
+		Node* child;
+		Node* next;
+		// previous sibling, or the parent for the first child
+		Node* prev;
+	};
+
+	using pool_type = NodePool<Node, typename std::allocator_traits<Alloc>::template rebind_alloc<Node>>;
+
+public:
+	using value_type		= T;
+	using value_compare		= Compare;
+	using allocator_type	= Alloc;
+	using size_type			= std::size_t;
+	using reference			= T&;
+	using const_reference	= const T&;
+
+	class handle {
+	public:
+		handle()
+		: node(nullptr) {}
+
+		const_reference operator*() const {
+			return node->value;
+		}
+
+		bool operator==(const handle& rhs) const {
+			return node == rhs.node;
+		}
+
+		bool operator!=(const handle& rhs) const {
+			return node != rhs.node;
+		}
+
+	private:
+		friend class PairingHeap;
+
+		explicit handle(Node* node)
+		: node(node) {}
+
+		Node* node;
+	};
+
+public:
+	PairingHeap()
+	: PairingHeap(Compare()) {}
+
+	explicit PairingHeap(const Compare& compare, const Alloc& alloc = Alloc())
+	: comp(compare), pool(alloc), root(nullptr), count(0) {}
+
+	template <class InputIt,
+		RequireInputIterator<InputIt> = true>
+	PairingHeap(InputIt first, InputIt last,
+			const Compare& compare = Compare(), const Alloc& alloc = Alloc())
+	: PairingHeap(compare, alloc) {
+		for (; first != last; ++first) {
+			push(*first);
+		}
+	}
+
+	PairingHeap(const PairingHeap& other) = delete;
+	PairingHeap& operator=(const PairingHeap& rhs) = delete;
+
+	PairingHeap(PairingHeap&& other) noexcept
+	: comp(other.comp), pool(std::move(other.pool)), root(other.root), count(other.count) {
+		other.root = nullptr;
+		other.count = 0;
+	}
+
+	PairingHeap& operator=(PairingHeap&& rhs) noexcept {
+		if (this != &rhs) {
+			clear();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	~PairingHeap() {
+		clear();
+	}
+
+	const_reference top() const {
+		return root->value;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	size_type size() const {
+		return count;
+	}
+
+	handle push(const value_type& v) {
+		return emplace(v);
+	}
+
+	handle push(value_type&& v) {
+		return emplace(std::move(v));
+	}
+
+	template <typename... Args>
+	handle emplace(Args&&... args) {
+		Node* x = pool.create(std::forward<Args>(args)...);
+		root = root ? link(root, x) : x;
+		++count;
+		return handle(x);
+	}
+
+	void pop() {
+		Node* old = root;
+		root = combine(old->child);
+		pool.destroy(old);
+		--count;
+	}
+
+	value_type pop_value() {
+		value_type v = std::move(root->value);
+		pop();
+		return v;
+	}
+
+	/*
+	Moves every element of other into this heap, O(1) plus the chunks of its pool */
+	void merge(PairingHeap& other) {
+		if (this == &other || other.root == nullptr) {
+			return;
+		}
+		pool.splice(other.pool);
+		root = root ? link(root, other.root) : other.root;
+		count += other.count;
+		other.root = nullptr;
+		other.count = 0;
+	}
+
+	void merge(PairingHeap&& other) {
+		merge(other);
+	}
+
+	/*
+	The new value may not be smaller than the current one: the subtree is cut
+	and linked with the root */
+	void increaseKey(handle h, const value_type& v) {
+		Node* x = h.node;
+		assert(!comp(v, x->value));
+		x->value = v;
+		if (x != root) {
+			cut(x);
+			root = link(root, x);
+		}
+	}
+
+	/*
+	The new value may not be greater than the current one: the element is
+	removed and inserted again, the handle stays valid */
+	void decreaseKey(handle h, const value_type& v) {
+		Node* x = h.node;
+		assert(!comp(x->value, v));
+		x->value = v;
+		detach(x);
+		root = root ? link(root, x) : x;
+	}
+
+	/*
+	Changes the value of an element in either direction */
+	void update(handle h, const value_type& v) {
+		if (comp(h.node->value, v)) {
+			increaseKey(h, v);
+		} else {
+			decreaseKey(h, v);
+		}
+	}
+
+	void erase(handle h) {
+		Node* x = h.node;
+		detach(x);
+		pool.destroy(x);
+		--count;
+	}
+
+	void clear() {
+		if (!std::is_trivially_destructible<T>::value && root) {
+			std::vector<Node*> stack {root};
+			while (!stack.empty()) {
+				Node* x = stack.back();
+				stack.pop_back();
+				for (Node* c = x->child; c; c = c->next) {
+					stack.push_back(c);
+				}
+				x->~Node();
+			}
+		}
+		pool.release();
+		root = nullptr;
+		count = 0;
+	}
+
+	void swap(PairingHeap& other) noexcept {
+		std::swap(comp, other.comp);
+		pool.swap(other.pool);
+		std::swap(root, other.root);
+		std::swap(count, other.count);
+	}
+
+	value_compare value_comp() const {
+		return comp;
+	}
+
+	allocator_type get_allocator() const {
+		return allocator_type(pool.get_allocator());
+	}
+
+private:
+	/*
+	Links two roots, the smaller one becomes the first child of the greater one */
+	Node* link(Node* a, Node* b) {
+		if (comp(a->value, b->value)) {
+			std::swap(a, b);
+		}
+		b->prev = a;
+		b->next = a->child;
+		if (a->child) {
+			a->child->prev = b;
+		}
+		a->child = b;
+		a->next = nullptr;
+		a->prev = nullptr;
+		return a;
+	}
+
+	/*
+	Two-pass pairing of a list of siblings: pairs are linked left to right,
+	the results are melded right to left. Iterative, so a long child list
+	does not exhaust the stack. */
+	Node* combine(Node* first) {
+		if (first == nullptr) {
+			return nullptr;
+		}
+		// first pass: the linked pairs are kept in a list in reverse order
+		Node* pairs = nullptr;
+		while (first) {
+			Node* a = first;
+			Node* b = a->next;
+			if (b == nullptr) {
+				a->next = pairs;
+				pairs = a;
+				break;
+			}
+			first = b->next;
+			Node* linked = link(a, b);
+			linked->next = pairs;
+			pairs = linked;
+		}
+		// second pass: meld from the last pair to the first
+		Node* result = pairs;
+		pairs = pairs->next;
+		while (pairs) {
+			Node* next = pairs->next;
+			result = link(result, pairs);
+			pairs = next;
+		}
+		result->prev = nullptr;
+		result->next = nullptr;
+		return result;
+	}
+
+	/*
+	Removes the subtree of x (not the root) from its sibling list */
+	void cut(Node* x) {
+		if (x->prev->child == x) {
+			x->prev->child = x->next;
+		} else {
+			x->prev->next = x->next;
+		}
+		if (x->next) {
+			x->next->prev = x->prev;
+		}
+		x->next = nullptr;
+		x->prev = nullptr;
+	}
+
+	/*
+	Takes x out of the heap, its children stay in the heap */
+	void detach(Node* x) {
+		if (x == root) {
+			root = combine(x->child);
+		} else {
+			cut(x);
+			Node* children = combine(x->child);
+			if (children) {
+				root = link(root, children);
+			}
+		}
+		x->child = nullptr;
+	}
+
+private:
+	value_compare comp;
+	pool_type pool;
+	Node* root;
+	size_type count;
+};
+
+}
+
+namespace std {
+
+template <class T, class Compare, class Alloc>
+void swap(  DSA::PairingHeap<T, Compare, Alloc>& lhs,
+			DSA::PairingHeap<T, Compare, Alloc>& rhs) {
+	lhs.swap(rhs);
+}
+
+}
+
+#endif /* PAIRING_HEAP_HPP */
@@ -0,0 +1,166 @@
+#ifndef RADIX_HEAP_HPP
+#define RADIX_HEAP_HPP
+
+#include "bit_width.hpp"
+#include <array>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <tuple>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace DSA {
+
+/*
+Monotone min-priority queue for unsigned integer keys (Dijkstra, event simulation):
+a pushed key may not be smaller than the last key returned by top or pop.
+
+Bucket i (i > 0) holds the keys whose highest bit that differs from the last popped
+key is bit i - 1, bucket 0 the keys equal to it. push appends to a bucket, O(1).
+When bucket 0 runs empty, the lowest non-empty bucket is emptied into the buckets
+below it around its minimum: a key only ever moves to a lower bucket, so every key
+moves at most (bits of Key) times, O(log C) amortised per pop for keys spanning C.
+
+No comparisons between elements are made, and Value never takes part in the order. */
+template <typename Key, typename Value>
+class RadixHeap {
+public:
+	static_assert(std::is_integral<Key>::value && std::is_unsigned<Key>::value, "keys must be unsigned integers");
+public:
+	using key_type			= Key;
+	using mapped_type		= Value;
+	using value_type		= std::pair<Key, Value>;
+	using size_type			= std::size_t;
+	using const_reference	= const value_type&;
+
+	static constexpr std::size_t bucket_count = std::numeric_limits<Key>::digits + 1;
+
+public:
+	RadixHeap()
+	: last(0), count(0) {}
+
+	const_reference top() const {
+		if (buckets[0].empty()) {
+			refill();
+		}
+		return buckets[0].back();
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	size_type size() const {
+		return count;
+	}
+
+	/*
+	Last key returned by top or pop, pushed keys may not be smaller */
+	key_type lastKey() const {
+		return last;
+	}
+
+	void push(key_type key, const mapped_type& v) {
+		emplace(key, v);
+	}
+
+	void push(key_type key, mapped_type&& v) {
+		emplace(key, std::move(v));
+	}
+
+	template <typename... Args>
+	void emplace(key_type key, Args&&... args) {
+		assert(key >= last);
+		buckets[bucketIndex(key)].emplace_back(std::piecewise_construct,
+			std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+		++count;
+	}
+
+	void pop() {
+		if (buckets[0].empty()) {
+			refill();
+		}
+		buckets[0].pop_back();
+		--count;
+	}
+
+	value_type pop_value() {
+		if (buckets[0].empty()) {
+			refill();
+		}
+		value_type v = std::move(buckets[0].back());
+		pop();
+		return v;
+	}
+
+	/*
+	Removes every element, the lower bound for keys is reset to 0 */
+	void clear() {
+		for (std::vector<value_type>& bucket : buckets) {
+			bucket.clear();
+		}
+		last = 0;
+		count = 0;
+	}
+
+	void swap(RadixHeap& other) noexcept {
+		std::swap(buckets, other.buckets);
+		std::swap(last, other.last);
+		std::swap(count, other.count);
+	}
+
+private:
+	std::size_t bucketIndex(key_type key) const {
+		return HeapDetail::bitWidth(static_cast<std::uint64_t>(key ^ last));
+	}
+
+	/*
+	Bucket 0 is empty: the minimum of the lowest non-empty bucket becomes the
+	new lower bound and that bucket is redistributed. Every key in bucket i agrees
+	with the new bound above bit i - 1, so all of them land in buckets below i. */
+	void refill() const {
+		std::size_t i = 1;
+		while (buckets[i].empty()) {
+			++i;
+		}
+		std::vector<value_type>& bucket = buckets[i];
+		key_type minimum = bucket.front().first;
+		for (const value_type& v : bucket) {
+			if (v.first < minimum) {
+				minimum = v.first;
+			}
+		}
+		last = minimum;
+		for (value_type& v : bucket) {
+			buckets[bucketIndex(v.first)].push_back(std::move(v));
+		}
+		// keeps its capacity for the next round
+		bucket.clear();
+	}
+
+private:
+	// top() redistributes, the elements do not change
+	mutable std::array<std::vector<value_type>, bucket_count> buckets;
+	mutable key_type last;
+	size_type count;
+};
+
+template <typename Key, typename Value>
+constexpr std::size_t RadixHeap<Key, Value>::bucket_count;
+
+}
+
+namespace std {
+
+template <class Key, class Value>
+void swap(  DSA::RadixHeap<Key, Value>& lhs,
+			DSA::RadixHeap<Key, Value>& rhs) {
+	lhs.swap(rhs);
+}
+
+}
+
+#endif /* RADIX_HEAP_HPP */
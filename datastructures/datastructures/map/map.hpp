@@ -0,0 +1,240 @@
+#ifndef MAP_HPP
+#define MAP_HPP
+
+#include "redblack/tree_container.hpp"
+#include <functional>
+#include <memory>
+#include <utility>
+#include <tuple>
+#include <stdexcept>
+
+namespace DSA {
+
+	namespace Detail {
+
+	template <class Key, class T, class Compare, class Allocator, bool Multi>
+	using MapTree = RedBlackTree<std::pair<const Key, T>, Compare, Allocator,
+		SelectFirst<std::pair<const Key, T>>, Multi>;
+
+	/*
+	Orders values by their keys */
+	template <class Value, class Compare>
+	class MapValueCompare {
+	public:
+		bool operator()(const Value& lhs, const Value& rhs) const {
+			return comp(lhs.first, rhs.first);
+		}
+
+		explicit MapValueCompare(const Compare& c)
+		: comp(c) {}
+
+	protected:
+		Compare comp;
+	};
+
+	}
+
+/*
+Ordered map over RedBlackTree, comparisons only look at keys.
+try_emplace and insert_or_assign look the key up before constructing anything,
+a hint right after the new element's position makes insertion amortised O(1). */
+template <class Key, class T,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<const Key, T>>>
+class map : public Detail::TreeContainer<Detail::MapTree<Key, T, Compare, Allocator, false>,
+	typename Detail::MapTree<Key, T, Compare, Allocator, false>::iterator> {
+private:
+	using Base = Detail::TreeContainer<Detail::MapTree<Key, T, Compare, Allocator, false>,
+		typename Detail::MapTree<Key, T, Compare, Allocator, false>::iterator>;
+
+public:
+	using mapped_type		= T;
+	using value_type		= typename Base::value_type;
+	using iterator			= typename Base::iterator;
+	using const_iterator	= typename Base::const_iterator;
+	using value_compare		= Detail::MapValueCompare<value_type, Compare>;
+
+	using Base::Base;
+	using Base::insert;
+	using Base::operator=;
+
+	map() = default;
+
+	map(std::initializer_list<value_type> init,
+		const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+	: Base(init, comp, alloc) {}
+
+/* Element access */
+	T& at(const Key& key) {
+		iterator it = this->find(key);
+		if (it == this->end()) {
+			throw std::out_of_range("map::at");
+		}
+		return it->second;
+	}
+
+	const T& at(const Key& key) const {
+		const_iterator it = this->find(key);
+		if (it == this->end()) {
+			throw std::out_of_range("map::at");
+		}
+		return it->second;
+	}
+
+	T& operator[](const Key& key) {
+		return try_emplace(key).first->second;
+	}
+
+	T& operator[](Key&& key) {
+		return try_emplace(std::move(key)).first->second;
+	}
+
+/* Modifiers */
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return this->tree.insert(value);
+	}
+
+	std::pair<iterator, bool> insert(value_type&& value) {
+		return this->tree.insert(std::move(value));
+	}
+
+	iterator insert(const_iterator hint, const value_type& value) {
+		return this->tree.insert(hint, value);
+	}
+
+	iterator insert(const_iterator hint, value_type&& value) {
+		return this->tree.insert(hint, std::move(value));
+	}
+
+	template <class M>
+	std::pair<iterator, bool> insert_or_assign(const Key& key, M&& obj) {
+		std::pair<iterator, bool> r = this->tree.try_emplace(key, key, std::forward<M>(obj));
+		if (!r.second) {
+			r.first->second = std::forward<M>(obj);
+		}
+		return r;
+	}
+
+	template <class M>
+	std::pair<iterator, bool> insert_or_assign(Key&& key, M&& obj) {
+		std::pair<iterator, bool> r = this->tree.try_emplace(key, std::move(key), std::forward<M>(obj));
+		if (!r.second) {
+			r.first->second = std::forward<M>(obj);
+		}
+		return r;
+	}
+
+	template <class M>
+	iterator insert_or_assign(const_iterator hint, const Key& key, M&& obj) {
+		std::pair<iterator, bool> r = this->tree.try_emplace_hint(hint, key, key, std::forward<M>(obj));
+		if (!r.second) {
+			r.first->second = std::forward<M>(obj);
+		}
+		return r.first;
+	}
+
+	template <class M>
+	iterator insert_or_assign(const_iterator hint, Key&& key, M&& obj) {
+		std::pair<iterator, bool> r = this->tree.try_emplace_hint(hint, key, std::move(key), std::forward<M>(obj));
+		if (!r.second) {
+			r.first->second = std::forward<M>(obj);
+		}
+		return r.first;
+	}
+
+	template <class... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		return this->tree.emplace(std::forward<Args>(args)...);
+	}
+
+	/*
+	The key is only moved from and T only constructed when key is absent */
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(const Key& key, Args&&... args) {
+		return this->tree.try_emplace(key, std::piecewise_construct,
+			std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	template <class... Args>
+	std::pair<iterator, bool> try_emplace(Key&& key, Args&&... args) {
+		return this->tree.try_emplace(key, std::piecewise_construct,
+			std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...));
+	}
+
+	template <class... Args>
+	iterator try_emplace(const_iterator hint, const Key& key, Args&&... args) {
+		return this->tree.try_emplace_hint(hint, key, std::piecewise_construct,
+			std::forward_as_tuple(key), std::forward_as_tuple(std::forward<Args>(args)...)).first;
+	}
+
+	template <class... Args>
+	iterator try_emplace(const_iterator hint, Key&& key, Args&&... args) {
+		return this->tree.try_emplace_hint(hint, key, std::piecewise_construct,
+			std::forward_as_tuple(std::move(key)), std::forward_as_tuple(std::forward<Args>(args)...)).first;
+	}
+
+/* Observers */
+	value_compare value_comp() const {
+		return value_compare(this->key_comp());
+	}
+};
+
+/*
+Ordered map with equal keys, kept in insertion order */
+template <class Key, class T,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<std::pair<const Key, T>>>
+class multimap : public Detail::TreeContainer<Detail::MapTree<Key, T, Compare, Allocator, true>,
+	typename Detail::MapTree<Key, T, Compare, Allocator, true>::iterator> {
+private:
+	using Base = Detail::TreeContainer<Detail::MapTree<Key, T, Compare, Allocator, true>,
+		typename Detail::MapTree<Key, T, Compare, Allocator, true>::iterator>;
+
+public:
+	using mapped_type		= T;
+	using value_type		= typename Base::value_type;
+	using iterator			= typename Base::iterator;
+	using const_iterator	= typename Base::const_iterator;
+	using value_compare		= Detail::MapValueCompare<value_type, Compare>;
+
+	using Base::Base;
+	using Base::insert;
+	using Base::operator=;
+
+	multimap() = default;
+
+	multimap(std::initializer_list<value_type> init,
+		const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+	: Base(init, comp, alloc) {}
+
+/* Modifiers */
+	iterator insert(const value_type& value) {
+		return this->tree.insert(value);
+	}
+
+	iterator insert(value_type&& value) {
+		return this->tree.insert(std::move(value));
+	}
+
+	iterator insert(const_iterator hint, const value_type& value) {
+		return this->tree.insert(hint, value);
+	}
+
+	iterator insert(const_iterator hint, value_type&& value) {
+		return this->tree.insert(hint, std::move(value));
+	}
+
+	template <class... Args>
+	iterator emplace(Args&&... args) {
+		return this->tree.emplace(std::forward<Args>(args)...);
+	}
+
+/* Observers */
+	value_compare value_comp() const {
+		return value_compare(this->key_comp());
+	}
+};
+
+}
+
+#endif /* MAP_HPP */
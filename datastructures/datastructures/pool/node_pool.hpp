@@ -0,0 +1,218 @@
+#ifndef NODE_POOL_HPP
+#define NODE_POOL_HPP
+
+#include <memory>
+#include <vector>
+#include <utility>
+#include <algorithm>
+#include <cstddef>
+#include <type_traits>
+
+namespace DSA {
+
+/*
+Fixed-size node allocator for linked structures.
+
+Nodes are carved from chunks of increasing size (64, 128 ... 4096 nodes),
+freed nodes go on an intrusive free list and are handed out again first,
+so nodes of one structure stay close together and allocating a node is
+a pointer pop instead of a call to the allocator.
+
+The pool only manages memory: nodes are constructed with create() and
+destroyed with destroy(), release() frees every chunk at once without
+running destructors. */
+template <typename T, typename Alloc = std::allocator<T>>
+class NodePool {
+private:
+	union Slot {
+		Slot* next;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+	};
+
+	struct Chunk {
+		Slot* slots;
+		std::size_t count;
+	};
+
+	using slot_allocator_type = typename std::allocator_traits<Alloc>::template rebind_alloc<Slot>;
+	using slot_traits = std::allocator_traits<slot_allocator_type>;
+
+public:
+	using value_type		= T;
+	using allocator_type	= Alloc;
+	using size_type			= std::size_t;
+
+	static constexpr size_type min_chunk = 64;
+	static constexpr size_type max_chunk = 4096;
+
+public:
+	explicit NodePool(const Alloc& alloc = Alloc())
+	: alloc(alloc), free_head(nullptr), free_tail(nullptr), next_chunk(min_chunk), offset(0) {}
+
+	NodePool(const NodePool& other) = delete;
+	NodePool& operator=(const NodePool& rhs) = delete;
+
+	NodePool(NodePool&& other) noexcept
+	: NodePool(other.alloc) {
+		swap(other);
+	}
+
+	NodePool& operator=(NodePool&& rhs) noexcept {
+		if (this != &rhs) {
+			release();
+			swap(rhs);
+		}
+		return *this;
+	}
+
+	~NodePool() {
+		release();
+	}
+
+	/*
+	Uninitialized memory for one T */
+	T* allocate() {
+		if (free_head) {
+			Slot* slot = free_head;
+			free_head = slot->next;
+			if (!free_head) {
+				free_tail = nullptr;
+			}
+			return reinterpret_cast<T*>(slot);
+		}
+		if (chunks.empty() || offset == chunks.back().count) {
+			grow();
+		}
+		return reinterpret_cast<T*>(chunks.back().slots + offset++);
+	}
+
+	void deallocate(T* p) noexcept {
+		Slot* slot = reinterpret_cast<Slot*>(p);
+		slot->next = free_head;
+		free_head = slot;
+		if (!free_tail) {
+			free_tail = slot;
+		}
+	}
+
+	template <typename... Args>
+	T* create(Args&&... args) {
+		T* p = allocate();
+		try {
+			::new (static_cast<void*>(p)) T(std::forward<Args>(args)...);
+		} catch (...) {
+			deallocate(p);
+			throw;
+		}
+		return p;
+	}
+
+	void destroy(T* p) noexcept {
+		p->~T();
+		deallocate(p);
+	}
+
+	/*
+	Takes over the chunks and free nodes of other, so that nodes allocated from other
+	may be deallocated into this pool. The allocators must compare equal. O(chunks) */
+	void splice(NodePool& other) {
+		if (this == &other) {
+			return;
+		}
+		// the partially used chunk of other stays last, unused slots of the own last chunk go to the free list
+		if (!chunks.empty()) {
+			Chunk& last = chunks.back();
+			while (offset < last.count) {
+				deallocate(reinterpret_cast<T*>(last.slots + offset++));
+			}
+		}
+		if (other.free_head) {
+			if (free_tail) {
+				free_tail->next = other.free_head;
+			} else {
+				free_head = other.free_head;
+			}
+			free_tail = other.free_tail;
+		}
+		chunks.insert(chunks.end(), other.chunks.begin(), other.chunks.end());
+		offset = other.chunks.empty() ? (chunks.empty() ? 0 : chunks.back().count) : other.offset;
+		next_chunk = std::max(next_chunk, other.next_chunk);
+		other.chunks.clear();
+		other.reset();
+	}
+
+	/*
+	Frees every chunk, destructors of live nodes are not run */
+	void release() noexcept {
+		for (const Chunk& chunk : chunks) {
+			slot_traits::deallocate(alloc, chunk.slots, chunk.count);
+		}
+		chunks.clear();
+		reset();
+	}
+
+	/*
+	Nodes the pool can hold without allocating a chunk */
+	size_type capacity() const {
+		size_type total = 0;
+		for (const Chunk& chunk : chunks) {
+			total += chunk.count;
+		}
+		return total;
+	}
+
+	size_type chunkCount() const {
+		return chunks.size();
+	}
+
+	allocator_type get_allocator() const {
+		return allocator_type(alloc);
+	}
+
+	void swap(NodePool& other) noexcept {
+		std::swap(alloc, other.alloc);
+		std::swap(chunks, other.chunks);
+		std::swap(free_head, other.free_head);
+		std::swap(free_tail, other.free_tail);
+		std::swap(next_chunk, other.next_chunk);
+		std::swap(offset, other.offset);
+	}
+
+private:
+	void grow() {
+		Slot* slots = slot_traits::allocate(alloc, next_chunk);
+		try {
+			chunks.push_back(Chunk {slots, next_chunk});
+		} catch (...) {
+			slot_traits::deallocate(alloc, slots, next_chunk);
+			throw;
+		}
+		offset = 0;
+		next_chunk = std::min(next_chunk * 2, max_chunk);
+	}
+
+	void reset() noexcept {
+		free_head = nullptr;
+		free_tail = nullptr;
+		next_chunk = min_chunk;
+		offset = 0;
+	}
+
+private:
+	slot_allocator_type alloc;
+	std::vector<Chunk> chunks;
+	Slot* free_head;
+	Slot* free_tail;
+	size_type next_chunk;
+	size_type offset;
+};
+
+template <typename T, typename Alloc>
+constexpr std::size_t NodePool<T, Alloc>::min_chunk;
+
+template <typename T, typename Alloc>
+constexpr std::size_t NodePool<T, Alloc>::max_chunk;
+
+}
+
+#endif /* NODE_POOL_HPP */
@@ -3,20 +3,61 @@
 
 # include "redblack_node.hpp"
 # include "redblack_iterator.hpp"
+# include "pool/node_pool.hpp"
+# include "sfinae.hpp"
 
 # include <utility>
 # include <cstddef>
 # include <functional>
 # include <memory>
+# include <type_traits>
+# include <algorithm>
 
+namespace DSA {
+
+/*
+KeyOfValue policies: the part of a value a RedBlackTree orders by */
+template <typename T>
+struct Identity {
+	typedef T key_type;
+
+	const key_type& operator()(const T& v) const {
+		return v;
+	}
+};
+
+template <typename Pair>
+struct SelectFirst {
+	typedef typename std::remove_const<typename Pair::first_type>::type key_type;
+
+	const key_type& operator()(const Pair& p) const {
+		return p.first;
+	}
+};
+
+}
+
+/*
+Nodes are carved from a NodePool whose chunks come from Alloc (rebound to the node type),
+pass an allocator drawing from an arena to place every chunk there.
+Erased nodes are reused by later insertions, the memory of the pool is returned
+by clear() and by the destructor, which free whole chunks instead of single nodes.
+
+Compare orders the keys KeyOfValue extracts from the values.
+With Multi, equal keys are kept (a new one goes after the ones already there),
+otherwise inserting an existing key leaves the tree unchanged. */
 template <
 		typename T,
 		typename Compare = std::less<T>,
-		typename Alloc = std::allocator<T> >
+		typename Alloc = std::allocator<T>,
+		typename KeyOfValue = DSA::Identity<T>,
+		bool Multi = false>
 class RedBlackTree {
 public:
 	typedef T	value_type;
+	typedef typename KeyOfValue::key_type key_type;
 	typedef Compare compare_type;
+	typedef Compare key_compare;
 	typedef Alloc allocator_type;
 
 	typedef size_t size_type;
@@ -28,26 +69,51 @@ public:
 	typedef typename node_type::const_node_pointer const_node_pointer;
 
 	typedef typename allocator_type::template rebind<node_type>::other node_allocator_type;
+	typedef DSA::NodePool<node_type, node_allocator_type> node_pool_type;
+	typedef std::allocator_traits<node_allocator_type> node_traits;
 
 	typedef RedBlackIterator<T> iterator;
 	typedef RedBlackIterator<const T> const_iterator;
 
+	typedef typename std::conditional<Multi, iterator, std::pair<iterator, bool> >::type insert_return_type;
+
 public:
 
 	RedBlackTree(const compare_type &comp = compare_type())
-	: root(NULL), compare(comp), _size(0), min_node(NULL), max_node(NULL) {
+	: root(NULL), compare(comp), alloc(), pool(alloc), _size(0), min_node(NULL), max_node(NULL) {
 		initializeEnd();
 	}
 
+	RedBlackTree(const compare_type &comp, const allocator_type& a)
+	: root(NULL), compare(comp), alloc(a), pool(alloc), _size(0), min_node(NULL), max_node(NULL) {
+		initializeEnd();
+	}
+
+	template <typename InputIterator,
+		DSA::RequireInputIterator<InputIterator> = true>
+	RedBlackTree(InputIterator first, InputIterator last,
+				const compare_type& comp = compare_type(), const allocator_type& a = allocator_type())
+	: root(NULL), compare(comp), alloc(a), pool(alloc), _size(0), min_node(NULL), max_node(NULL) {
+		initializeEnd();
+		try {
+			assign_sorted(first, last);
+		} catch (...) {
+			clear();
+			destroyEnd();
+			throw;
+		}
+	}
+
 	RedBlackTree(const RedBlackTree& from)
-	: root(NULL), compare(from.compare), alloc(from.alloc), _size(0), min_node(NULL), max_node(NULL) {
+	: root(NULL), compare(from.compare), alloc(node_traits::select_on_container_copy_construction(from.alloc)),
+	pool(alloc), _size(0), min_node(NULL), max_node(NULL) {
 		initializeEnd();
 		*this = from;
 	}
 
 	~RedBlackTree() {
 		clear();
-		destroyNode(end_node);
+		destroyEnd();
 	}
 	RedBlackTree& operator=(const RedBlackTree& rhs) {
 		if (this == &rhs) {
@@ -81,7 +147,7 @@ public:
 	}
 
 	size_type max_size() const {
-		return alloc.max_size();
+		return node_traits::max_size(alloc);
 	}
 
 	bool empty() const {
@@ -90,22 +156,63 @@ public:
 
 /* Modifiers */
 
-	iterator insert(const value_type& v) {
-		insertValue(v);
-		checkMinMax();
-		updateEnd();
-		return createIterator(last_node);
+	insert_return_type insert(const value_type& v) {
+		return insertResult(insertAt(findInsertPosition(keyOf(v)), v));
 	}
 
-	void erase(const value_type& v) {
-		erase(find(v));
+	insert_return_type insert(value_type&& v) {
+		return insertResult(insertAt(findInsertPosition(keyOf(v)), std::move(v)));
 	}
 
-	void erase(iterator position) {
-		node_pointer x = position.base();
-		if (!isNull(x)) {
-			eraseNode(x);
+	/*
+	Amortised O(1) when v belongs right before hint, such as appending in order with hint end() */
+	iterator insert(const_iterator hint, const value_type& v) {
+		return createIterator(insertAt(findHintPosition(nodeOf(hint), keyOf(v)), v).first);
+	}
+
+	iterator insert(const_iterator hint, value_type&& v) {
+		return createIterator(insertAt(findHintPosition(nodeOf(hint), keyOf(v)), std::move(v)).first);
+	}
+
+	/*
+	The node is constructed before its key is known, and destroyed again if the key is taken */
+	template <typename... Args>
+	insert_return_type emplace(Args&&... args) {
+		node_pointer x = createNode(std::forward<Args>(args)...);
+		return insertResult(insertNode(x, findInsertPosition(keyOf(x))));
+	}
+
+	template <typename... Args>
+	iterator emplace_hint(const_iterator hint, Args&&... args) {
+		node_pointer x = createNode(std::forward<Args>(args)...);
+		return createIterator(insertNode(x, findHintPosition(nodeOf(hint), keyOf(x))).first);
+	}
+
+	/*
+	Unique keys: constructs a value from args only when k is absent, args are left untouched otherwise */
+	template <typename... Args>
+	std::pair<iterator, bool> try_emplace(const key_type& k, Args&&... args) {
+		static_assert(!Multi, "try_emplace needs unique keys");
+		std::pair<node_pointer, bool> r = insertAt(findInsertPosition(k), std::forward<Args>(args)...);
+		return std::make_pair(createIterator(r.first), r.second);
+	}
+
+	template <typename... Args>
+	std::pair<iterator, bool> try_emplace_hint(const_iterator hint, const key_type& k, Args&&... args) {
+		static_assert(!Multi, "try_emplace needs unique keys");
+		std::pair<node_pointer, bool> r = insertAt(findHintPosition(nodeOf(hint), k), std::forward<Args>(args)...);
+		return std::make_pair(createIterator(r.first), r.second);
+	}
+
+	/*
+	Returns the element after the erased one */
+	iterator erase(const_iterator position) {
+		node_pointer x = nodeOf(position);
+		if (isNull(x)) {
+			return end();
 		}
+		node_pointer next = x->nextNode();
+		eraseNode(x);
 
 		if (size() == 0) {
 			zeroTree();
@@ -113,6 +220,24 @@ public:
 			root->turnBlack();
 		}
 		updateEnd();
+		return createIterator(next);
+	}
+
+	iterator erase(const_iterator first, const_iterator last) {
+		while (first != last) {
+			first = erase(first);
+		}
+		return createIterator(nodeOf(last));
+	}
+
+	size_type erase(const key_type& k) {
+		std::pair<iterator, iterator> range = equal_range(k);
+		size_type n = 0;
+		while (range.first != range.second) {
+			range.first = erase(range.first);
+			++n;
+		}
+		return n;
 	}
 
 	void swap(RedBlackTree& rhs) {
@@ -121,75 +246,127 @@ public:
 		std::swap(max_node, rhs.max_node);
 		std::swap(end_node, rhs.end_node);
 		std::swap(_size, rhs._size);
+		std::swap(compare, rhs.compare);
+		std::swap(alloc, rhs.alloc);
+		pool.swap(rhs.pool);
 	}
 
+	/*
+	Frees the chunks of the node pool at once,
+	the tree is only walked when values have a destructor to run */
 	void clear() {
-		destroyTree(base());
+		if (!std::is_trivially_destructible<value_type>::value) {
+			destroyTree(base());
+		}
+		pool.release();
 		zeroTree();
 	}
 
+	/*
+	Replaces the contents with [first, last) in O(n) when the keys are increasing
+	(strictly, unless Multi): the values are copied into a chain of nodes,
+	which is cut into a balanced tree.
+	From the first value out of order on, the rest is inserted one by one. */
+	template <typename InputIterator,
+		DSA::RequireInputIterator<InputIterator> = true>
+	void assign_sorted(InputIterator first, InputIterator last) {
+		clear();
+		node_pointer head = NULL;
+		node_pointer tail = NULL;
+		node_pointer unordered = NULL;
+		size_type n = 0;
+		try {
+			for (; first != last; ++first) {
+				node_pointer x = createNode(*first);
+				if (!isNull(tail) && !goesAfter(keyOf(x), tail)) {
+					unordered = x;
+					++first;
+					break;
+				}
+				if (isNull(tail)) {
+					head = x;
+				} else {
+					tail->right = x;
+				}
+				tail = x;
+				++n;
+			}
+		} catch (...) {
+			destroyChain(head);
+			throw;
+		}
+		if (n > 0) {
+			min_node = head;
+			max_node = tail;
+			root = buildBalanced(head, n, 0, fullLevels(n));
+			_size = n;
+			updateEnd();
+		}
+		if (!isNull(unordered)) {
+			insertNode(unordered, findInsertPosition(keyOf(unordered)));
+		}
+		for (; first != last; ++first) {
+			emplace(*first);
+		}
+	}
+
 /* Observers */
 
 	compare_type value_comp() const {
 		return compare;
 	}
 
+	key_compare key_comp() const {
+		return compare;
+	}
+
+	allocator_type get_allocator() const {
+		return allocator_type(alloc);
+	}
+
 /* Operations */
 
-	iterator find(const value_type& v) {
-		return createIterator(findNode(v, base()));
+	iterator find(const key_type& k) {
+		return createIterator(findNode(k));
 	}
 
-	const_iterator find(const value_type& v) const {
-		return createIterator(findNode(v, base()));
+	const_iterator find(const key_type& k) const {
+		return createIterator(findNode(k));
 	}
 
-	size_type count(const value_type& val) const {
-		return find(val) != end() ? 1 : 0;
+	size_type count(const key_type& k) const {
+		if (!Multi) {
+			return isNull(findNode(k)) ? 0 : 1;
+		}
+		size_type n = 0;
+		for (const_iterator it = lower_bound(k), last = upper_bound(k); it != last; ++it) {
+			++n;
+		}
+		return n;
 	}
 
-	iterator lower_bound(const value_type& k) {
-		return lowerBoundInternal(k);
+	iterator lower_bound(const key_type& k) {
+		return createIterator(lowerBoundNode(k));
 	}
 
-	const_iterator lower_bound(const value_type& k) const {
-		return lowerBoundInternal(k);
+	const_iterator lower_bound(const key_type& k) const {
+		return createIterator(lowerBoundNode(k));
 	}
 
-	iterator upper_bound(const value_type& k) {
-		iterator it = lower_bound(k);
-		if (equalValue(*it, k)) {
-			++it;
-		}
-	
-		return it;
+	iterator upper_bound(const key_type& k) {
+		return createIterator(upperBoundNode(k));
 	}
 
-	const_iterator upper_bound(const value_type& k) const {
-		const_iterator it = lower_bound(k);
-		if (equalValue(*it, k)) {
-			++it;
-		}
-	
-		return it;
+	const_iterator upper_bound(const key_type& k) const {
+		return createIterator(upperBoundNode(k));
 	}
 
-	std::pair<iterator, iterator> equal_range(const value_type& val) {
-		iterator itlow = lower_bound(val);
-		iterator itup(itlow);
-		if (equalValue(*itup, val)) {
-			++itup;
-		}
-		return std::make_pair(itlow, itup);
+	std::pair<iterator, iterator> equal_range(const key_type& k) {
+		return std::make_pair(lower_bound(k), upper_bound(k));
 	}
 
-	std::pair<const_iterator, const_iterator> equal_range(const value_type& val) const {
-		const_iterator itlow = lower_bound(val);
-		const_iterator itup(itlow);
-		if (equalValue(*itup, val)) {
-			++itup;
-		}
-		return std::make_pair(itlow, itup);
+	std::pair<const_iterator, const_iterator> equal_range(const key_type& k) const {
+		return std::make_pair(lower_bound(k), upper_bound(k));
 	}
 
 
@@ -207,22 +384,24 @@ private:
 		return x == NULL;
 	}
 
-	bool equalValue(const value_type& a, const value_type& b) const {
-		return !(compare(a, b) || compare(b, a));
+	static const key_type& keyOf(const value_type& v) {
+		return KeyOfValue()(v);
 	}
 
-	bool compareNodes(const node_pointer a, const node_pointer b) const {
-		return compare(a->getValue(), b->getValue());
+	static const key_type& keyOf(const node_pointer x) {
+		return KeyOfValue()(x->getValue());
 	}
 
-	void checkMinMax() {
-		if (min_node == NULL || compareNodes(last_node, min_node)) {
-			min_node = last_node;
-		}
+	/*
+	Whether a new key k is placed after the node x, equal keys go after the existing ones */
+	bool goesAfter(const key_type& k, const node_pointer x) const {
+		return Multi ? !compare(k, keyOf(x)) : compare(keyOf(x), k);
+	}
 
-		if (max_node == NULL || compareNodes(max_node, last_node)) {
-			max_node = last_node;
-		}
+	/*
+	Whether a new key k is placed before the node x */
+	bool goesBefore(const key_type& k, const node_pointer x) const {
+		return Multi ? !compare(keyOf(x), k) : compare(k, keyOf(x));
 	}
 
 	void zeroTree() {
@@ -236,6 +415,10 @@ private:
 		return reinterpret_cast<const_node_pointer> (x);
 	}
 
+	static node_pointer nodeOf(const_iterator it) {
+		return reinterpret_cast<node_pointer> (it.base());
+	}
+
 	iterator createIterator(node_pointer x) {
 		if (isNull(x) || x == end_node) {
 			return iterator(NULL, endNode(), true);
@@ -253,19 +436,9 @@ private:
 	}
 
 /* Node Allocation */
-	node_pointer newNode(const value_type& a) {
-		return newNode(a, NULL);
-	}
-
-	node_pointer newNode(const value_type& a, node_pointer parent) {
-		last_node = alloc.allocate(1);
-		try {
-			alloc.construct(last_node, node_type(a, parent));	
-		} catch (...) {
-			alloc.deallocate(last_node, 1);
-			throw;
-		}
-		return last_node;
+	template <typename... Args>
+	node_pointer createNode(Args&&... args) {
+		return pool.create(typename node_type::InPlaceTag(), std::forward<Args>(args)...);
 	}
 
 	void destroyNodeCheckMinMax(node_pointer x) {
@@ -280,8 +453,7 @@ private:
 	}
 
 	void destroyNode(node_pointer x) {
-		alloc.destroy(x);
-		alloc.deallocate(x, 1);
+		pool.destroy(x);
 	}
 
 /* Node Getters */
@@ -299,11 +471,11 @@ private:
 		node_pointer y = x->right;
 
 		replaceParentLink(x, y);
-		y->parent = x->parent;
+		y->setParent(x->getParent());
 		x->right = y->left;
-		x->parent = y;
+		x->setParent(y);
 		if (!isNull(x->right)) {
-			x->right->parent = x;
+			x->right->setParent(x);
 		}
 		y->left = x;
 	}
@@ -311,77 +483,148 @@ private:
 	void rotateRight(node_pointer x) {
 		node_pointer y = x->left;
 		replaceParentLink(x, y);
-		y->parent = x->parent;
+		y->setParent(x->getParent());
 		x->left = y->right;
-		x->parent = y;
+		x->setParent(y);
 		if (!isNull(x->left)) {
-			x->left->parent = x;
+			x->left->setParent(x);
 		}
 		y->right = x;
 	}
 
 	void replaceParentLink(node_pointer x, node_pointer replacement) {
-		if (isNull(x->parent)) {
+		if (isNull(x->getParent())) {
 			root = replacement;
-		} else if (x == x->parent->right) {
-			x->parent->right = replacement;
+		} else if (x == x->getParent()->right) {
+			x->getParent()->right = replacement;
 		} else {
-			x->parent->left = replacement;
+			x->getParent()->left = replacement;
 		}
 	}
 
 /* Insertion */
 
-	void insertValue(const value_type& v) {
-
-		node_pointer x = findInsertPosition(v);
-		if (isNull(x)) {
-			root = newNode(v);
-		} else if (compare(v, x->getValue())) {
-			x->left = newNode(v, x);
-		} else if (compare(x->getValue(), v)) {
-			x->right = newNode(v, x);
-		} else {
-			last_node = x;
-			return;
-		}
+	/*
+	Where a new key goes: the left or right child of parent, which is NULL in an empty tree.
+	With unique keys, equal is the node holding the key already, if any. */
+	struct InsertPosition {
+		node_pointer parent;
+		bool left;
+		node_pointer equal;
+	};
 
-		insertFixProperty(last_node);
-		_size += 1;
+	static InsertPosition makePosition(node_pointer parent, bool left, node_pointer equal = NULL) {
+		InsertPosition pos = {parent, left, equal};
+		return pos;
 	}
 
 	/*
-	** Return: node with value v if exists, or parent of insert position
-	*/
-	node_pointer findInsertPosition(const value_type& v) const {
-
-		if (isNewMin(v)) {
-			return min_node;
-		} else if (isNewMax(v)) {
-			return max_node;
+	New minimum and maximum are found without descending */
+	InsertPosition findInsertPosition(const key_type& k) const {
+		if (isNull(root)) {
+			return makePosition(NULL, false);
+		} else if (goesAfter(k, max_node)) {
+			return makePosition(max_node, false);
+		} else if (compare(k, keyOf(min_node))) {
+			return makePosition(min_node, true);
 		}
 
 		node_pointer x = base();
 		node_pointer parent = NULL;
+		bool left = false;
 		while (!isNull(x)) {
 			parent = x;
-			if (compare(v, x->getValue())) {
-				x = x->left;
-			} else if (compare(x->getValue(), v)) {
-				x = x->right;
-			} else {
-				return x;
+			left = compare(k, keyOf(x));
+			if (!Multi && !left && !compare(keyOf(x), k)) {
+				return makePosition(x, false, x);
+			}
+			x = left ? x->left : x->right;
+		}
+		return makePosition(parent, left);
+	}
+
+	/*
+	A new key fitting right before hint (NULL for end) is linked next to it or to its predecessor,
+	one of which has a free child; with unique keys, right after hint as well.
+	Anything else is looked up from the root. */
+	InsertPosition findHintPosition(node_pointer hint, const key_type& k) const {
+		if (isNull(hint)) {
+			if (!isNull(max_node) && goesAfter(k, max_node)) {
+				return makePosition(max_node, false);
+			}
+		} else if (goesBefore(k, hint)) {
+			if (hint == min_node) {
+				return makePosition(min_node, true);
+			}
+			node_pointer prev = hint->prevNode();
+			if (goesAfter(k, prev)) {
+				return isNull(prev->right) ? makePosition(prev, false) : makePosition(hint, true);
+			}
+		} else if (!Multi) {
+			if (!compare(keyOf(hint), k)) {
+				return makePosition(hint, false, hint);
+			}
+			node_pointer next = hint->nextNode();
+			if (isNull(next)) {
+				return makePosition(hint, false);
+			} else if (compare(k, keyOf(next))) {
+				return isNull(hint->right) ? makePosition(hint, false) : makePosition(next, true);
+			}
+		}
+		return findInsertPosition(k);
+	}
+
+	/*
+	Constructs the node only when the key is not taken */
+	template <typename... Args>
+	std::pair<node_pointer, bool> insertAt(const InsertPosition& pos, Args&&... args) {
+		if (!isNull(pos.equal)) {
+			return std::make_pair(pos.equal, false);
+		}
+		return std::make_pair(linkNode(createNode(std::forward<Args>(args)...), pos), true);
+	}
+
+	std::pair<node_pointer, bool> insertNode(node_pointer x, const InsertPosition& pos) {
+		if (!isNull(pos.equal)) {
+			destroyNode(x);
+			return std::make_pair(pos.equal, false);
+		}
+		return std::make_pair(linkNode(x, pos), true);
+	}
+
+	node_pointer linkNode(node_pointer x, const InsertPosition& pos) {
+		x->setParent(pos.parent);
+		if (isNull(pos.parent)) {
+			root = x;
+			min_node = x;
+			max_node = x;
+		} else if (pos.left) {
+			pos.parent->left = x;
+			if (pos.parent == min_node) {
+				min_node = x;
+			}
+		} else {
+			pos.parent->right = x;
+			if (pos.parent == max_node) {
+				max_node = x;
 			}
 		}
-		return parent;
+		insertFixProperty(x);
+		_size += 1;
+		updateEnd();
+		return x;
 	}
 
-	bool isNewMin(const value_type& v) const {
-		return isNull(min_node) || compare(v, min_node->getValue());
+	insert_return_type insertResult(const std::pair<node_pointer, bool>& r) {
+		return insertResult(r, std::integral_constant<bool, Multi>());
 	}
 
-	bool isNewMax(const value_type& v) const {
-		return isNull(max_node) || compare(max_node->getValue(), v);
+	iterator insertResult(const std::pair<node_pointer, bool>& r, std::true_type) {
+		return createIterator(r.first);
+	}
+
+	std::pair<iterator, bool> insertResult(const std::pair<node_pointer, bool>& r, std::false_type) {
+		return std::make_pair(createIterator(r.first), r.second);
 	}
 
 	/*
@@ -391,11 +634,11 @@ private:
 
 	void insertFixProperty(node_pointer x) {
 
-		while (isRed(x->parent)) {
+		while (isRed(x->getParent())) {
 			node_pointer uncle = x->getUncle();
 			if (isRed(uncle)) {
 				insertCaseOne(x, uncle);
-				x = x->parent->parent;
+				x = x->getParent()->getParent();
 			} else {
 				x = insertCaseTwo(x);
 				insertCaseThree(x);
@@ -405,17 +648,17 @@ private:
 	}
 
 	void insertCaseOne(node_pointer x, node_pointer uncle) {
-		x->parent->turnBlack();
+		x->getParent()->turnBlack();
 		uncle->turnBlack();
-		uncle->parent->turnRed();
+		uncle->getParent()->turnRed();
 	}
 
 	node_pointer insertCaseTwo(node_pointer x) {
-		node_pointer y = x->parent;
-		if (x == x->parent->right && x->parent == x->parent->parent->left) {
-			rotateLeft(x->parent);
-		} else if (x == x->parent->left && x->parent == x->parent->parent->right) {
-			rotateRight(x->parent);
+		node_pointer y = x->getParent();
+		if (x == x->getParent()->right && x->getParent() == x->getParent()->getParent()->left) {
+			rotateLeft(x->getParent());
+		} else if (x == x->getParent()->left && x->getParent() == x->getParent()->getParent()->right) {
+			rotateRight(x->getParent());
 		} else {
 			return x;
 		}
@@ -424,12 +667,12 @@ private:
 	}
 
 	void insertCaseThree(node_pointer x) {
-		x->parent->turnBlack();
-		x->parent->parent->turnRed();
-		if (x->parent == x->parent->parent->left) {
-			rotateRight(x->parent->parent);
+		x->getParent()->turnBlack();
+		x->getParent()->getParent()->turnRed();
+		if (x->getParent() == x->getParent()->getParent()->left) {
+			rotateRight(x->getParent()->getParent());
 		} else {
-			rotateLeft(x->parent->parent);
+			rotateLeft(x->getParent()->getParent());
 		}
 	}
 
@@ -442,8 +685,8 @@ private:
 			// Possibilities: x->right is NULL or x->right is RED
 			if (isRed(x->right)) {
 				x->right->turnBlack();
-			} else if (isBlack(x) && !isNull(x->parent)) {
-				eraseFixProperty(x->right, x->parent);
+			} else if (isBlack(x) && !isNull(x->getParent())) {
+				eraseFixProperty(x->right, x->getParent());
 			}
 		} else if (isNull(x->right)) {
 			cutNodeLink(x, x->left);
@@ -452,7 +695,7 @@ private:
 			// So we turn it black to preserve property 4
 			x->left->turnBlack();
 		} else {
-			node_pointer y = findMin(x->left);
+			node_pointer y = findMax(x->left);
 			swapNode(x, y);
 			eraseNode(x);
 			return;
@@ -463,16 +706,16 @@ private:
 
 	void cutNodeLink(node_pointer x, node_pointer y) {
 		if (!isNull(y)) {
-			y->parent = x->parent;
+			y->setParent(x->getParent());
 		}
-		if (isNull(x->parent)) {
+		if (isNull(x->getParent())) {
 			root = y;
 			return;
 		}
-		if (x == x->parent->right) {
-			x->parent->right = y;
+		if (x == x->getParent()->right) {
+			x->getParent()->right = y;
 		} else {
-			x->parent->left = y;
+			x->getParent()->left = y;
 		}
 	}
 
@@ -496,7 +739,7 @@ private:
 				eraseFixFinalize(parent, sibling);
 				return;
 			}
-			parent = x->parent;
+			parent = x->getParent();
 		} while (!isNull(parent));
 	}
 
@@ -574,59 +817,86 @@ private:
 /* Node Swapping */
 
 	void swapNode(node_pointer x, node_pointer y) {
-		if (x->parent == y) {
+		if (x->getParent() == y) {
 			swapNode(y, x);
+			return;
 		}
 		replaceParentPointer(x, y);
 		replaceParentPointer(y, x);
 		swapPointers(x, y);
-		if (x->parent == x) {
-			x->parent = y;
+		if (x->getParent() == x) {
+			x->setParent(y);
 		}
 		updateChildPointers(x);
 		updateChildPointers(y);
 	}
 
 	void replaceParentPointer(node_pointer x, node_pointer y) {
-		if (isNull(x->parent)) {
+		if (isNull(x->getParent())) {
 			root = y;
-		} else if (x == x->parent->left) {
-			x->parent->left = y;
+		} else if (x == x->getParent()->left) {
+			x->getParent()->left = y;
 		} else {
-			x->parent->right = y;
+			x->getParent()->right = y;
 		}
 	}
 
 	void swapPointers(node_pointer x, node_pointer y) const {
-		std::swap(x->left, y->left);
-		std::swap(x->right, y->right);
-		std::swap(x->parent, y->parent);
-		std::swap(x->getColor(), y->getColor());
+		x->swapLinks(*y);
 	}
 
 	void updateChildPointers(node_pointer x) const {
 		if (!isNull(x->left)) {
-			x->left->parent = x;
+			x->left->setParent(x);
 		}
 
 		if (!isNull(x->right)) {
-			x->right->parent = x;
+			x->right->setParent(x);
 		}
 	}
 
 /* Searching */
 
-	node_pointer findNode(const value_type& v, node_pointer x) const {
+	/*
+	The first node with key k */
+	node_pointer findNode(const key_type& k) const {
+		node_pointer x = lowerBoundNode(k);
+		if (isNull(x) || compare(k, keyOf(x))) {
+			return NULL;
+		}
+		return x;
+	}
+
+	/*
+	First node with a key not less than k, NULL if there is none */
+	node_pointer lowerBoundNode(const key_type& k) const {
+		node_pointer x = base();
+		node_pointer bound = NULL;
 		while (!isNull(x)) {
-			if (compare(v, x->getValue())) {
-				x = x->left;
-			} else if (compare(x->getValue(), v)) {
+			if (compare(keyOf(x), k)) {
 				x = x->right;
 			} else {
-				return x;
+				bound = x;
+				x = x->left;
 			}
 		}
-		return NULL;
+		return bound;
+	}
+
+	/*
+	First node with a key greater than k, NULL if there is none */
+	node_pointer upperBoundNode(const key_type& k) const {
+		node_pointer x = base();
+		node_pointer bound = NULL;
+		while (!isNull(x)) {
+			if (compare(k, keyOf(x))) {
+				bound = x;
+				x = x->left;
+			} else {
+				x = x->right;
+			}
+		}
+		return bound;
 	}
 
 	node_pointer findMin(node_pointer x) const {
@@ -650,6 +920,44 @@ private:
 		return x;
 	}
 
+/* Sorted Construction */
+	/*
+	Links the first n nodes of the chain (through right) into a subtree, head moves past them.
+	Both halves differ by at most one node, so every level but the lowest is full:
+	those nodes are black and the ones on the lowest level red, every path has the same black height. */
+	node_pointer buildBalanced(node_pointer& head, size_type n, size_type depth, size_type red_depth) {
+		if (n == 0) {
+			return NULL;
+		}
+		const size_type left_size = (n - 1) / 2;
+		node_pointer left = buildBalanced(head, left_size, depth + 1, red_depth);
+		node_pointer x = head;
+		head = head->right;
+		x->left = left;
+		x->right = buildBalanced(head, n - 1 - left_size, depth + 1, red_depth);
+		updateChildPointers(x);
+		x->assignColor(depth == red_depth ? node_type::RED : node_type::BLACK);
+		return x;
+	}
+
+	/*
+	Levels a balanced tree of n nodes fills completely: floor(log2(n + 1)) */
+	static size_type fullLevels(size_type n) {
+		size_type levels = 0;
+		for (size_type m = n + 1; m > 1; m >>= 1) {
+			++levels;
+		}
+		return levels;
+	}
+
+	void destroyChain(node_pointer x) {
+		while (!isNull(x)) {
+			node_pointer next = x->right;
+			destroyNode(x);
+			x = next;
+		}
+	}
+
 /* Deep Copy, Assignation */
 	void assign(const RedBlackTree& x) {
 		clear();
@@ -666,37 +974,38 @@ private:
 		y->left = copyTree(x->left, y, from);
 		y->right = copyTree(x->right, y, from);
 		if (x == from.max_node) {
-			max_node = x;
+			max_node = y;
 		}
 		if (x == from.min_node) {
-			min_node = x;
+			min_node = y;
 		}
 		return y;
 	}
 
 	node_pointer copyNode(node_pointer x, node_pointer parent) {
-		node_pointer y = alloc.allocate(1);
-		try {
-			alloc.construct(y, *x);
-		} catch (...) {
-			alloc.deallocate(y, 1);
-			throw;
-		}
-		y->parent = parent;
+		node_pointer y = pool.create(*x);
+		y->setParent(parent);
 		return y;
 	}
 
 /* End Node */
+	/*
+	The end node does not come from the pool: it outlives clear() */
 	void initializeEnd() {
-		end_node = alloc.allocate(1);
+		end_node = node_traits::allocate(alloc, 1);
 		try {
-			alloc.construct(end_node, node_type());
+			node_traits::construct(alloc, end_node);
 		} catch (...) {
-			alloc.deallocate(end_node, 1);
+			node_traits::deallocate(alloc, end_node, 1);
 			throw;
 		}
 	}
 
+	void destroyEnd() {
+		node_traits::destroy(alloc, end_node);
+		node_traits::deallocate(alloc, end_node, 1);
+	}
+
 	void updateEnd() {
 		end_node->left = max_node;
 	}
@@ -710,6 +1019,8 @@ private:
 	}
 
 /* Destruction */
+	/*
+	Runs the destructors, the memory is freed with the pool */
 	void destroyTree(node_pointer x) {
 		if (isNull(x)) {
 			return;
@@ -717,101 +1028,53 @@ private:
 
 		destroyTree(x->left);
 		destroyTree(x->right);
-		destroyNode(x);
-	}
-
-/* Operations */
-
-	iterator lowerBoundInternal(const value_type& k) {
-		node_pointer x = base();
-
-		while (!isNull(x)) {
-			if (compare(k, x->getValue())) {
-				if (isNull(x->left)) {
-					return createIterator(x);
-				}
-				x = x->left;
-			} else if (compare(x->getValue(), k)) {
-				if (isNull(x->right)) {
-					x = x->nextNode();
-					return createIterator(x);
-				}
-				x = x->right;
-			} else {
-				return createIterator(x);
-			}
-		}
-
-		return end();
-	}
-
-	const_iterator lowerBoundInternal(const value_type& k) const {
-		node_pointer x = base();
-
-		while (!isNull(x)) {
-			if (compare(k, x->getValue())) {
-				if (isNull(x->left)) {
-					return createIterator(x);
-				}
-				x = x->left;
-			} else if (compare(x->getValue(), k)) {
-				if (isNull(x->right)) {
-					x = x->nextNode();
-					return createIterator(x);
-				}
-				x = x->right;
-			} else {
-				return createIterator(x);
-			}
-		}
-
-		return end();
+		x->~node_type();
 	}
 
 private:
 	node_pointer root;
 	compare_type compare;
 	node_allocator_type alloc;
+	node_pool_type pool;
 	size_type _size;
 
-	node_pointer last_node;
 	node_pointer min_node;
 	node_pointer max_node;
 	node_pointer end_node;
 };
 
-template< class Key, class Compare, class Alloc >
-bool operator==(const RedBlackTree<Key, Compare, Alloc>& lhs,
-				const RedBlackTree<Key, Compare, Alloc>& rhs ) {
+template< class Key, class Compare, class Alloc, class KeyOfValue, bool Multi >
+bool operator==(const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& lhs,
+				const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& rhs ) {
 	if (lhs.size() != rhs.size()) {
 		return false;
 	}
 
 	return std::equal(lhs.begin(), lhs.end(), rhs.begin());
 }
-template< class Key, class Compare, class Alloc >
-bool operator!=(const RedBlackTree<Key, Compare, Alloc>& lhs,
-				const RedBlackTree<Key, Compare, Alloc>& rhs) {
+template< class Key, class Compare, class Alloc, class KeyOfValue, bool Multi >
+bool operator!=(const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& lhs,
+				const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& rhs) {
 	return !(lhs == rhs);
 }
-template< class Key, class Compare, class Alloc >
-bool operator<( const RedBlackTree<Key, Compare, Alloc>& lhs,
-				const RedBlackTree<Key, Compare, Alloc>& rhs) {
+template< class Key, class Compare, class Alloc, class KeyOfValue, bool Multi >
+bool operator<( const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& lhs,
+				const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& rhs) {
 	return std::lexicographical_compare(lhs.begin(), lhs.end(), rhs.begin(), rhs.end());
 }
-template< class Key, class Compare, class Alloc >
-bool operator<=(const RedBlackTree<Key, Compare, Alloc>& lhs,
-				const RedBlackTree<Key, Compare, Alloc>& rhs) {
+template< class Key, class Compare, class Alloc, class KeyOfValue, bool Multi >
+bool operator<=(const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& lhs,
+				const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& rhs) {
 	return !(rhs < lhs);
 }
-template< class Key, class Compare, class Alloc >
-bool operator>( const RedBlackTree<Key, Compare, Alloc>& lhs,
-				const RedBlackTree<Key, Compare, Alloc>& rhs) {
+template< class Key, class Compare, class Alloc, class KeyOfValue, bool Multi >
+bool operator>( const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& lhs,
+				const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& rhs) {
 	return rhs < lhs;
 }
-template< class Key, class Compare, class Alloc >
-bool operator>=(const RedBlackTree<Key, Compare, Alloc>& lhs,
-				const RedBlackTree<Key, Compare, Alloc>& rhs) {
+template< class Key, class Compare, class Alloc, class KeyOfValue, bool Multi >
+bool operator>=(const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& lhs,
+				const RedBlackTree<Key, Compare, Alloc, KeyOfValue, Multi>& rhs) {
 	return !(lhs < rhs);
 }
 
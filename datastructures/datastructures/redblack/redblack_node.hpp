@@ -2,7 +2,13 @@
 # define REDBLACK_NODE_HPP
 
 # include <cstddef>
+# include <cstdint>
+# include <utility>
 
+/*
+The colour is kept in the low bit of the parent pointer (nodes are at least pointer-aligned),
+which saves the padded colour field: 4 pointers per node for values up to 8 bytes.
+left, right and the value come first, since a search reads nothing else. */
 template <typename T>
 class RedBlackNode {
 public:
@@ -20,27 +26,37 @@ public:
 
 
 	enum ColorType {
-		RED,
-		BLACK
+		RED = 0,
+		BLACK = 1
 	};
 
 	typedef enum ColorType color_type;
 
 private:
-	RedBlackNode(node_pointer left, node_pointer right, node_pointer parent, const value_type& val, color_type color)
-	: left(left), right(right), parent(parent), value(val), color(color) {}
+	typedef std::uintptr_t link_type;
+
+	static const link_type color_bit = 1;
+
 public:
 	RedBlackNode()
-	: left(NULL), right(NULL), parent(NULL), color(RED) {}
+	: left(NULL), right(NULL), parent_link(0) {}
 	
 	RedBlackNode(const RedBlackNode& from)
-	: left(from.left), right(from.right), parent(from.parent), value(from.getValue()), color(from.getColor()) {}
+	: left(from.left), right(from.right), value(from.getValue()), parent_link(from.parent_link) {}
 
 	RedBlackNode(const value_type& val)
-	: left(NULL), right(NULL), parent(NULL), value(val), color(RED) {}
+	: left(NULL), right(NULL), value(val), parent_link(0) {}
 
 	RedBlackNode(const value_type& val, node_pointer parent)
-	: left(NULL), right(NULL), parent(parent), value(val), color(RED) {}
+	: left(NULL), right(NULL), value(val), parent_link(reinterpret_cast<link_type>(parent)) {}
+
+	/*
+	Constructs the value from args */
+	struct InPlaceTag {};
+
+	template <typename... Args>
+	RedBlackNode(InPlaceTag, Args&&... args)
+	: left(NULL), right(NULL), value(std::forward<Args>(args)...), parent_link(0) {}
 
 
 	~RedBlackNode() {}
@@ -53,43 +69,57 @@ public:
 		return value;
 	}
 
+	node_pointer getParent() const {
+		return reinterpret_cast<node_pointer>(parent_link & ~color_bit);
+	}
+
+	void setParent(node_pointer p) {
+		parent_link = reinterpret_cast<link_type>(p) | (parent_link & color_bit);
+	}
+
 	void assignColor(color_type c) {
-		color = c;
+		parent_link = (parent_link & ~color_bit) | static_cast<link_type>(c);
 	}
 
 	void turnBlack() {
-		color = BLACK;
+		parent_link |= color_bit;
 	}
 
 	void turnRed() {
-		color = RED;
+		parent_link &= ~color_bit;
 	}
 
 	bool isBlack() const {
-		return color == BLACK;
+		return (parent_link & color_bit) != 0;
 	}
 
 	bool isRed() const {
-		return color == RED;
+		return !isBlack();
 	}
 
-	color_type& getColor() {
-		return color;
+	color_type getColor() const {
+		return static_cast<color_type>(parent_link & color_bit);
 	}
 
-	const color_type& getColor() const {
-		return color;
+	/*
+	Exchanges the position in the tree: children, parent and colour, the values stay */
+	void swapLinks(RedBlackNode& other) {
+		std::swap(left, other.left);
+		std::swap(right, other.right);
+		std::swap(parent_link, other.parent_link);
 	}
 
 	node_pointer getUncle() {
-		if (parent == parent->parent->left) {
-			return parent->parent->right;
+		node_pointer parent = getParent();
+		if (parent == parent->getParent()->left) {
+			return parent->getParent()->right;
 		} else {
-			return parent->parent->left;
+			return parent->getParent()->left;
 		}
 	}
 
 	node_pointer getSibling() {
+		node_pointer parent = getParent();
 		if (this == parent->left) {
 			return parent->right;
 		} else {
@@ -106,7 +136,7 @@ public:
 			return findMin(right);
 		}
 
-		return nextNodeUp(this, parent);
+		return nextNodeUp(this, getParent());
 	}
 
 	node_pointer prevNode() const {
@@ -114,7 +144,7 @@ public:
 			return findMax(left);
 		}
 
-		return prevNodeUp(this, parent);
+		return prevNodeUp(this, getParent());
 	}
 
 private:
@@ -141,7 +171,7 @@ private:
 			}
 
 			prev = x;
-			x = x->parent;
+			x = x->getParent();
 		}
 		return NULL;
 	}
@@ -153,7 +183,7 @@ private:
 			}
 
 			prev = x;
-			x = x->parent;
+			x = x->getParent();
 		}
 
 		return NULL;
@@ -162,11 +192,13 @@ private:
 public:
 	node_pointer left;
 	node_pointer right;
-	node_pointer parent;
 
 private:
 	value_type value;
-	color_type color;
+	link_type parent_link;
 };
 
+template <typename T>
+const typename RedBlackNode<T>::link_type RedBlackNode<T>::color_bit;
+
 #endif /* REDBLACK_NODE_HPP */
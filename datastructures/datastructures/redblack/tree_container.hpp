@@ -0,0 +1,244 @@
+#ifndef TREE_CONTAINER_HPP
+#define TREE_CONTAINER_HPP
+
+#include "redblack.hpp"
+#include "sfinae.hpp"
+#include <initializer_list>
+#include <utility>
+#include <cstddef>
+
+namespace DSA {
+
+	namespace Detail {
+
+	/*
+	What map, multimap, set and multiset share: a RedBlackTree and the operations forwarded to it.
+	Iterator is the mutable iterator of the container, a const iterator for sets. */
+	template <typename Tree, typename Iterator>
+	class TreeContainer {
+	public:
+		using key_type			= typename Tree::key_type;
+		using value_type		= typename Tree::value_type;
+		using size_type			= std::size_t;
+		using difference_type	= std::ptrdiff_t;
+		using key_compare		= typename Tree::key_compare;
+		using allocator_type	= typename Tree::allocator_type;
+		using reference			= value_type&;
+		using const_reference	= const value_type&;
+		using iterator			= Iterator;
+		using const_iterator	= typename Tree::const_iterator;
+
+	public:
+		TreeContainer()
+		: tree() {}
+
+		explicit TreeContainer(const key_compare& comp, const allocator_type& alloc = allocator_type())
+		: tree(comp, alloc) {}
+
+		explicit TreeContainer(const allocator_type& alloc)
+		: tree(key_compare(), alloc) {}
+
+		/*
+		O(n) for sorted input */
+		template <class InputIt,
+			RequireInputIterator<InputIt> = true>
+		TreeContainer(InputIt first, InputIt last,
+				const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+		: tree(first, last, comp, alloc) {}
+
+		TreeContainer(std::initializer_list<value_type> init,
+				const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type())
+		: tree(init.begin(), init.end(), comp, alloc) {}
+
+		TreeContainer(const TreeContainer& other)
+		: tree(other.tree) {}
+
+		TreeContainer(TreeContainer&& other)
+		: tree(other.key_comp(), other.get_allocator()) {
+			tree.swap(other.tree);
+		}
+
+		TreeContainer& operator=(const TreeContainer& rhs) {
+			tree = rhs.tree;
+			return *this;
+		}
+
+		TreeContainer& operator=(TreeContainer&& rhs) {
+			if (this != &rhs) {
+				clear();
+				tree.swap(rhs.tree);
+			}
+			return *this;
+		}
+
+		TreeContainer& operator=(std::initializer_list<value_type> init) {
+			tree.assign_sorted(init.begin(), init.end());
+			return *this;
+		}
+
+		allocator_type get_allocator() const {
+			return tree.get_allocator();
+		}
+
+	/* Iterators */
+		iterator begin() {
+			return tree.begin();
+		}
+
+		const_iterator begin() const {
+			return tree.begin();
+		}
+
+		const_iterator cbegin() const {
+			return tree.begin();
+		}
+
+		iterator end() {
+			return tree.end();
+		}
+
+		const_iterator end() const {
+			return tree.end();
+		}
+
+		const_iterator cend() const {
+			return tree.end();
+		}
+
+	/* Capacity */
+		bool empty() const {
+			return tree.empty();
+		}
+
+		size_type size() const {
+			return tree.size();
+		}
+
+		size_type max_size() const {
+			return tree.max_size();
+		}
+
+	/* Modifiers */
+		void clear() {
+			tree.clear();
+		}
+
+		/*
+		Every element is inserted with hint end(): O(n) for sorted input */
+		template <class InputIt,
+			RequireInputIterator<InputIt> = true>
+		void insert(InputIt first, InputIt last) {
+			for (; first != last; ++first) {
+				tree.emplace_hint(tree.end(), *first);
+			}
+		}
+
+		void insert(std::initializer_list<value_type> init) {
+			insert(init.begin(), init.end());
+		}
+
+		template <class... Args>
+		iterator emplace_hint(const_iterator hint, Args&&... args) {
+			return tree.emplace_hint(hint, std::forward<Args>(args)...);
+		}
+
+		iterator erase(const_iterator pos) {
+			return tree.erase(pos);
+		}
+
+		iterator erase(const_iterator first, const_iterator last) {
+			return tree.erase(first, last);
+		}
+
+		size_type erase(const key_type& key) {
+			return tree.erase(key);
+		}
+
+		void swap(TreeContainer& other) {
+			tree.swap(other.tree);
+		}
+
+		friend void swap(TreeContainer& lhs, TreeContainer& rhs) {
+			lhs.swap(rhs);
+		}
+
+	/* Lookup */
+		size_type count(const key_type& key) const {
+			return tree.count(key);
+		}
+
+		iterator find(const key_type& key) {
+			return tree.find(key);
+		}
+
+		const_iterator find(const key_type& key) const {
+			return tree.find(key);
+		}
+
+		bool contains(const key_type& key) const {
+			return find(key) != end();
+		}
+
+		std::pair<iterator, iterator> equal_range(const key_type& key) {
+			return std::pair<iterator, iterator>(tree.equal_range(key));
+		}
+
+		std::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+			return tree.equal_range(key);
+		}
+
+		iterator lower_bound(const key_type& key) {
+			return tree.lower_bound(key);
+		}
+
+		const_iterator lower_bound(const key_type& key) const {
+			return tree.lower_bound(key);
+		}
+
+		iterator upper_bound(const key_type& key) {
+			return tree.upper_bound(key);
+		}
+
+		const_iterator upper_bound(const key_type& key) const {
+			return tree.upper_bound(key);
+		}
+
+	/* Observers */
+		key_compare key_comp() const {
+			return tree.key_comp();
+		}
+
+	/* Comparison */
+		friend bool operator==(const TreeContainer& lhs, const TreeContainer& rhs) {
+			return lhs.tree == rhs.tree;
+		}
+
+		friend bool operator!=(const TreeContainer& lhs, const TreeContainer& rhs) {
+			return lhs.tree != rhs.tree;
+		}
+
+		friend bool operator<(const TreeContainer& lhs, const TreeContainer& rhs) {
+			return lhs.tree < rhs.tree;
+		}
+
+		friend bool operator<=(const TreeContainer& lhs, const TreeContainer& rhs) {
+			return lhs.tree <= rhs.tree;
+		}
+
+		friend bool operator>(const TreeContainer& lhs, const TreeContainer& rhs) {
+			return lhs.tree > rhs.tree;
+		}
+
+		friend bool operator>=(const TreeContainer& lhs, const TreeContainer& rhs) {
+			return lhs.tree >= rhs.tree;
+		}
+
+	protected:
+		Tree tree;
+	};
+
+	}
+
+}
+
+#endif /* TREE_CONTAINER_HPP */
@@ -0,0 +1,131 @@
+#ifndef SET_HPP
+#define SET_HPP
+
+#include "redblack/tree_container.hpp"
+#include <functional>
+#include <memory>
+#include <utility>
+
+namespace DSA {
+
+	namespace Detail {
+
+	template <class Key, class Compare, class Allocator, bool Multi>
+	using SetTree = RedBlackTree<Key, Compare, Allocator, Identity<Key>, Multi>;
+
+	}
+
+/*
+Ordered set over RedBlackTree, elements cannot be modified through its iterators.
+A hint right after the new element's position makes insertion amortised O(1). */
+template <class Key,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<Key>>
+class set : public Detail::TreeContainer<Detail::SetTree<Key, Compare, Allocator, false>,
+	typename Detail::SetTree<Key, Compare, Allocator, false>::const_iterator> {
+private:
+	using Base = Detail::TreeContainer<Detail::SetTree<Key, Compare, Allocator, false>,
+		typename Detail::SetTree<Key, Compare, Allocator, false>::const_iterator>;
+
+public:
+	using value_type		= Key;
+	using value_compare		= Compare;
+	using iterator			= typename Base::iterator;
+	using const_iterator	= typename Base::const_iterator;
+
+	using Base::Base;
+	using Base::insert;
+	using Base::operator=;
+
+	set() = default;
+
+	set(std::initializer_list<value_type> init,
+		const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+	: Base(init, comp, alloc) {}
+
+/* Modifiers */
+	std::pair<iterator, bool> insert(const value_type& value) {
+		return this->tree.insert(value);
+	}
+
+	std::pair<iterator, bool> insert(value_type&& value) {
+		return this->tree.insert(std::move(value));
+	}
+
+	iterator insert(const_iterator hint, const value_type& value) {
+		return this->tree.insert(hint, value);
+	}
+
+	iterator insert(const_iterator hint, value_type&& value) {
+		return this->tree.insert(hint, std::move(value));
+	}
+
+	template <class... Args>
+	std::pair<iterator, bool> emplace(Args&&... args) {
+		return this->tree.emplace(std::forward<Args>(args)...);
+	}
+
+/* Observers */
+	value_compare value_comp() const {
+		return this->key_comp();
+	}
+};
+
+/*
+Ordered set with equal elements, kept in insertion order */
+template <class Key,
+		class Compare = std::less<Key>,
+		class Allocator = std::allocator<Key>>
+class multiset : public Detail::TreeContainer<Detail::SetTree<Key, Compare, Allocator, true>,
+	typename Detail::SetTree<Key, Compare, Allocator, true>::const_iterator> {
+private:
+	using Base = Detail::TreeContainer<Detail::SetTree<Key, Compare, Allocator, true>,
+		typename Detail::SetTree<Key, Compare, Allocator, true>::const_iterator>;
+
+public:
+	using value_type		= Key;
+	using value_compare		= Compare;
+	using iterator			= typename Base::iterator;
+	using const_iterator	= typename Base::const_iterator;
+
+	using Base::Base;
+	using Base::insert;
+	using Base::operator=;
+
+	multiset() = default;
+
+	multiset(std::initializer_list<value_type> init,
+		const Compare& comp = Compare(), const Allocator& alloc = Allocator())
+	: Base(init, comp, alloc) {}
+
+/* Modifiers */
+	iterator insert(const value_type& value) {
+		return this->tree.insert(value);
+	}
+
+	iterator insert(value_type&& value) {
+		return this->tree.insert(std::move(value));
+	}
+
+	iterator insert(const_iterator hint, const value_type& value) {
+		return this->tree.insert(hint, value);
+	}
+
+	iterator insert(const_iterator hint, value_type&& value) {
+		return this->tree.insert(hint, std::move(value));
+	}
+
+	template <class... Args>
+	iterator emplace(Args&&... args) {
+		return this->tree.emplace(std::forward<Args>(args)...);
+	}
+
+/* Observers */
+	value_compare value_comp() const {
+		return this->key_comp();
+	}
+};
+
+}
+
+#endif /* SET_HPP */
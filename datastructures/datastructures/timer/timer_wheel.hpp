@@ -0,0 +1,438 @@
+#ifndef TIMER_WHEEL_HPP
+#define TIMER_WHEEL_HPP
+
+#include "heap/heap.hpp"
+#include "heap/bit_width.hpp"
+#include <array>
+#include <vector>
+#include <limits>
+#include <utility>
+#include <new>
+#include <cstddef>
+#include <cstdint>
+#include <type_traits>
+
+namespace DSA {
+
+/*
+Identifies a scheduled timer. The generation tells a reused slot apart
+from the timer that used it before, so cancelling a timer that already
+fired or was cancelled is detected. */
+struct TimerHandle {
+	std::uint32_t index;
+	std::uint32_t generation;
+};
+
+/*
+Hashed hierarchical timing wheel.
+
+Four wheels of 256 slots cover the next 2^32 ticks: a timer goes into the wheel
+of the highest byte in which its deadline differs from the current tick, in the
+slot of that byte. Timers that differ above bit 32 wait in a DSA::Heap.
+When time reaches a slot of a higher wheel, its timers cascade into lower wheels,
+a timer cascades at most four times.
+
+schedule and cancel are O(1): each slot is an intrusive doubly linked list of
+timers in a slab, free slots are reused. Cancelled timers in the far-future heap
+are dropped lazily. advance jumps over empty slots using a bitmap per wheel,
+so idle time is not walked tick by tick.
+
+Expired timers are handed to the callback in one batch per tick.
+Values are constructed in place when scheduled and destroyed when they expire or are
+cancelled, T only has to be move constructible (and copy constructible to copy the wheel). */
+template <typename T>
+class TimerWheel {
+public:
+	using value_type	= T;
+	using tick_type		= std::uint64_t;
+	using size_type		= std::size_t;
+	using handle		= TimerHandle;
+
+	static constexpr std::size_t levels = 4;
+	static constexpr std::size_t slot_bits = 8;
+	static constexpr std::size_t slots = std::size_t(1) << slot_bits;
+
+private:
+	static constexpr std::uint32_t nil = std::numeric_limits<std::uint32_t>::max();
+	static constexpr std::uint8_t overflow_level = levels;
+	static constexpr std::uint8_t free_level = levels + 1;
+
+	/*
+	A slab entry, its value only lives while the entry is not on the free list */
+	struct Node {
+		tick_type deadline;
+		std::uint32_t prev;
+		std::uint32_t next;
+		std::uint32_t generation;
+		std::uint8_t level;
+		typename std::aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+		Node()
+		: deadline(0), prev(nil), next(nil), generation(0), level(free_level) {}
+
+		Node(const Node& other)
+		: deadline(other.deadline), prev(other.prev), next(other.next),
+		generation(other.generation), level(free_level) {
+			if (other.live()) {
+				::new (static_cast<void*>(&storage)) T(other.value());
+			}
+			level = other.level;
+		}
+
+		Node(Node&& other) noexcept(std::is_nothrow_move_constructible<T>::value)
+		: deadline(other.deadline), prev(other.prev), next(other.next),
+		generation(other.generation), level(free_level) {
+			if (other.live()) {
+				::new (static_cast<void*>(&storage)) T(std::move(other.value()));
+			}
+			level = other.level;
+		}
+
+		Node& operator=(const Node& rhs) {
+			if (this != &rhs) {
+				destroy();
+				::new (static_cast<void*>(this)) Node(rhs);
+			}
+			return *this;
+		}
+
+		Node& operator=(Node&& rhs) noexcept(std::is_nothrow_move_constructible<T>::value) {
+			if (this != &rhs) {
+				destroy();
+				::new (static_cast<void*>(this)) Node(std::move(rhs));
+			}
+			return *this;
+		}
+
+		~Node() {
+			destroy();
+		}
+
+		bool live() const {
+			return level != free_level;
+		}
+
+		T& value() {
+			return *reinterpret_cast<T*>(&storage);
+		}
+
+		const T& value() const {
+			return *reinterpret_cast<const T*>(&storage);
+		}
+
+		void destroy() {
+			if (live()) {
+				value().~T();
+				level = free_level;
+			}
+		}
+	};
+
+	struct OverflowEntry {
+		tick_type deadline;
+		std::uint32_t index;
+		std::uint32_t generation;
+	};
+
+	struct LaterDeadline {
+		bool operator()(const OverflowEntry& a, const OverflowEntry& b) const {
+			return a.deadline > b.deadline;
+		}
+	};
+
+	struct Wheel {
+		std::array<std::uint32_t, slots> heads;
+		std::array<std::uint64_t, slots / 64> occupied;
+	};
+
+public:
+	explicit TimerWheel(tick_type now = 0)
+	: current(now), count(0), free_head(nil) {
+		for (Wheel& wheel : wheels) {
+			wheel.heads.fill(nil);
+			wheel.occupied.fill(0);
+		}
+	}
+
+	tick_type now() const {
+		return current;
+	}
+
+	size_type size() const {
+		return count;
+	}
+
+	bool empty() const {
+		return count == 0;
+	}
+
+	/*
+	Schedules value to expire at deadline, a deadline that is not in the future
+	expires on the next tick. O(1) */
+	handle schedule(tick_type deadline, const T& value) {
+		return emplace(deadline, value);
+	}
+
+	handle schedule(tick_type deadline, T&& value) {
+		return emplace(deadline, std::move(value));
+	}
+
+	template <typename... Args>
+	handle emplace(tick_type deadline, Args&&... args) {
+		const std::uint32_t index = allocate(deadline <= current ? current + 1 : deadline, std::forward<Args>(args)...);
+		place(index);
+		++count;
+		return handle {index, nodes[index].generation};
+	}
+
+	/*
+	False if the timer already expired or was cancelled. O(1) */
+	bool cancel(handle h) {
+		if (!active(h)) {
+			return false;
+		}
+		Node& node = nodes[h.index];
+		if (node.level != overflow_level) {
+			unlink(h.index);
+		}
+		// an overflow entry is skipped when it reaches the top of the heap
+		release(h.index);
+		--count;
+		return true;
+	}
+
+	bool active(handle h) const {
+		return h.index < nodes.size() && nodes[h.index].generation == h.generation
+			&& nodes[h.index].level != free_level;
+	}
+
+	/*
+	Advances the current tick to `to`, calling expire(tick, std::vector<T>& timers)
+	for every tick at which timers expire. The callback may schedule and cancel timers.
+	Returns the number of expired timers. */
+	template <typename Expire>
+	size_type advance(tick_type to, Expire expire) {
+		size_type expired = 0;
+		while (current < to) {
+			const tick_type next = nextEvent();
+			if (next > to) {
+				current = to;
+				break;
+			}
+			current = next;
+			cascade();
+			expired += fire(expire);
+		}
+		return expired;
+	}
+
+	/*
+	The earliest tick at which a timer may expire or cascade, the maximum tick if none */
+	tick_type nextEvent() {
+		tick_type next = std::numeric_limits<tick_type>::max();
+		for (std::size_t level = 0; level < levels; ++level) {
+			const std::size_t shift = level * slot_bits;
+			const std::size_t position = (current >> shift) & (slots - 1);
+			const std::size_t slot = nextOccupied(wheels[level], position + 1);
+			if (slot != slots) {
+				const tick_type base = shift + slot_bits >= 64 ? 0 : (current >> (shift + slot_bits)) << (shift + slot_bits);
+				next = std::min(next, base | (tick_type(slot) << shift));
+			}
+		}
+		dropCancelled();
+		if (!overflow.empty()) {
+			next = std::min(next, (overflow.top().deadline >> (levels * slot_bits)) << (levels * slot_bits));
+		}
+		return next;
+	}
+
+private:
+	template <typename... Args>
+	std::uint32_t allocate(tick_type deadline, Args&&... args) {
+		std::uint32_t index = free_head;
+		if (index == nil) {
+			index = static_cast<std::uint32_t>(nodes.size());
+			nodes.emplace_back();
+			try {
+				::new (static_cast<void*>(&nodes.back().storage)) T(std::forward<Args>(args)...);
+			} catch (...) {
+				nodes.pop_back();
+				throw;
+			}
+		} else {
+			::new (static_cast<void*>(&nodes[index].storage)) T(std::forward<Args>(args)...);
+			free_head = nodes[index].next;
+		}
+		Node& node = nodes[index];
+		// live from here on, place() sets the actual level
+		node.level = 0;
+		node.deadline = deadline;
+		node.prev = nil;
+		node.next = nil;
+		return index;
+	}
+
+	void release(std::uint32_t index) {
+		Node& node = nodes[index];
+		node.destroy();
+		node.generation += 1;
+		node.next = free_head;
+		free_head = index;
+	}
+
+	/*
+	Wheel of the highest differing byte between the deadline and the current tick */
+	void place(std::uint32_t index) {
+		Node& node = nodes[index];
+		const tick_type difference = node.deadline ^ current;
+		std::size_t level = 0;
+		while (level < levels && (difference >> ((level + 1) * slot_bits)) != 0) {
+			++level;
+		}
+		if (level == levels) {
+			node.level = overflow_level;
+			overflow.push(OverflowEntry {node.deadline, index, node.generation});
+			return;
+		}
+		node.level = static_cast<std::uint8_t>(level);
+		Wheel& wheel = wheels[level];
+		const std::size_t slot = (node.deadline >> (level * slot_bits)) & (slots - 1);
+		node.prev = nil;
+		node.next = wheel.heads[slot];
+		if (node.next != nil) {
+			nodes[node.next].prev = index;
+		}
+		wheel.heads[slot] = index;
+		wheel.occupied[slot / 64] |= std::uint64_t(1) << (slot % 64);
+	}
+
+	void unlink(std::uint32_t index) {
+		Node& node = nodes[index];
+		Wheel& wheel = wheels[node.level];
+		const std::size_t slot = (node.deadline >> (node.level * slot_bits)) & (slots - 1);
+		if (node.prev != nil) {
+			nodes[node.prev].next = node.next;
+		} else {
+			wheel.heads[slot] = node.next;
+		}
+		if (node.next != nil) {
+			nodes[node.next].prev = node.prev;
+		}
+		if (wheel.heads[slot] == nil) {
+			wheel.occupied[slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+		}
+	}
+
+	/*
+	Detaches the list of a slot */
+	std::uint32_t takeSlot(Wheel& wheel, std::size_t slot) {
+		const std::uint32_t head = wheel.heads[slot];
+		wheel.heads[slot] = nil;
+		wheel.occupied[slot / 64] &= ~(std::uint64_t(1) << (slot % 64));
+		return head;
+	}
+
+	/*
+	First occupied slot at or after `from`, slots if none */
+	static std::size_t nextOccupied(const Wheel& wheel, std::size_t from) {
+		for (std::size_t word = from / 64; word < slots / 64; ++word) {
+			std::uint64_t bits = wheel.occupied[word];
+			if (word == from / 64) {
+				bits &= ~std::uint64_t(0) << (from % 64);
+			}
+			if (bits != 0) {
+				return word * 64 + HeapDetail::bitWidth(bits & (~bits + 1)) - 1;
+			}
+		}
+		return slots;
+	}
+
+	void dropCancelled() {
+		while (!overflow.empty()) {
+			const OverflowEntry& top = overflow.top();
+			const Node& node = nodes[top.index];
+			if (node.generation == top.generation && node.level == overflow_level) {
+				return;
+			}
+			overflow.pop();
+		}
+	}
+
+	/*
+	The current tick entered new slots of the higher wheels: their timers move
+	down, the far-future heap first */
+	void cascade() {
+		const std::size_t top_shift = levels * slot_bits;
+		if ((current & ((tick_type(1) << top_shift) - 1)) == 0) {
+			dropCancelled();
+			while (!overflow.empty() && (overflow.top().deadline >> top_shift) == (current >> top_shift)) {
+				const std::uint32_t index = overflow.pop_value().index;
+				place(index);
+				dropCancelled();
+			}
+		}
+		for (std::size_t level = levels - 1; level > 0; --level) {
+			const std::size_t shift = level * slot_bits;
+			if ((current & ((tick_type(1) << shift) - 1)) != 0) {
+				continue;
+			}
+			Wheel& wheel = wheels[level];
+			std::uint32_t index = takeSlot(wheel, (current >> shift) & (slots - 1));
+			while (index != nil) {
+				const std::uint32_t next = nodes[index].next;
+				place(index);
+				index = next;
+			}
+		}
+	}
+
+	template <typename Expire>
+	size_type fire(Expire& expire) {
+		std::uint32_t index = takeSlot(wheels[0], current & (slots - 1));
+		if (index == nil) {
+			return 0;
+		}
+		batch.clear();
+		while (index != nil) {
+			const std::uint32_t next = nodes[index].next;
+			batch.push_back(std::move(nodes[index].value()));
+			release(index);
+			--count;
+			index = next;
+		}
+		const size_type expired = batch.size();
+		expire(current, batch);
+		return expired;
+	}
+
+private:
+	tick_type current;
+	size_type count;
+	std::array<Wheel, levels> wheels;
+	std::vector<Node> nodes;
+	std::uint32_t free_head;
+	Heap<OverflowEntry, std::vector<OverflowEntry>, LaterDeadline> overflow;
+	std::vector<T> batch;
+};
+
+template <typename T>
+constexpr std::size_t TimerWheel<T>::levels;
+
+template <typename T>
+constexpr std::size_t TimerWheel<T>::slot_bits;
+
+template <typename T>
+constexpr std::size_t TimerWheel<T>::slots;
+
+template <typename T>
+constexpr std::uint32_t TimerWheel<T>::nil;
+
+template <typename T>
+constexpr std::uint8_t TimerWheel<T>::overflow_level;
+
+template <typename T>
+constexpr std::uint8_t TimerWheel<T>::free_level;
+
+}
+
+#endif /* TIMER_WHEEL_HPP */
@@ -4,6 +4,9 @@ then
 elif [ "$1" = "test" ]
 then
 	cmake --build build && ./build/test/test.out
+elif [ "$1" = "benchmark" ]
+then
+	cmake --build build && ./build/benchmark/a.out
 elif [ "$1" = "build" ]
 then
 	cmake -S . -B build
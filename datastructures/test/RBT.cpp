@@ -1,5 +1,10 @@
 #include "redblack/redblack.hpp"
 #include "valid_rb_test.hpp"
+#include <string>
+#include <vector>
+#include <sstream>
+#include <iterator>
+#include <cstddef>
 #include <catch2/catch.hpp>
 
 /* Constructors */
@@ -76,6 +81,54 @@ TEST_CASE("RedBlackTree copy constructor", "[RedBlackTree]") {
 	REQUIRE(Test::validRB(s2));
 }
 
+TEST_CASE("RedBlackTree sorted range constructor", "[RedBlackTree]") {
+	std::vector<int> v;
+	for (int n = 0; n < 300; ++n) {
+		RedBlackTree<int> s(v.begin(), v.end());
+		REQUIRE(s.size() == v.size());
+		REQUIRE(std::equal(v.begin(), v.end(), s.begin()));
+		REQUIRE(Test::validRB(s));
+		if (n > 0) {
+			REQUIRE(*s.begin() == 0);
+			REQUIRE(*--s.end() == v.back());
+		}
+		s.insert(-1);
+		s.erase(v.size() / 2);
+		REQUIRE(Test::validRB(s));
+		v.push_back(n * 3);
+	}
+}
+
+TEST_CASE("RedBlackTree assign_sorted fallback", "[RedBlackTree]") {
+	const int table[] = {1, 3, 5, 5, 4, 9, 0, 2};
+	RedBlackTree<int> s;
+	s.insert(100);
+	s.assign_sorted(table, table + 8);
+	const int expected[] = {0, 1, 2, 3, 4, 5, 9};
+	REQUIRE(s.size() == 7);
+	REQUIRE(std::equal(expected, expected + 7, s.begin()));
+	REQUIRE(Test::validRB(s));
+	REQUIRE(*--s.end() == 9);
+
+	std::istringstream in("2 4 6 8 7");
+	s.assign_sorted(std::istream_iterator<int>(in), std::istream_iterator<int>());
+	const int streamed[] = {2, 4, 6, 7, 8};
+	REQUIRE(s.size() == 5);
+	REQUIRE(std::equal(streamed, streamed + 5, s.begin()));
+	REQUIRE(Test::validRB(s));
+	s.assign_sorted(table, table);
+	REQUIRE(s.empty());
+	REQUIRE(s.begin() == s.end());
+
+	std::vector<std::string> words {"a", "b", "c", "d", "e"};
+	const RedBlackTree<std::string> w(words.begin(), words.end());
+	REQUIRE(std::equal(words.begin(), words.end(), w.begin()));
+	RedBlackTree<std::string> copy(w);
+	REQUIRE(*copy.begin() == "a");
+	REQUIRE(&*copy.begin() != &*w.begin());
+	REQUIRE(&*--copy.end() != &*--w.end());
+}
+
 // /* Assignment */
 
 TEST_CASE("RedBlackTree copy assignment", "[RedBlackTree]") {
@@ -356,6 +409,21 @@ TEST_CASE("Red-Black erase case 4", "[red-black]") {
 }
 
 
+TEST_CASE("RedBlackTree random erase", "[RedBlackTree]") {
+	RedBlackTree<int> m;
+	std::vector<int> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(i * 7919 % 1000);
+		m.insert(v.back());
+	}
+	for (int i = 0; i < 1000; i += 3) {
+		m.erase(v[i]);
+		REQUIRE(m.find(v[i]) == m.end());
+	}
+	REQUIRE(m.size() == 666);
+	REQUIRE(Test::validRB(m));
+}
+
 TEST_CASE("RedBlackTree swap", "[RedBlackTree]") {
 	RedBlackTree<int> s;
 	RedBlackTree<int> s2;
@@ -581,3 +649,190 @@ TEST_CASE("RedBlackTree const type", "[RedBlackTree]") {
 	s.begin();
 	s.end();
 }
+
+/* Keys */
+
+TEST_CASE("RedBlackTree equal keys", "[RedBlackTree]") {
+	typedef RedBlackTree<int, std::less<int>, std::allocator<int>, DSA::Identity<int>, true> Tree;
+	std::vector<int> sorted {1, 1, 2, 2, 2, 3, 5, 5};
+	Tree s(sorted.begin(), sorted.end());
+	REQUIRE(Test::validRB(s));
+	REQUIRE(std::equal(sorted.begin(), sorted.end(), s.begin()));
+	for (int i = 0; i < 500; ++i) {
+		s.insert(i * 7919 % 50);
+		s.insert(s.begin(), i % 7);
+	}
+	REQUIRE(Test::validRB(s));
+	REQUIRE(s.count(2) == 3 + 10 + 72);
+	REQUIRE(s.erase(2) == 85);
+	REQUIRE(s.find(2) == s.end());
+	REQUIRE(Test::validRB(s));
+	REQUIRE(std::is_sorted(s.begin(), s.end()));
+}
+
+TEST_CASE("RedBlackTree hints", "[RedBlackTree]") {
+	RedBlackTree<int> s;
+	std::vector<RedBlackTree<int>::iterator> hints;
+	for (int i = 0; i < 1000; ++i) {
+		int v = i * 7919 % 1000;
+		RedBlackTree<int>::const_iterator hint = hints.empty() ? s.end() : hints[v % hints.size()];
+		hints.push_back(s.insert(hint, v));
+		REQUIRE(*hints.back() == v);
+		REQUIRE(s.insert(hint, v) == hints.back());
+	}
+	REQUIRE(s.size() == 1000);
+	REQUIRE(Test::validRB(s));
+	REQUIRE(std::is_sorted(s.begin(), s.end()));
+}
+
+/* Node layout */
+
+TEST_CASE("RedBlackNode colour bit", "[RedBlackTree]") {
+	typedef RedBlackNode<long> Node;
+	REQUIRE(sizeof(Node) == 4 * sizeof(void*));
+	Node parent(1);
+	Node x(2, &parent);
+	REQUIRE(x.getParent() == &parent);
+	REQUIRE(x.isRed());
+	x.turnBlack();
+	REQUIRE(x.isBlack());
+	REQUIRE(x.getParent() == &parent);
+	x.setParent(NULL);
+	REQUIRE(x.isBlack());
+	REQUIRE(x.getParent() == NULL);
+	x.assignColor(Node::RED);
+	REQUIRE(x.getColor() == Node::RED);
+	Node y(x);
+	y.setParent(&x);
+	x.turnBlack();
+	x.swapLinks(y);
+	REQUIRE(x.getParent() == &x);
+	REQUIRE(x.isRed());
+	REQUIRE(y.getParent() == NULL);
+	REQUIRE(y.isBlack());
+	REQUIRE(x.getValue() == 2);
+}
+
+/* Node allocation */
+
+namespace {
+
+/*
+Caller-owned arena: a bump pointer over a fixed buffer, deallocation only counts */
+struct BufferArena {
+	explicit BufferArena(std::size_t bytes)
+	: buffer(bytes), used(0), live(0) {}
+
+	void* allocate(std::size_t bytes) {
+		used = (used + alignof(std::max_align_t) - 1) & ~(alignof(std::max_align_t) - 1);
+		if (used + bytes > buffer.size()) {
+			throw std::bad_alloc();
+		}
+		void* p = buffer.data() + used;
+		used += bytes;
+		live += 1;
+		return p;
+	}
+
+	void deallocate(void* p) {
+		REQUIRE(static_cast<char*>(p) >= buffer.data());
+		REQUIRE(static_cast<char*>(p) < buffer.data() + buffer.size());
+		live -= 1;
+	}
+
+	std::vector<char> buffer;
+	std::size_t used;
+	std::size_t live;
+};
+
+template <typename T>
+struct BufferAllocator {
+	typedef T value_type;
+
+	template <typename U>
+	struct rebind {
+		typedef BufferAllocator<U> other;
+	};
+
+	BufferAllocator(BufferArena& arena)
+	: arena(&arena) {}
+
+	template <typename U>
+	BufferAllocator(const BufferAllocator<U>& other)
+	: arena(other.arena) {}
+
+	T* allocate(std::size_t n) {
+		return static_cast<T*>(arena->allocate(n * sizeof(T)));
+	}
+
+	void deallocate(T* p, std::size_t) {
+		arena->deallocate(p);
+	}
+
+	bool operator==(const BufferAllocator& rhs) const {
+		return arena == rhs.arena;
+	}
+
+	bool operator!=(const BufferAllocator& rhs) const {
+		return arena != rhs.arena;
+	}
+
+	BufferArena* arena;
+};
+
+}
+
+TEST_CASE("RedBlackTree arena chunks", "[RedBlackTree]") {
+	typedef RedBlackTree<int, std::less<int>, BufferAllocator<int> > Tree;
+	BufferArena arena(1 << 20);
+	{
+		Tree s {std::less<int>(), BufferAllocator<int>(arena)};
+		REQUIRE(arena.live == 1);
+		for (int i = 0; i < 1000; ++i) {
+			s.insert(i * 7 % 1000);
+		}
+		REQUIRE(s.size() == 1000);
+		REQUIRE(Test::validRB(s));
+		// 64 + 128 + 256 + 512 + 1024 nodes, and the end node
+		REQUIRE(arena.live == 6);
+		std::size_t used = arena.used;
+		for (int i = 0; i < 1000; i += 2) {
+			s.erase(i);
+		}
+		for (int i = 0; i < 1000; i += 2) {
+			s.insert(i);
+		}
+		REQUIRE(arena.used == used);
+		Tree::iterator ite = s.end();
+		s.clear();
+		REQUIRE(arena.live == 1);
+		REQUIRE(s.begin() == s.end());
+		s.insert(42);
+		--ite;
+		REQUIRE(*ite == 42);
+
+		Tree copy(s);
+		REQUIRE(copy == s);
+		REQUIRE(copy.get_allocator() == s.get_allocator());
+	}
+	REQUIRE(arena.live == 0);
+}
+
+TEST_CASE("RedBlackTree clear with destructors", "[RedBlackTree]") {
+	RedBlackTree<std::string> s;
+	RedBlackTree<std::string> s2;
+	for (int i = 0; i < 500; ++i) {
+		s.insert(std::string(40, 'a') + std::to_string(i));
+	}
+	s2.insert("b");
+	s.swap(s2);
+	REQUIRE(s.size() == 1);
+	REQUIRE(s2.size() == 500);
+	s2.erase(std::string(40, 'a') + "7");
+	REQUIRE(Test::validRB(s2));
+	s2.clear();
+	REQUIRE(s2.empty());
+	s2.insert("c");
+	REQUIRE(*s2.begin() == "c");
+	REQUIRE(*s.begin() == "b");
+}
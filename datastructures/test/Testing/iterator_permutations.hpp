@@ -1,6 +1,7 @@
 #pragma once
 
 #include "permutations.hpp"
+#include <array>
 #include <iostream> //REMOVE
 #include <cassert> // REMOVE
 
@@ -2,10 +2,11 @@
 #include <limits>
 #include <catch2/catch.hpp>
 #include "algorithm"
+#include <string>
 
 template <typename HeapType>
 static bool validHeap(const HeapType& h) {
-	return std::is_heap(h.begin(), h.end(), h.value_comp());
+	return DSA::is_heap<HeapType::arity>(h.begin(), h.end(), h.value_comp());
 }
 
 template <typename Compare = std::less<int>>
@@ -53,3 +54,219 @@ TEST_CASE("heap unit", "[heap]") {
 		testMinHeap(50);
 	}
 }
+
+
+template <std::size_t Arity>
+static void testArity(std::size_t n) {
+	DSA::Heap<int, std::vector<int>, std::greater<int>, Arity> h;
+	for (std::size_t i = 0; i < n; ++i) {
+		h.push(rand() % 1000);
+		REQUIRE(validHeap(h));
+	}
+	int prev = std::numeric_limits<int>::min();
+	while (!h.empty()) {
+		int x = h.top();
+		REQUIRE(x >= prev);
+		prev = x;
+		h.pop();
+		REQUIRE(validHeap(h));
+	}
+}
+
+TEST_CASE("heap arity", "[heap]") {
+	for (std::size_t n : {0, 1, 2, 3, 5, 9, 17, 100}) {
+		testArity<2>(n);
+		testArity<3>(n);
+		testArity<4>(n);
+		testArity<8>(n);
+	}
+	STATIC_REQUIRE(DSA::cacheLineArity<char>() == 16);
+	STATIC_REQUIRE(DSA::cacheLineArity<int>() == 16);
+	STATIC_REQUIRE(DSA::cacheLineArity<double>() == 8);
+	STATIC_REQUIRE(DSA::HeapDetail::firstChildIndex<4>(1) == 5);
+	STATIC_REQUIRE(DSA::HeapDetail::parentIndex<4>(8) == 1);
+}
+
+TEST_CASE("heap make_heap", "[heap]") {
+	// the last element used to be left out of make_heap
+	std::vector<int> small {1, 2};
+	DSA::make_heap(small.begin(), small.end());
+	REQUIRE(small.front() == 2);
+	for (std::size_t n = 0; n < 100; ++n) {
+		std::vector<int> v;
+		for (std::size_t i = 0; i < n; ++i) {
+			v.push_back(rand() % 100);
+		}
+		std::vector<int> sorted {v};
+		std::sort(sorted.begin(), sorted.end());
+		DSA::make_heap<4>(v.begin(), v.end());
+		REQUIRE(DSA::is_heap<4>(v.begin(), v.end()));
+		for (std::size_t size = v.size(); size > 0; --size) {
+			DSA::pop_heap<4>(v.begin(), v.begin() + size);
+		}
+		REQUIRE(v == sorted);
+		DSA::Heap<int, std::vector<int>, std::less<int>, 8> h {sorted.begin(), sorted.end()};
+		REQUIRE(validHeap(h));
+	}
+}
+
+namespace {
+
+struct Counted {
+	Counted(int v = 0)
+	: value(v) {}
+
+	Counted(const Counted& other)
+	: value(other.value) {
+		++copies;
+	}
+
+	Counted(Counted&& other) noexcept
+	: value(other.value) {
+		++moves;
+	}
+
+	Counted& operator=(const Counted& other) {
+		value = other.value;
+		++copies;
+		return *this;
+	}
+
+	Counted& operator=(Counted&& other) noexcept {
+		value = other.value;
+		++moves;
+		return *this;
+	}
+
+	bool operator<(const Counted& rhs) const {
+		return value < rhs.value;
+	}
+
+	int value;
+	static std::size_t copies;
+	static std::size_t moves;
+};
+
+std::size_t Counted::copies = 0;
+std::size_t Counted::moves = 0;
+
+}
+
+TEST_CASE("heap moves", "[heap]") {
+	constexpr int N = 1024;
+	DSA::Heap<Counted> h;
+	for (int i = 0; i < N; ++i) {
+		h.push(Counted(rand() % 1000));
+	}
+	REQUIRE(validHeap(h));
+	Counted::copies = 0;
+	Counted::moves = 0;
+	int prev = std::numeric_limits<int>::max();
+	while (!h.empty()) {
+		Counted x = h.pop_value();
+		REQUIRE(x.value <= prev);
+		prev = x.value;
+		REQUIRE(validHeap(h));
+	}
+	REQUIRE(Counted::copies == 0);
+	// one move per level (height 10) and a constant per pop, not three per level
+	REQUIRE(Counted::moves <= N * 14);
+}
+
+TEST_CASE("heap replace_top pushpop", "[heap]") {
+	DSA::Heap<std::string> h;
+	REQUIRE(h.pushpop("a") == "a");
+	REQUIRE(h.empty());
+	for (const char* s : {"d", "b", "f", "a"}) {
+		h.push(s);
+	}
+	REQUIRE(h.pushpop("z") == "z");
+	REQUIRE(h.pushpop("c") == "f");
+	REQUIRE(validHeap(h));
+	REQUIRE(h.replace_top("e") == "d");
+	REQUIRE(h.size() == 4);
+	REQUIRE(validHeap(h));
+	std::vector<std::string> out;
+	while (!h.empty()) {
+		out.push_back(h.pop_value());
+	}
+	REQUIRE(out == std::vector<std::string> {"e", "c", "b", "a"});
+	for (std::size_t n = 1; n < 50; ++n) {
+		DSA::Heap<int, std::vector<int>, std::greater<int>, 4> g;
+		std::vector<int> all;
+		for (std::size_t i = 0; i < n; ++i) {
+			int x = rand() % 100;
+			g.push(x);
+			all.push_back(x);
+		}
+		for (std::size_t i = 0; i < n; ++i) {
+			int x = rand() % 100;
+			all.push_back(x);
+			int top = g.pushpop(x);
+			std::sort(all.begin(), all.end());
+			REQUIRE(top == all.front());
+			all.erase(all.begin());
+			REQUIRE(validHeap(g));
+		}
+	}
+}
+
+TEST_CASE("heap push_range", "[heap]") {
+	for (std::size_t n : {0, 1, 5, 100, 1000}) {
+		for (std::size_t k : {0, 1, 3, 9, 50, 500, 2000}) {
+			DSA::Heap<int> h {randomHeap(n)};
+			DSA::Heap<int, std::vector<int>, std::greater<int>, 4> g;
+			std::vector<int> v;
+			for (std::size_t i = 0; i < n; ++i) {
+				g.push(rand() % 1000);
+			}
+			for (std::size_t i = 0; i < k; ++i) {
+				v.push_back(rand() % 1000);
+			}
+			h.push_range(v.begin(), v.end());
+			g.push_range(v.begin(), v.end());
+			REQUIRE(h.size() == n + k);
+			REQUIRE(g.size() == n + k);
+			REQUIRE(validHeap(h));
+			REQUIRE(validHeap(g));
+		}
+	}
+}
+
+TEST_CASE("heap push_heap_range", "[heap]") {
+	// every split of every size: the batched tail sift runs for the middle cases
+	for (std::size_t size = 0; size < 200; ++size) {
+		for (std::size_t middle = 0; middle <= size; ++middle) {
+			std::vector<int> v;
+			for (std::size_t i = 0; i < size; ++i) {
+				v.push_back(rand() % 100);
+			}
+			DSA::make_heap<3>(v.begin(), v.begin() + middle);
+			DSA::push_heap_range<3>(v.begin(), v.begin() + middle, v.end());
+			REQUIRE(DSA::is_heap<3>(v.begin(), v.end()));
+		}
+	}
+}
+
+TEST_CASE("heap merge", "[heap]") {
+	DSA::Heap<std::string> a;
+	DSA::Heap<std::string> b;
+	for (const char* s : {"b", "d"}) {
+		a.push(s);
+	}
+	for (const char* s : {"a", "c", "e"}) {
+		b.push(s);
+	}
+	a.merge(std::move(b));
+	REQUIRE(b.empty());
+	REQUIRE(a.size() == 5);
+	std::string expected = "edcba";
+	for (char x : expected) {
+		REQUIRE(a.pop_value() == std::string(1, x));
+	}
+	DSA::Heap<int> big {randomHeap(1000)};
+	DSA::Heap<int> small {randomHeap(10)};
+	small.merge(std::move(big));
+	REQUIRE(small.size() == 1010);
+	REQUIRE(validHeap(small));
+}
@@ -0,0 +1,158 @@
+#include "heap/indexed_heap.hpp"
+#include <map>
+#include <queue>
+#include <vector>
+#include <limits>
+#include <string>
+#include <catch2/catch.hpp>
+
+template <typename HeapType>
+static bool validIndexedHeap(const HeapType& h, const std::map<std::size_t, int>& reference) {
+	if (h.size() != reference.size()) {
+		return false;
+	}
+	for (const auto& p : reference) {
+		if (!h.contains(p.first) || h.key(p.first) != p.second) {
+			return false;
+		}
+	}
+	return true;
+}
+
+template <std::size_t Arity>
+static void testRandomOperations(std::size_t ids, std::size_t operations) {
+	DSA::IndexedHeap<int, std::less<int>, Arity> h;
+	std::map<std::size_t, int> reference;
+	for (std::size_t i = 0; i < operations; ++i) {
+		std::size_t id = rand() % ids;
+		int key = rand() % 1000;
+		if (!h.contains(id)) {
+			h.push(id, key);
+			reference[id] = key;
+		} else {
+			switch (rand() % 5) {
+				case 0:
+					h.erase(id);
+					reference.erase(id);
+					break;
+				case 1:
+					if (key >= h.key(id)) {
+						h.increaseKey(id, key);
+						reference[id] = key;
+					}
+					break;
+				case 2:
+					if (key <= h.key(id)) {
+						h.decreaseKey(id, key);
+						reference[id] = key;
+					}
+					break;
+				case 3:
+					h.update(id, key);
+					reference[id] = key;
+					break;
+				default: {
+					int greatest = std::numeric_limits<int>::min();
+					for (const auto& p : reference) {
+						greatest = std::max(greatest, p.second);
+					}
+					REQUIRE(h.top() == greatest);
+					REQUIRE(reference[h.topId()] == greatest);
+					reference.erase(h.topId());
+					h.pop();
+				}
+			}
+		}
+		REQUIRE(validIndexedHeap(h, reference));
+	}
+	int prev = std::numeric_limits<int>::max();
+	while (!h.empty()) {
+		REQUIRE(h.top() <= prev);
+		prev = h.top();
+		h.pop();
+	}
+	for (std::size_t id = 0; id < ids; ++id) {
+		REQUIRE(!h.contains(id));
+	}
+}
+
+TEST_CASE("indexed heap operations", "[indexed_heap]") {
+	testRandomOperations<2>(50, 2000);
+	testRandomOperations<4>(50, 2000);
+	testRandomOperations<8>(200, 2000);
+}
+
+TEST_CASE("indexed heap dijkstra", "[indexed_heap]") {
+	constexpr std::size_t N = 300;
+	using Edge = std::pair<std::size_t, int>;
+	std::vector<std::vector<Edge>> graph(N);
+	for (std::size_t i = 0; i < N * 8; ++i) {
+		graph[rand() % N].push_back(Edge(rand() % N, rand() % 100));
+	}
+	constexpr int INF = std::numeric_limits<int>::max();
+
+	// lazy deletion: stale entries are skipped
+	std::vector<int> expected(N, INF);
+	std::priority_queue<Edge, std::vector<Edge>, std::greater<Edge>> lazy;
+	expected[0] = 0;
+	lazy.push(Edge(0, 0));
+	while (!lazy.empty()) {
+		Edge e = lazy.top();
+		lazy.pop();
+		if (e.first > static_cast<std::size_t>(expected[e.second])) {
+			continue;
+		}
+		for (const Edge& next : graph[e.second]) {
+			int d = static_cast<int>(e.first) + next.second;
+			if (d < expected[next.first]) {
+				expected[next.first] = d;
+				lazy.push(Edge(d, next.first));
+			}
+		}
+	}
+
+	std::vector<int> distance(N, INF);
+	DSA::IndexedHeap<int, std::greater<int>, 4> h;
+	h.reserve(N);
+	distance[0] = 0;
+	h.push(0, 0);
+	std::size_t largest = 0;
+	while (!h.empty()) {
+		largest = std::max<std::size_t>(largest, h.size());
+		std::size_t u = h.topId();
+		h.pop();
+		for (const Edge& next : graph[u]) {
+			int d = distance[u] + next.second;
+			if (d < distance[next.first]) {
+				distance[next.first] = d;
+				if (h.contains(next.first)) {
+					h.increaseKey(next.first, d);
+				} else {
+					h.push(next.first, d);
+				}
+			}
+		}
+	}
+	REQUIRE(distance == expected);
+	REQUIRE(largest <= N);
+}
+
+TEST_CASE("indexed heap clear", "[indexed_heap]") {
+	DSA::IndexedHeap<std::string> h;
+	h.push(3, "c");
+	h.emplace(10, 2, 'z');
+	h.pushOrUpdate(3, "a");
+	REQUIRE(h.top() == "zz");
+	REQUIRE(h.topId() == 10);
+	REQUIRE(h.key(3) == "a");
+	DSA::IndexedHeap<std::string> other;
+	std::swap(h, other);
+	REQUIRE(h.empty());
+	REQUIRE(other.size() == 2);
+	other.clear();
+	REQUIRE(other.empty());
+	REQUIRE(!other.contains(3));
+	REQUIRE(!other.contains(10));
+	other.push(3, "b");
+	REQUIRE(other.top() == "b");
+}
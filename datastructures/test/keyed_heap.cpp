@@ -0,0 +1,71 @@
+#include "heap/keyed_heap.hpp"
+#include <map>
+#include <string>
+#include <vector>
+#include <cstdint>
+#include <catch2/catch.hpp>
+
+TEST_CASE("keyed heap order", "[keyed_heap]") {
+	DSA::KeyedHeap<std::uint64_t, std::string, std::greater<std::uint64_t>> h;
+	std::multimap<std::uint64_t, std::string> reference;
+	for (int round = 0; round < 3; ++round) {
+		for (int i = 0; i < 2000; ++i) {
+			if (reference.empty() || rand() % 3 != 0) {
+				std::uint64_t key = rand() % 500;
+				std::string payload = std::to_string(key) + std::string(40, 'p');
+				h.push(key, payload);
+				reference.emplace(key, payload);
+			} else {
+				REQUIRE(h.top_key() == reference.begin()->first);
+				REQUIRE(h.top() == std::to_string(h.top_key()) + std::string(40, 'p'));
+				std::string payload = h.pop_value();
+				REQUIRE(payload == reference.begin()->second);
+				reference.erase(reference.begin());
+			}
+			REQUIRE(h.size() == reference.size());
+		}
+		while (!h.empty()) {
+			REQUIRE(h.top_key() == reference.begin()->first);
+			h.pop();
+			reference.erase(reference.begin());
+		}
+	}
+}
+
+TEST_CASE("keyed heap payload slots", "[keyed_heap]") {
+	struct Job {
+		std::uint64_t id;
+		char data[248];
+	};
+	DSA::KeyedHeap<std::uint32_t, Job> h;
+	h.reserve(100);
+	for (std::uint32_t i = 0; i < 100; ++i) {
+		Job job;
+		job.id = i;
+		h.push(i % 10, job);
+	}
+	std::vector<bool> seen(100, false);
+	std::uint32_t prev = 10;
+	while (!h.empty()) {
+		REQUIRE(h.top_key() <= prev);
+		REQUIRE(h.top().id % 10 == h.top_key());
+		prev = h.top_key();
+		h.top().data[0] = 'x';
+		const Job* slot = &h.top();
+		Job job = h.pop_value();
+		REQUIRE(!seen[job.id]);
+		seen[job.id] = true;
+		// freed slots are reused while the heap is not empty: the new payload lands in the slot
+		// just freed, so the side array neither grows nor moves
+		if (h.size() == 50) {
+			h.emplace(10, Job {1000, {}});
+			REQUIRE(&h.top() == slot);
+			REQUIRE(h.pop_value().id == 1000);
+		}
+	}
+	DSA::KeyedHeap<std::uint32_t, Job> other;
+	other.push(1, Job {7, {}});
+	std::swap(h, other);
+	REQUIRE(h.top().id == 7);
+	REQUIRE(other.empty());
+}
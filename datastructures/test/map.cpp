@@ -0,0 +1,221 @@
+#include "map/map.hpp"
+#include <string>
+#include <vector>
+#include <map>
+#include <iterator>
+#include <cstddef>
+#include <stdexcept>
+#include <catch2/catch.hpp>
+
+namespace {
+
+struct Tracked {
+	Tracked(int v = 0)
+	: value(v) {
+		++constructed;
+	}
+
+	Tracked(const Tracked& other)
+	: value(other.value) {
+		++copies;
+	}
+
+	Tracked(Tracked&& other) noexcept
+	: value(other.value) {
+		++moves;
+	}
+
+	Tracked& operator=(const Tracked& other) {
+		value = other.value;
+		++copies;
+		return *this;
+	}
+
+	Tracked& operator=(Tracked&& other) noexcept {
+		value = other.value;
+		++moves;
+		return *this;
+	}
+
+	static void reset() {
+		constructed = 0;
+		copies = 0;
+		moves = 0;
+	}
+
+	int value;
+	static std::size_t constructed;
+	static std::size_t copies;
+	static std::size_t moves;
+};
+
+std::size_t Tracked::constructed = 0;
+std::size_t Tracked::copies = 0;
+std::size_t Tracked::moves = 0;
+
+struct CountingLess {
+	explicit CountingLess(std::size_t* count = nullptr)
+	: count(count) {}
+
+	bool operator()(int a, int b) const {
+		++*count;
+		return a < b;
+	}
+
+	std::size_t* count;
+};
+
+}
+
+TEST_CASE("map insert find", "[map]") {
+	DSA::map<int, std::string> m;
+	std::map<int, std::string> expected;
+	for (int i = 0; i < 1000; ++i) {
+		int key = (i * 7919) % 500;
+		std::pair<DSA::map<int, std::string>::iterator, bool> r = m.insert(std::make_pair(key, std::to_string(i)));
+		REQUIRE(r.second == expected.insert(std::make_pair(key, std::to_string(i))).second);
+		REQUIRE(r.first->first == key);
+	}
+	REQUIRE(m.size() == expected.size());
+	REQUIRE(std::equal(m.begin(), m.end(), expected.begin()));
+	REQUIRE(m.at(42) == expected.at(42));
+	REQUIRE_THROWS_AS(m.at(1000), std::out_of_range);
+	REQUIRE(m.count(7) == 1);
+	REQUIRE(m.count(700) == 0);
+	REQUIRE(m.lower_bound(-1) == m.begin());
+	REQUIRE(m.upper_bound(499) == m.end());
+	m[1000] = "new";
+	REQUIRE(m.find(1000)->second == "new");
+	REQUIRE(m.erase(1000) == 1);
+	REQUIRE(m.erase(1000) == 0);
+	for (DSA::map<int, std::string>::iterator it = m.begin(); it != m.end();) {
+		it = it->first % 2 ? m.erase(it) : std::next(it);
+	}
+	REQUIRE(m.size() == 250);
+	REQUIRE(m.begin()->first == 0);
+	REQUIRE((--m.end())->first == 498);
+}
+
+TEST_CASE("map try_emplace insert_or_assign", "[map]") {
+	DSA::map<std::string, Tracked> m;
+	Tracked::reset();
+	std::string key = "key";
+	REQUIRE(m.try_emplace(std::move(key), 1).second);
+	REQUIRE(key.empty());
+	REQUIRE(Tracked::constructed == 1);
+	REQUIRE(Tracked::copies == 0);
+	REQUIRE(Tracked::moves == 0);
+
+	// the key is present: nothing is constructed, the key is not moved from
+	key = "key";
+	std::pair<DSA::map<std::string, Tracked>::iterator, bool> r = m.try_emplace(std::move(key), 2);
+	REQUIRE(!r.second);
+	REQUIRE(r.first->second.value == 1);
+	REQUIRE(key == "key");
+	REQUIRE(Tracked::constructed == 1);
+
+	Tracked t(3);
+	Tracked::reset();
+	r = m.insert_or_assign("key", std::move(t));
+	REQUIRE(!r.second);
+	REQUIRE(r.first->second.value == 3);
+	REQUIRE(Tracked::moves == 1);
+	REQUIRE(Tracked::copies == 0);
+	r = m.insert_or_assign("other", t);
+	REQUIRE(r.second);
+	REQUIRE(Tracked::copies == 1);
+	REQUIRE(m.size() == 2);
+
+	DSA::map<std::string, Tracked>::iterator it = m.try_emplace(m.end(), "z", 26);
+	REQUIRE(it->second.value == 26);
+	it = m.insert_or_assign(m.begin(), "a", Tracked(1));
+	REQUIRE(it == m.begin());
+	REQUIRE(m.size() == 4);
+	Tracked::reset();
+	REQUIRE(m["a"].value == 1);
+	REQUIRE(m["b"].value == 0);
+	REQUIRE(Tracked::constructed == 1);
+	REQUIRE(Tracked::copies + Tracked::moves == 0);
+}
+
+TEST_CASE("map hinted insertion", "[map]") {
+	const int n = 10000;
+	std::size_t comparisons = 0;
+	DSA::map<int, int, CountingLess> m {CountingLess(&comparisons)};
+	for (int i = 0; i < n; ++i) {
+		m.emplace_hint(m.end(), i, i);
+	}
+	// one or two comparisons against the maximum, not a descent from the root
+	REQUIRE(comparisons <= 2 * n);
+	comparisons = 0;
+	DSA::map<int, int, CountingLess>::iterator hint = m.end();
+	for (int i = -1; i >= -n; --i) {
+		hint = m.insert(hint, std::make_pair(i, i));
+	}
+	REQUIRE(comparisons <= 3 * n);
+	REQUIRE(m.size() == 2 * n);
+	int expected = -n;
+	for (DSA::map<int, int, CountingLess>::const_iterator it = m.cbegin(); it != m.cend(); ++it) {
+		REQUIRE(it->first == expected++);
+	}
+	// a wrong hint still inserts in the right place
+	REQUIRE(m.insert(m.begin(), std::make_pair(n * 2, 0))->first == n * 2);
+	REQUIRE((--m.end())->first == n * 2);
+	REQUIRE(m.insert(m.end(), std::make_pair(0, 5))->second == 0);
+}
+
+TEST_CASE("map construction", "[map]") {
+	std::vector<std::pair<int, int>> sorted;
+	for (int i = 0; i < 100; ++i) {
+		sorted.push_back(std::make_pair(i, i * i));
+	}
+	DSA::map<int, int> m(sorted.begin(), sorted.end());
+	REQUIRE(m.size() == 100);
+	REQUIRE(m.at(9) == 81);
+	DSA::map<int, int> unsorted {{3, 0}, {1, 0}, {2, 0}, {1, 1}};
+	REQUIRE(unsorted.size() == 3);
+	REQUIRE(unsorted.begin()->first == 1);
+	REQUIRE(unsorted.begin()->second == 0);
+
+	DSA::map<int, int> copy {m};
+	REQUIRE(copy == m);
+	DSA::map<int, int> moved {std::move(copy)};
+	REQUIRE(moved == m);
+	REQUIRE(copy.empty());
+	copy = unsorted;
+	REQUIRE(copy == unsorted);
+	REQUIRE(copy != m);
+	swap(copy, moved);
+	REQUIRE(copy == m);
+	REQUIRE(moved == unsorted);
+	m = {{5, 5}};
+	REQUIRE(m.size() == 1);
+	REQUIRE(m.value_comp()(*unsorted.begin(), *m.begin()));
+}
+
+TEST_CASE("multimap", "[map]") {
+	DSA::multimap<int, int> m;
+	for (int i = 0; i < 30; ++i) {
+		m.insert(std::make_pair(i % 3, i));
+	}
+	REQUIRE(m.size() == 30);
+	REQUIRE(m.count(1) == 10);
+	// equal keys keep their insertion order
+	int expected = 1;
+	std::pair<DSA::multimap<int, int>::iterator, DSA::multimap<int, int>::iterator> range = m.equal_range(1);
+	for (DSA::multimap<int, int>::iterator it = range.first; it != range.second; ++it) {
+		REQUIRE(it->second == expected);
+		expected += 3;
+	}
+	REQUIRE(m.find(2)->second == 2);
+	m.emplace(1, 100);
+	m.emplace_hint(m.end(), 2, 101);
+	REQUIRE((--m.end())->second == 101);
+	REQUIRE((--m.upper_bound(1))->second == 100);
+	REQUIRE(m.erase(1) == 11);
+	REQUIRE(m.count(1) == 0);
+	REQUIRE(m.size() == 21);
+	DSA::multimap<int, int> sorted {{1, 1}, {1, 2}, {2, 3}};
+	REQUIRE(sorted.count(1) == 2);
+	REQUIRE(sorted.begin()->second == 1);
+}
@@ -0,0 +1,142 @@
+#include "heap/heap.hpp"
+#include "heap/pairing_heap.hpp"
+#include "heap/leftist_heap.hpp"
+#include <vector>
+#include <string>
+#include <limits>
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+/*
+Same code for every priority queue type */
+template <typename Queue>
+static std::vector<int> drain(Queue& q) {
+	std::vector<int> out;
+	while (!q.empty()) {
+		out.push_back(q.top());
+		q.pop();
+	}
+	return out;
+}
+
+template <typename Queue>
+static void testQueue(std::size_t n) {
+	Queue q;
+	std::vector<int> v;
+	for (std::size_t i = 0; i < n; ++i) {
+		v.push_back(rand() % 1000);
+		q.push(v.back());
+	}
+	REQUIRE(q.size() == n);
+	std::sort(v.begin(), v.end(), std::greater<int>());
+	REQUIRE(drain(q) == v);
+	REQUIRE(q.size() == 0);
+}
+
+TEMPLATE_TEST_CASE("mergeable heap interface", "[mergeable_heap]",
+		DSA::Heap<int>, DSA::PairingHeap<int>, DSA::LeftistHeap<int>) {
+	for (std::size_t n : {0, 1, 2, 3, 10, 1000}) {
+		testQueue<TestType>(n);
+	}
+}
+
+TEMPLATE_TEST_CASE("mergeable heap merge", "[mergeable_heap]",
+		DSA::PairingHeap<int>, DSA::LeftistHeap<int>) {
+	std::vector<TestType> shards(8);
+	std::vector<int> all;
+	for (std::size_t i = 0; i < 4000; ++i) {
+		int x = rand() % 10000;
+		all.push_back(x);
+		shards[rand() % shards.size()].push(x);
+	}
+	TestType merged;
+	for (TestType& shard : shards) {
+		merged.merge(shard);
+		REQUIRE(shard.empty());
+		// the emptied shard can be used again
+		shard.push(1);
+		shard.pop();
+	}
+	merged.merge(TestType {});
+	REQUIRE(merged.size() == all.size());
+	std::sort(all.begin(), all.end(), std::greater<int>());
+	REQUIRE(drain(merged) == all);
+}
+
+TEMPLATE_TEST_CASE("mergeable heap strings", "[mergeable_heap]",
+		(DSA::PairingHeap<std::string, std::greater<std::string>>),
+		(DSA::LeftistHeap<std::string, std::greater<std::string>>)) {
+	TestType a;
+	TestType b;
+	for (const char* s : {"m", "c", "x"}) {
+		a.push(s);
+	}
+	for (const char* s : {"b", "z", "a"}) {
+		b.emplace(s);
+	}
+	a.merge(std::move(b));
+	REQUIRE(a.pop_value() == "a");
+	REQUIRE(a.pop_value() == "b");
+	TestType c {std::move(a)};
+	REQUIRE(c.size() == 4);
+	REQUIRE(c.top() == "c");
+	std::swap(a, c);
+	REQUIRE(a.size() == 4);
+	a.clear();
+	REQUIRE(a.empty());
+}
+
+TEST_CASE("pairing heap handles", "[mergeable_heap]") {
+	using Queue = DSA::PairingHeap<int, std::greater<int>>;
+	for (int round = 0; round < 20; ++round) {
+		Queue q;
+		std::vector<Queue::handle> handles;
+		std::vector<int> values;
+		for (int i = 0; i < 200; ++i) {
+			values.push_back(rand() % 1000);
+			handles.push_back(q.push(values.back()));
+		}
+		std::vector<bool> erased(values.size(), false);
+		for (int i = 0; i < 300; ++i) {
+			std::size_t j = rand() % values.size();
+			if (erased[j]) {
+				continue;
+			}
+			int v = rand() % 1000;
+			switch (rand() % 4) {
+				case 0:
+					q.erase(handles[j]);
+					erased[j] = true;
+					break;
+				case 1:
+					// towards the top of a min-heap: smaller
+					if (v <= values[j]) {
+						q.increaseKey(handles[j], v);
+						values[j] = v;
+					}
+					break;
+				case 2:
+					if (v >= values[j]) {
+						q.decreaseKey(handles[j], v);
+						values[j] = v;
+					}
+					break;
+				default:
+					q.update(handles[j], v);
+					values[j] = v;
+			}
+			if (!erased[j]) {
+				REQUIRE(*handles[j] == values[j]);
+			}
+		}
+		std::vector<int> expected;
+		for (std::size_t j = 0; j < values.size(); ++j) {
+			if (!erased[j]) {
+				expected.push_back(values[j]);
+			}
+		}
+		std::sort(expected.begin(), expected.end());
+		REQUIRE(q.size() == expected.size());
+		REQUIRE(drain(q) == expected);
+	}
+}
@@ -0,0 +1,85 @@
+#include "heap/minmax_heap.hpp"
+#include <set>
+#include <deque>
+#include <string>
+#include <vector>
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+TEST_CASE("minmax heap operations", "[minmax_heap]") {
+	for (int round = 0; round < 20; ++round) {
+		DSA::MinMaxHeap<int> h;
+		std::multiset<int> reference;
+		for (int i = 0; i < 500; ++i) {
+			switch (reference.empty() ? 0 : rand() % 4) {
+				case 0:
+				case 1: {
+					int x = rand() % 200;
+					h.push(x);
+					reference.insert(x);
+					break;
+				}
+				case 2:
+					REQUIRE(h.pop_min_value() == *reference.begin());
+					reference.erase(reference.begin());
+					break;
+				default:
+					REQUIRE(h.pop_max_value() == *reference.rbegin());
+					reference.erase(std::prev(reference.end()));
+			}
+			REQUIRE(h.size() == reference.size());
+			REQUIRE(h.valid());
+			if (!reference.empty()) {
+				REQUIRE(h.min() == *reference.begin());
+				REQUIRE(h.max() == *reference.rbegin());
+			}
+		}
+	}
+}
+
+TEST_CASE("minmax heap construction", "[minmax_heap]") {
+	for (std::size_t n = 0; n < 100; ++n) {
+		std::vector<int> v;
+		for (std::size_t i = 0; i < n; ++i) {
+			v.push_back(rand() % 50);
+		}
+		DSA::MinMaxHeap<int> h {v.begin(), v.end()};
+		REQUIRE(h.valid());
+		std::vector<int> sorted {v};
+		std::sort(sorted.begin(), sorted.end());
+		// alternate ends
+		std::size_t low = 0;
+		std::size_t high = sorted.size();
+		while (!h.empty()) {
+			if (h.size() % 2 == 0) {
+				h.pop_max();
+				REQUIRE((h.empty() || h.max() <= sorted[high - 1]));
+				--high;
+			} else {
+				REQUIRE(h.min() == sorted[low]);
+				h.pop_min();
+				++low;
+			}
+			REQUIRE(h.valid());
+		}
+	}
+}
+
+TEST_CASE("minmax heap adapter", "[minmax_heap]") {
+	using Heap = DSA::MinMaxHeap<std::string, std::deque<std::string>, std::greater<std::string>>;
+	std::allocator<std::string> alloc;
+	Heap h {std::greater<std::string>(), alloc};
+	for (const char* s : {"k", "b", "x", "m"}) {
+		h.emplace(s);
+	}
+	// the order is reversed by the comparison
+	REQUIRE(h.min() == "x");
+	REQUIRE(h.max() == "b");
+	Heap copy {h, alloc};
+	copy.pop_min();
+	REQUIRE(copy.min() == "m");
+	REQUIRE(h.size() == 4);
+	std::swap(h, copy);
+	REQUIRE(h.size() == 3);
+	REQUIRE(copy.min() == "x");
+}
@@ -0,0 +1,88 @@
+#include "heap/multi_queue.hpp"
+#include <vector>
+#include <thread>
+#include <algorithm>
+#include <catch2/catch.hpp>
+
+using IntQueue = DSA::MultiQueue<int>;
+
+TEST_CASE("multi queue strict", "[multi_queue]") {
+	IntQueue q {4, 2, IntQueue::Mode::Strict};
+	REQUIRE(q.queueCount() == 8);
+	std::vector<int> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(rand() % 500);
+		q.push(v.back());
+	}
+	REQUIRE(q.size() == 1000);
+	std::sort(v.begin(), v.end(), std::greater<int>());
+	for (int expected : v) {
+		int x;
+		REQUIRE(q.try_pop(x));
+		REQUIRE(x == expected);
+	}
+	int x;
+	REQUIRE(!q.try_pop(x));
+	REQUIRE(q.empty());
+}
+
+TEST_CASE("multi queue relaxed", "[multi_queue]") {
+	IntQueue q {4};
+	std::vector<int> v;
+	for (int i = 0; i < 1000; ++i) {
+		v.push_back(i);
+		q.push(i);
+	}
+	std::vector<int> popped;
+	int x;
+	while (q.try_pop(x)) {
+		popped.push_back(x);
+	}
+	// every element once, in roughly descending order
+	REQUIRE(popped.size() == v.size());
+	REQUIRE(popped.front() >= 900);
+	std::sort(popped.begin(), popped.end());
+	REQUIRE(popped == v);
+}
+
+static void testConcurrent(IntQueue::Mode mode) {
+	constexpr int THREADS = 4;
+	constexpr int PER_THREAD = 5000;
+	IntQueue q {THREADS, 2, mode};
+	std::vector<std::vector<int>> popped(THREADS);
+	std::vector<std::thread> threads;
+	for (int t = 0; t < THREADS; ++t) {
+		threads.emplace_back([&q, &popped, t]() {
+			for (int i = 0; i < PER_THREAD; ++i) {
+				q.push(t * PER_THREAD + i);
+				if (i % 2 == 1) {
+					int x;
+					if (q.try_pop(x)) {
+						popped[t].push_back(x);
+					}
+				}
+			}
+		});
+	}
+	for (std::thread& t : threads) {
+		t.join();
+	}
+	std::vector<int> all;
+	for (const std::vector<int>& p : popped) {
+		all.insert(all.end(), p.begin(), p.end());
+	}
+	int x;
+	while (q.try_pop(x)) {
+		all.push_back(x);
+	}
+	std::sort(all.begin(), all.end());
+	REQUIRE(all.size() == THREADS * PER_THREAD);
+	for (int i = 0; i < THREADS * PER_THREAD; ++i) {
+		REQUIRE(all[i] == i);
+	}
+}
+
+TEST_CASE("multi queue concurrent", "[multi_queue]") {
+	testConcurrent(IntQueue::Mode::Relaxed);
+	testConcurrent(IntQueue::Mode::Strict);
+}
@@ -0,0 +1,58 @@
+#include "pool/node_pool.hpp"
+#include <set>
+#include <string>
+#include <vector>
+#include <catch2/catch.hpp>
+
+TEST_CASE("node pool reuse", "[node_pool]") {
+	DSA::NodePool<std::string> pool;
+	std::vector<std::string*> nodes;
+	for (int i = 0; i < 1000; ++i) {
+		nodes.push_back(pool.create(std::to_string(i)));
+	}
+	REQUIRE(std::set<std::string*>(nodes.begin(), nodes.end()).size() == nodes.size());
+	REQUIRE(*nodes[500] == "500");
+	std::size_t capacity = pool.capacity();
+	REQUIRE(capacity >= 1000);
+	// freed nodes are handed out again before the pool grows
+	for (int i = 0; i < 1000; i += 2) {
+		pool.destroy(nodes[i]);
+	}
+	for (int i = 0; i < 1000; i += 2) {
+		nodes[i] = pool.create("again");
+	}
+	REQUIRE(pool.capacity() == capacity);
+	for (std::string* p : nodes) {
+		pool.destroy(p);
+	}
+	pool.release();
+	REQUIRE(pool.capacity() == 0);
+	REQUIRE(pool.chunkCount() == 0);
+}
+
+TEST_CASE("node pool splice", "[node_pool]") {
+	DSA::NodePool<int> a;
+	DSA::NodePool<int> b;
+	std::vector<int*> nodes;
+	for (int i = 0; i < 100; ++i) {
+		nodes.push_back(a.create(i));
+		nodes.push_back(b.create(i));
+	}
+	b.destroy(nodes.back());
+	nodes.pop_back();
+	std::size_t capacity = a.capacity() + b.capacity();
+	a.splice(b);
+	REQUIRE(b.capacity() == 0);
+	REQUIRE(a.capacity() == capacity);
+	// nodes of b are returned to a
+	for (int* p : nodes) {
+		a.destroy(p);
+	}
+	for (std::size_t i = 0; i < capacity; ++i) {
+		a.create(0);
+	}
+	REQUIRE(a.capacity() == capacity);
+	DSA::NodePool<int> c {std::move(a)};
+	REQUIRE(c.capacity() == capacity);
+	REQUIRE(a.capacity() == 0);
+}
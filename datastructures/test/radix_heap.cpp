@@ -0,0 +1,107 @@
+#include "heap/radix_heap.hpp"
+#include "heap/heap.hpp"
+#include <set>
+#include <limits>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <catch2/catch.hpp>
+
+template <typename Key>
+static void testMonotone(std::size_t operations, Key spread) {
+	DSA::RadixHeap<Key, std::size_t> h;
+	std::multiset<Key> reference;
+	Key last = 0;
+	for (std::size_t i = 0; i < operations; ++i) {
+		if (reference.empty() || rand() % 3 != 0) {
+			Key key = last + static_cast<Key>(rand() % 1000) * spread;
+			h.push(key, i);
+			reference.insert(key);
+		} else {
+			REQUIRE(h.top().first == *reference.begin());
+			last = h.top().first;
+			reference.erase(reference.begin());
+			h.pop();
+			REQUIRE(h.lastKey() == last);
+		}
+		REQUIRE(h.size() == reference.size());
+	}
+	while (!h.empty()) {
+		REQUIRE(h.pop_value().first == *reference.begin());
+		reference.erase(reference.begin());
+	}
+	REQUIRE(reference.empty());
+}
+
+TEST_CASE("radix heap monotone", "[radix_heap]") {
+	testMonotone<std::uint32_t>(5000, 1);
+	testMonotone<std::uint32_t>(5000, 100000);
+	testMonotone<std::uint64_t>(5000, 1);
+	testMonotone<std::uint64_t>(5000, std::uint64_t(1) << 40);
+}
+
+TEST_CASE("radix heap extremes", "[radix_heap]") {
+	DSA::RadixHeap<std::uint64_t, std::string> h;
+	const std::uint64_t max = std::numeric_limits<std::uint64_t>::max();
+	h.push(max, "max");
+	h.push(0, "zero");
+	h.emplace(max - 1, 3, 'x');
+	REQUIRE(h.top().second == "zero");
+	h.pop();
+	REQUIRE(h.top().second == "xxx");
+	h.pop();
+	REQUIRE(h.top().first == max);
+	h.push(max, "again");
+	h.pop();
+	h.pop();
+	REQUIRE(h.empty());
+	REQUIRE(h.lastKey() == max);
+	h.clear();
+	h.push(1, "one");
+	REQUIRE(h.top().first == 1);
+}
+
+TEST_CASE("radix heap dijkstra", "[radix_heap]") {
+	constexpr std::size_t N = 500;
+	using Edge = std::pair<std::size_t, std::uint32_t>;
+	std::vector<std::vector<Edge>> graph(N);
+	for (std::size_t i = 0; i < N * 6; ++i) {
+		graph[rand() % N].push_back(Edge(rand() % N, rand() % 1000));
+	}
+	constexpr std::uint32_t INF = std::numeric_limits<std::uint32_t>::max();
+	using Entry = std::pair<std::uint32_t, std::size_t>;
+
+	std::vector<std::uint32_t> expected(N, INF);
+	DSA::Heap<Entry, std::vector<Entry>, std::greater<Entry>> heap;
+	std::vector<std::uint32_t> distance(N, INF);
+	DSA::RadixHeap<std::uint32_t, std::size_t> radix;
+	expected[0] = 0;
+	distance[0] = 0;
+	heap.push(Entry(0, 0));
+	radix.push(0, 0);
+	while (!heap.empty()) {
+		Entry e = heap.pop_value();
+		if (e.first > expected[e.second]) {
+			continue;
+		}
+		for (const Edge& next : graph[e.second]) {
+			if (e.first + next.second < expected[next.first]) {
+				expected[next.first] = e.first + next.second;
+				heap.push(Entry(expected[next.first], next.first));
+			}
+		}
+	}
+	while (!radix.empty()) {
+		Entry e = radix.pop_value();
+		if (e.first > distance[e.second]) {
+			continue;
+		}
+		for (const Edge& next : graph[e.second]) {
+			if (e.first + next.second < distance[next.first]) {
+				distance[next.first] = e.first + next.second;
+				radix.push(distance[next.first], next.first);
+			}
+		}
+	}
+	REQUIRE(distance == expected);
+}
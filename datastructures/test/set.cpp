@@ -0,0 +1,71 @@
+#include "set/set.hpp"
+#include <string>
+#include <vector>
+#include <set>
+#include <iterator>
+#include <type_traits>
+#include <catch2/catch.hpp>
+
+TEST_CASE("set", "[set]") {
+	DSA::set<int> s;
+	static_assert(std::is_same<decltype(*s.begin()), const int&>::value, "set elements are immutable");
+	std::set<int> expected;
+	for (int i = 0; i < 1000; ++i) {
+		int v = (i * 7919) % 600;
+		REQUIRE(s.insert(v).second == expected.insert(v).second);
+	}
+	REQUIRE(s.size() == expected.size());
+	REQUIRE(std::equal(s.begin(), s.end(), expected.begin()));
+	REQUIRE(*s.lower_bound(599) == 599);
+	REQUIRE(s.upper_bound(599) == s.end());
+	REQUIRE(s.contains(300));
+	REQUIRE(s.erase(300) == 1);
+	REQUIRE(!s.contains(300));
+	DSA::set<int>::iterator first = s.find(100);
+	DSA::set<int>::iterator last = s.find(200);
+	REQUIRE(*s.erase(first, last) == 200);
+	REQUIRE(s.size() == expected.size() - 101);
+	REQUIRE(*s.emplace(150).first == 150);
+	REQUIRE(!s.emplace(150).second);
+}
+
+TEST_CASE("set hinted insertion", "[set]") {
+	DSA::set<std::string> s;
+	std::vector<std::string> words;
+	for (int i = 0; i < 1000; ++i) {
+		words.push_back(std::to_string(100000 + i));
+	}
+	for (const std::string& w : words) {
+		s.insert(s.end(), w);
+	}
+	REQUIRE(std::equal(words.begin(), words.end(), s.begin()));
+	DSA::set<std::string> t;
+	t.insert(words.begin(), words.end());
+	REQUIRE(s == t);
+	t.insert(t.end(), "0");
+	t.insert(t.begin(), "2");
+	REQUIRE(*t.begin() == "0");
+	REQUIRE(*--t.end() == "2");
+	REQUIRE(t.size() == 1002);
+	DSA::set<std::string> u {"b", "a", "c"};
+	REQUIRE(*u.begin() == "a");
+	REQUIRE(s < u);
+}
+
+TEST_CASE("multiset", "[set]") {
+	DSA::multiset<int, std::greater<int>> s {5, 5, 3, 1};
+	REQUIRE(s.size() == 4);
+	REQUIRE(*s.begin() == 5);
+	for (int i = 0; i < 100; ++i) {
+		s.insert(i % 10);
+	}
+	REQUIRE(s.count(5) == 12);
+	REQUIRE(s.count(3) == 11);
+	REQUIRE(std::distance(s.lower_bound(7), s.upper_bound(7)) == 10);
+	REQUIRE(s.erase(5) == 12);
+	REQUIRE(s.find(5) == s.end());
+	DSA::multiset<int, std::greater<int>>::iterator it = s.insert(s.end(), -1);
+	REQUIRE(it == --s.end());
+	REQUIRE(std::is_sorted(s.begin(), s.end(), std::greater<int>()));
+	REQUIRE(s.size() == 93);
+}
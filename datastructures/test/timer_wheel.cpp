@@ -0,0 +1,168 @@
+#include "timer/timer_wheel.hpp"
+#include <map>
+#include <vector>
+#include <string>
+#include <cstdint>
+#include <limits>
+#include <catch2/catch.hpp>
+
+using Wheel = DSA::TimerWheel<std::size_t>;
+
+static std::uint64_t randomDelay() {
+	switch (rand() % 4) {
+		case 0:
+			return rand() % 300;
+		case 1:
+			return rand() % 100000;
+		case 2:
+			return static_cast<std::uint64_t>(rand()) << (rand() % 12);
+		default:
+			return (static_cast<std::uint64_t>(rand()) << 20) + rand();
+	}
+}
+
+TEST_CASE("timer wheel matches reference", "[timer_wheel]") {
+	for (std::uint64_t start : {std::uint64_t(0), std::uint64_t(1000), (std::uint64_t(1) << 32) - 5}) {
+		Wheel wheel {start};
+		std::map<std::size_t, std::uint64_t> pending;
+		std::vector<Wheel::handle> handles;
+		std::size_t expired_count = 0;
+		auto check = [&](std::uint64_t tick, std::vector<std::size_t>& batch) {
+			REQUIRE(!batch.empty());
+			for (std::size_t id : batch) {
+				REQUIRE(pending.count(id) == 1);
+				REQUIRE(pending[id] == tick);
+				pending.erase(id);
+			}
+			expired_count += batch.size();
+		};
+		for (int i = 0; i < 3000; ++i) {
+			switch (rand() % 5) {
+				case 0:
+				case 1: {
+					std::uint64_t deadline = wheel.now() + randomDelay();
+					std::size_t id = handles.size();
+					handles.push_back(wheel.schedule(deadline, id));
+					pending[id] = deadline <= wheel.now() ? wheel.now() + 1 : deadline;
+					break;
+				}
+				case 2: {
+					if (handles.empty()) {
+						break;
+					}
+					std::size_t id = rand() % handles.size();
+					REQUIRE(wheel.cancel(handles[id]) == (pending.count(id) == 1));
+					pending.erase(id);
+					break;
+				}
+				default: {
+					std::uint64_t to = wheel.now() + randomDelay();
+					wheel.advance(to, check);
+					REQUIRE(wheel.now() == to);
+					for (const auto& p : pending) {
+						REQUIRE(p.second > to);
+					}
+				}
+			}
+			REQUIRE(wheel.size() == pending.size());
+		}
+		wheel.advance(std::numeric_limits<std::uint64_t>::max() - 1, check);
+		REQUIRE(pending.empty());
+		REQUIRE(wheel.empty());
+		REQUIRE(expired_count > 0);
+	}
+}
+
+TEST_CASE("timer wheel batches", "[timer_wheel]") {
+	DSA::TimerWheel<std::string> wheel;
+	DSA::TimerHandle a = wheel.schedule(10, "a");
+	wheel.schedule(10, "b");
+	wheel.schedule(0, "now");
+	DSA::TimerHandle far = wheel.schedule(std::uint64_t(1) << 40, "far");
+	std::vector<std::pair<std::uint64_t, std::size_t>> batches;
+	auto record = [&](std::uint64_t tick, std::vector<std::string>& timers) {
+		batches.emplace_back(tick, timers.size());
+		// timers scheduled from the callback fire later
+		if (tick == 1) {
+			wheel.schedule(tick, "again");
+		}
+	};
+	REQUIRE(wheel.advance(5, record) == 2);
+	REQUIRE(batches.size() == 2);
+	REQUIRE(batches[0] == std::make_pair(std::uint64_t(1), std::size_t(1)));
+	REQUIRE(batches[1] == std::make_pair(std::uint64_t(2), std::size_t(1)));
+	REQUIRE(wheel.cancel(a));
+	REQUIRE(!wheel.cancel(a));
+	REQUIRE(wheel.advance(1000, record) == 1);
+	REQUIRE(batches.back() == std::make_pair(std::uint64_t(10), std::size_t(1)));
+	REQUIRE(wheel.nextEvent() <= std::uint64_t(1) << 40);
+	REQUIRE(wheel.cancel(far));
+	REQUIRE(wheel.empty());
+	REQUIRE(wheel.advance(std::uint64_t(1) << 41, record) == 0);
+	REQUIRE(!wheel.active(far));
+}
+
+namespace {
+
+// no default constructor and no assignment, counts live instances
+struct Payload {
+	explicit Payload(int id)
+	: id(id) {
+		++live;
+	}
+
+	Payload(const Payload& other)
+	: id(other.id) {
+		++live;
+	}
+
+	Payload(Payload&& other) noexcept
+	: id(other.id) {
+		++live;
+	}
+
+	Payload& operator=(const Payload& rhs) = delete;
+
+	~Payload() {
+		--live;
+	}
+
+	int id;
+	static int live;
+};
+
+int Payload::live = 0;
+
+}
+
+TEST_CASE("timer wheel payload lifetime", "[timer_wheel]") {
+	{
+		DSA::TimerWheel<Payload> wheel;
+		std::vector<DSA::TimerHandle> handles;
+		for (int i = 0; i < 1000; ++i) {
+			handles.push_back(wheel.emplace(static_cast<std::uint64_t>(i % 50 + 1), i));
+		}
+		REQUIRE(Payload::live == 1000);
+		for (int i = 0; i < 1000; i += 2) {
+			REQUIRE(wheel.cancel(handles[i]));
+		}
+		REQUIRE(Payload::live == 500);
+		// cancelled slots are constructed into again
+		for (int i = 0; i < 100; ++i) {
+			wheel.emplace(std::uint64_t(1) << 36, -i);
+		}
+		REQUIRE(Payload::live == 600);
+		DSA::TimerWheel<Payload> copy {wheel};
+		REQUIRE(Payload::live == 1200);
+		std::size_t odd = 0;
+		wheel.advance(100, [&](std::uint64_t, std::vector<Payload>& timers) {
+			for (const Payload& p : timers) {
+				odd += p.id % 2;
+			}
+		});
+		REQUIRE(odd == 500);
+		REQUIRE(wheel.size() == 100);
+		REQUIRE(copy.size() == 600);
+	}
+	REQUIRE(Payload::live == 0);
+}
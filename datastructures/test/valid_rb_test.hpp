@@ -28,44 +28,50 @@ int blackHeight(const Node* root) {
 	return blackHeightLeft;
 }
 
-template <typename Node>
-int testNode(const Node* x) {
+/*
+inOrder(a, b): a may come before b, strictly unless the tree allows equal keys */
+template <typename Node, typename Order>
+int testNode(const Node* x, const Order& inOrder) {
 	if (x == NULL || (x->left && x->left->right == x)) {
 		return 0;
 	}
 
 	if (x->right) {
-		assert(x->right->parent == x);
-		assert(x->right->getValue() > x->getValue());
+		assert(x->right->getParent() == x);
+		assert(inOrder(x->getValue(), x->right->getValue()));
 	}
 
 	if (x->left) {
-		assert(x->left->parent == x);
-		assert(x->left->getValue() < x->getValue());
+		assert(x->left->getParent() == x);
+		assert(inOrder(x->left->getValue(), x->getValue()));
 	}
 
 	if (x->getColor() == Node::RED) {
-		assert(x->parent->getColor() == Node::BLACK);
+		assert(x->getParent()->getColor() == Node::BLACK);
 	}
 
-	assert(testNode(x->left) == testNode(x->right));
+	assert(testNode(x->left, inOrder) == testNode(x->right, inOrder));
 	return blackHeight(x);
 }
 
-template <typename Node>
-bool testRedBlackInvariant(const Node* root) {
+template <typename Node, typename Order>
+bool testRedBlackInvariant(const Node* root, const Order& inOrder) {
 	if (root == NULL) {
 		return true;
 	}
 
 	assert(root->getColor() == Node::BLACK);
-	testNode(root);
+	testNode(root, inOrder);
 	return true;
 }
 
-template <typename T>
-bool validRB(const RedBlackTree<T>& m) {
-	return testRedBlackInvariant(m.base());
+template <typename T, typename Compare, typename Alloc, typename KeyOfValue, bool Multi>
+bool validRB(const RedBlackTree<T, Compare, Alloc, KeyOfValue, Multi>& m) {
+	const Compare less = m.key_comp();
+	const KeyOfValue key = KeyOfValue();
+	return testRedBlackInvariant(m.base(), [&](const T& a, const T& b) {
+		return Multi ? !less(key(b), key(a)) : less(key(a), key(b));
+	});
 }
 
 }